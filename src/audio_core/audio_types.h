@@ -4,9 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
-#include <deque>
+#include "common/assert.h"
 #include "common/common_types.h"
 
 namespace AudioCore {
@@ -20,11 +21,72 @@ constexpr int samples_per_frame = 160;
 /// The final output to the speakers is stereo. Preprocessing output in Source is also stereo.
 using StereoFrame16 = std::array<std::array<s16, 2>, samples_per_frame>;
 
-/// The DSP is quadraphonic internally.
-using QuadFrame32 = std::array<std::array<s32, 4>, samples_per_frame>;
+/// The DSP is quadraphonic internally. The frame is planar, indexed by channel then by sample, like
+/// the intermediate mixes in the DSP shared memory.
+using QuadFrame32 = std::array<std::array<s32, samples_per_frame>, 4>;
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/**
+ * A fixed capacity ring buffer of signed PCM16 stereo samples. Samples are decoded in place at the
+ * back of the buffer and consumed from the front.
+ */
+class StereoBuffer16 {
+public:
+    using Sample = std::array<s16, 2>;
+
+    static constexpr std::size_t CAPACITY = 0x400;
+
+    std::size_t Size() const {
+        return size;
+    }
+
+    bool Empty() const {
+        return size == 0;
+    }
+
+    std::size_t FreeSpace() const {
+        return CAPACITY - size;
+    }
+
+    /// Accesses the sample at the given position from the front of the buffer.
+    const Sample& operator[](std::size_t index) const {
+        return samples[(head + index) % CAPACITY];
+    }
+
+    /// Removes samples from the front of the buffer.
+    void Pop(std::size_t count) {
+        ASSERT(count <= size);
+        head = (head + count) % CAPACITY;
+        size -= count;
+    }
+
+    void Clear() {
+        head = 0;
+        size = 0;
+    }
+
+    /**
+     * Appends samples to the back of the buffer, producing them in place.
+     * @param count Number of samples to append, at most FreeSpace()
+     * @param produce Called as produce(Sample* output, std::size_t offset, std::size_t length)
+     * once for each contiguous part of the appended samples, where offset is the position of the
+     * part within the appended samples
+     */
+    template <typename Function>
+    void Append(std::size_t count, Function&& produce) {
+        ASSERT(count <= FreeSpace());
+        const std::size_t tail = (head + size) % CAPACITY;
+        const std::size_t first_length = std::min(count, CAPACITY - tail);
+        produce(&samples[tail], 0, first_length);
+        if (count > first_length)
+            produce(&samples[0], first_length, count - first_length);
+        size += count;
+    }
+
+private:
+    std::array<Sample, CAPACITY> samples;
+    std::size_t head = 0;
+    std::size_t size = 0;
+};
 
 constexpr std::size_t num_dsp_pipe = 8;
 enum class DspPipe {
@@ -6,6 +6,9 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/audio_types.h"
 #include "audio_core/codec.h"
 #include "common/assert.h"
@@ -14,114 +17,183 @@
 namespace AudioCore {
 namespace Codec {
 
-StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
-                           const std::array<s16, 16>& adpcm_coeff, ADPCMState& state) {
-    // GC-ADPCM with scale factor and variable coefficients.
-    // Frames are 8 bytes long containing 14 samples each.
-    // Samples are 4 bits (one nibble) long.
+// GC-ADPCM with scale factor and variable coefficients.
+// Frames are 8 bytes long containing 14 samples each.
+// Samples are 4 bits (one nibble) long.
+constexpr std::size_t ADPCM_FRAME_LEN = 8;
+constexpr std::size_t ADPCM_SAMPLES_PER_FRAME = 14;
+
+/**
+ * Computes the filter input of the samples of an ADPCM frame, that is x[n] + 0.5 in 11 bit fixed
+ * point. All the nibbles are unpacked at once, leaving only the filter itself to run sample by
+ * sample.
+ * @param frame Pointer to the ADPCM frame
+ * @param sample_end Number of samples of the frame to unpack. The frame is only read up to the
+ * byte containing the last of them.
+ * @param inputs Receives the filter inputs
+ */
+static void UnpackADPCMFrame(const u8* frame, std::size_t sample_end,
+                             std::array<s32, 16>& inputs) {
+    const int scale_shift = frame[0] & 0xF;
+
+#ifdef ARCHITECTURE_x86_64
+    if (sample_end == ADPCM_SAMPLES_PER_FRAME) {
+        // Nibbles of the 7 data bytes, interleaved high nibble first
+        const __m128i frame_bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(frame));
+        const __m128i bytes = _mm_srli_si128(frame_bytes, 1);
+        const __m128i low_mask = _mm_set1_epi8(0xF);
+        const __m128i high_nibbles = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+        const __m128i low_nibbles = _mm_and_si128(bytes, low_mask);
+        __m128i nibbles = _mm_unpacklo_epi8(high_nibbles, low_nibbles);
+
+        // Sign extends the nibbles to 8 bits, then to 32 bits
+        const __m128i sign_bit = _mm_set1_epi8(8);
+        nibbles = _mm_sub_epi8(_mm_xor_si128(nibbles, sign_bit), sign_bit);
+        const __m128i words_low = _mm_srai_epi16(_mm_unpacklo_epi8(nibbles, nibbles), 8);
+        const __m128i words_high = _mm_srai_epi16(_mm_unpackhi_epi8(nibbles, nibbles), 8);
+        const __m128i dwords[4]{
+            _mm_srai_epi32(_mm_unpacklo_epi16(words_low, words_low), 16),
+            _mm_srai_epi32(_mm_unpackhi_epi16(words_low, words_low), 16),
+            _mm_srai_epi32(_mm_unpacklo_epi16(words_high, words_high), 16),
+            _mm_srai_epi32(_mm_unpackhi_epi16(words_high, words_high), 16),
+        };
+
+        // The scale is a power of two, (nibble * scale) << 11 is a single shift
+        const __m128i shift = _mm_cvtsi32_si128(scale_shift + 11);
+        const __m128i half = _mm_set1_epi32(0x400);
+        for (std::size_t i = 0; i < 4; i++) {
+            const __m128i input = _mm_add_epi32(_mm_sll_epi32(dwords[i], shift), half);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&inputs[i * 4]), input);
+        }
+        return;
+    }
+#endif
 
-    constexpr std::size_t FRAME_LEN = 8;
-    constexpr std::size_t SAMPLES_PER_FRAME = 14;
     constexpr std::array<int, 16> SIGNED_NIBBLES = {
         {0, 1, 2, 3, 4, 5, 6, 7, -8, -7, -6, -5, -4, -3, -2, -1}};
 
-    const std::size_t ret_size =
-        sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
-    StereoBuffer16 ret(ret_size);
+    const int scale = 1 << scale_shift;
+    for (std::size_t i = 0; i < sample_end; i++) {
+        const u8 byte = frame[1 + i / 2];
+        const int nibble = SIGNED_NIBBLES[i % 2 == 0 ? byte >> 4 : byte & 0xF];
+        inputs[i] = ((nibble * scale) << 11) + 0x400;
+    }
+}
 
+void DecodeADPCM(const u8* const data, const std::size_t first_sample,
+                 const std::size_t sample_count, const std::array<s16, 16>& adpcm_coeff,
+                 ADPCMState& state, StereoBuffer16::Sample* output) {
     int yn1 = state.yn1, yn2 = state.yn2;
 
-    const std::size_t NUM_FRAMES =
-        (sample_count + (SAMPLES_PER_FRAME - 1)) / SAMPLES_PER_FRAME; // Round up.
-    for (std::size_t framei = 0; framei < NUM_FRAMES; framei++) {
-        const int frame_header = data[framei * FRAME_LEN];
-        const int scale = 1 << (frame_header & 0xF);
-        const int idx = (frame_header >> 4) & 0x7;
+    const std::size_t end_sample = first_sample + sample_count;
+    std::size_t samplei = first_sample;
+    std::size_t outputi = 0;
+    while (samplei < end_sample) {
+        const std::size_t framei = samplei / ADPCM_SAMPLES_PER_FRAME;
+        const u8* const frame = data + framei * ADPCM_FRAME_LEN;
+        const int idx = (frame[0] >> 4) & 0x7;
 
         // Coefficients are fixed point with 11 bits fractional part.
         const int coef1 = adpcm_coeff[idx * 2 + 0];
         const int coef2 = adpcm_coeff[idx * 2 + 1];
 
-        // Decodes an audio sample. One nibble produces one sample.
-        const auto decode_sample = [&](const int nibble) -> s16 {
-            const int xn = nibble * scale;
+        // The decoding may start and end in the middle of a frame
+        const std::size_t frame_begin = samplei % ADPCM_SAMPLES_PER_FRAME;
+        const std::size_t frame_end =
+            std::min(ADPCM_SAMPLES_PER_FRAME, frame_begin + (end_sample - samplei));
+
+        std::array<s32, 16> inputs;
+        UnpackADPCMFrame(frame, frame_end, inputs);
+
+        for (std::size_t i = frame_begin; i < frame_end; i++) {
             // We first transform everything into 11 bit fixed point, perform the second order
             // digital filter, then transform back.
             // 0x400 == 0.5 in 11 bit fixed point.
             // Filter: y[n] = x[n] + 0.5 + c1 * y[n-1] + c2 * y[n-2]
-            int val = ((xn << 11) + 0x400 + coef1 * yn1 + coef2 * yn2) >> 11;
+            int val = (inputs[i] + coef1 * yn1 + coef2 * yn2) >> 11;
             // Clamp to output range.
             val = std::clamp(val, -32768, 32767);
             // Advance output feedback.
             yn2 = yn1;
             yn1 = val;
-            return (s16)val;
-        };
-
-        std::size_t outputi = framei * SAMPLES_PER_FRAME;
-        std::size_t datai = framei * FRAME_LEN + 1;
-        for (std::size_t i = 0; i < SAMPLES_PER_FRAME && outputi < sample_count; i += 2) {
-            const s16 sample1 = decode_sample(SIGNED_NIBBLES[data[datai] >> 4]);
-            ret[outputi].fill(sample1);
-            outputi++;
-
-            const s16 sample2 = decode_sample(SIGNED_NIBBLES[data[datai] & 0xF]);
-            ret[outputi].fill(sample2);
-            outputi++;
-
-            datai++;
+            output[outputi++].fill(static_cast<s16>(val));
         }
+        samplei += frame_end - frame_begin;
     }
 
     state.yn1 = yn1;
     state.yn2 = yn2;
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
-                          const std::size_t sample_count) {
+void DecodePCM8(const unsigned num_channels, const u8* const data, const std::size_t first_sample,
+                const std::size_t sample_count, StereoBuffer16::Sample* output) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
     const auto decode_sample = [](u8 sample) {
         return static_cast<s16>(static_cast<u16>(sample) << 8);
     };
 
-    StereoBuffer16 ret(sample_count);
-
+    const u8* const input = data + first_sample * num_channels;
+    std::size_t i = 0;
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i].fill(decode_sample(data[i]));
+#ifdef ARCHITECTURE_x86_64
+        // Widens 16 samples at a time, duplicating them to both channels
+        for (; i + 16 <= sample_count; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            const __m128i words_low = _mm_unpacklo_epi8(_mm_setzero_si128(), bytes);
+            const __m128i words_high = _mm_unpackhi_epi8(_mm_setzero_si128(), bytes);
+            __m128i* const out = reinterpret_cast<__m128i*>(output + i);
+            _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(words_low, words_low));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(words_low, words_low));
+            _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(words_high, words_high));
+            _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(words_high, words_high));
+        }
+#endif
+        for (; i < sample_count; i++) {
+            output[i].fill(decode_sample(input[i]));
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i][0] = decode_sample(data[i * 2 + 0]);
-            ret[i][1] = decode_sample(data[i * 2 + 1]);
+#ifdef ARCHITECTURE_x86_64
+        // Widens 8 stereo samples at a time
+        for (; i + 8 <= sample_count; i += 8) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * 2));
+            __m128i* const out = reinterpret_cast<__m128i*>(output + i);
+            _mm_storeu_si128(out + 0, _mm_unpacklo_epi8(_mm_setzero_si128(), bytes));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi8(_mm_setzero_si128(), bytes));
+        }
+#endif
+        for (; i < sample_count; i++) {
+            output[i][0] = decode_sample(input[i * 2 + 0]);
+            output[i][1] = decode_sample(input[i * 2 + 1]);
         }
     }
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
-                           const std::size_t sample_count) {
+void DecodePCM16(const unsigned num_channels, const u8* const data, const std::size_t first_sample,
+                 const std::size_t sample_count, StereoBuffer16::Sample* output) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
-    StereoBuffer16 ret(sample_count);
-
+    const u8* const input = data + first_sample * num_channels * sizeof(s16);
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
+        std::size_t i = 0;
+#ifdef ARCHITECTURE_x86_64
+        // Duplicates 8 samples at a time to both channels
+        for (; i + 8 <= sample_count; i += 8) {
+            const __m128i samples =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i * sizeof(s16)));
+            __m128i* const out = reinterpret_cast<__m128i*>(output + i);
+            _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(samples, samples));
+            _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(samples, samples));
+        }
+#endif
+        for (; i < sample_count; i++) {
             s16 sample;
-            std::memcpy(&sample, data + i * sizeof(s16), sizeof(s16));
-            ret[i].fill(sample);
+            std::memcpy(&sample, input + i * sizeof(s16), sizeof(s16));
+            output[i].fill(sample);
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; ++i) {
-            std::memcpy(&ret[i], data + i * sizeof(s16) * 2, 2 * sizeof(s16));
-        }
+        std::memcpy(output, input, sample_count * 2 * sizeof(s16));
     }
-
-    return ret;
 }
 } // namespace Codec
 } // namespace AudioCore
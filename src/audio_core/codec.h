@@ -20,31 +20,38 @@ struct ADPCMState {
 };
 
 /**
+ * Decodes part of a buffer of ADPCM data. A buffer may be decoded in several consecutive parts.
  * @param data Pointer to buffer that contains ADPCM data to decode
- * @param sample_count Length of buffer in terms of number of samples
+ * @param first_sample Index of the first sample to decode in the buffer
+ * @param sample_count Number of samples to decode
  * @param adpcm_coeff ADPCM coefficients
- * @param state ADPCM state, this is updated with new state
- * @return Decoded stereo signed PCM16 data, sample_count in length
+ * @param state ADPCM state after the previous sample, this is updated with new state
+ * @param output Receives the decoded stereo signed PCM16 data, sample_count in length
  */
-StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
-                           const std::array<s16, 16>& adpcm_coeff, ADPCMState& state);
+void DecodeADPCM(const u8* const data, const std::size_t first_sample,
+                 const std::size_t sample_count, const std::array<s16, 16>& adpcm_coeff,
+                 ADPCMState& state, StereoBuffer16::Sample* output);
 
 /**
+ * Decodes part of a buffer of PCM8 data.
  * @param num_channels Number of channels
  * @param data Pointer to buffer that contains PCM8 data to decode
- * @param sample_count Length of buffer in terms of number of samples
- * @return Decoded stereo signed PCM16 data, sample_count in length
+ * @param first_sample Index of the first sample to decode in the buffer
+ * @param sample_count Number of samples to decode
+ * @param output Receives the decoded stereo signed PCM16 data, sample_count in length
  */
-StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
-                          const std::size_t sample_count);
+void DecodePCM8(const unsigned num_channels, const u8* const data, const std::size_t first_sample,
+                const std::size_t sample_count, StereoBuffer16::Sample* output);
 
 /**
+ * Decodes part of a buffer of PCM16 data.
  * @param num_channels Number of channels
  * @param data Pointer to buffer that contains PCM16 data to decode
- * @param sample_count Length of buffer in terms of number of samples
- * @return Decoded stereo signed PCM16 data, sample_count in length
+ * @param first_sample Index of the first sample to decode in the buffer
+ * @param sample_count Number of samples to decode
+ * @param output Receives the decoded stereo signed PCM16 data, sample_count in length
  */
-StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
-                           const std::size_t sample_count);
+void DecodePCM16(const unsigned num_channels, const u8* const data, const std::size_t first_sample,
+                 const std::size_t sample_count, StereoBuffer16::Sample* output);
 } // namespace Codec
 } // namespace AudioCore
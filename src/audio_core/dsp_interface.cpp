@@ -2,7 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/dsp_interface.h"
 #include "audio_core/sink.h"
 #include "audio_core/sink_details.h"
@@ -11,15 +16,26 @@
 
 namespace AudioCore {
 
-DspInterface::DspInterface() = default;
+DspInterface::DspInterface() {
+    time_stretcher.Prime(FIFO_CAPACITY);
+}
+
 DspInterface::~DspInterface() = default;
 
 void DspInterface::SetSink(const std::string& sink_id, const std::string& audio_device) {
     const SinkDetails& sink_details = GetSinkDetails(sink_id);
-    sink = sink_details.factory(audio_device);
+    SetSink(sink_details.factory(audio_device));
+}
+
+void DspInterface::SetSink(std::unique_ptr<Sink> sink_) {
+    sink = std::move(sink_);
+    // The windows of the stretcher depend on the sample rate, prime them again before the sink
+    // calls back
+    time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
+    time_stretcher.Prime(FIFO_CAPACITY);
+    latency_controller.SetSampleRate(sink->GetNativeSampleRate());
     sink->SetCallback(
         [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
-    time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
 }
 
 Sink& DspInterface::GetSink() {
@@ -41,15 +57,55 @@ void DspInterface::OutputFrame(StereoFrame16& frame) {
     if (!sink)
         return;
 
+    if (!sink->IsRealTime()) {
+        sink->PushSamples(&frame[0][0], frame.size());
+        return;
+    }
+
     fifo.Push(frame.data(), frame.size());
 }
 
+DspInterface::OutputStats DspInterface::GetAndResetOutputStats() {
+    OutputStats stats;
+    stats.latency = static_cast<double>(stats_buffered_frames) / native_sample_rate;
+    stats.target_latency = static_cast<double>(stats_target_frames) / native_sample_rate;
+    stats.underruns = stats_underruns.exchange(0);
+    stats.stretch_ratio = stats_stretch_ratio;
+    return stats;
+}
+
+std::size_t DspInterface::UpdateLatency(std::size_t num_frames) {
+    latency_controller.OnCallback(LatencyController::Clock::now(), num_frames);
+
+    const bool low_latency = Settings::values.enable_low_latency_audio;
+    const double configured_latency = Settings::values.audio_latency / 1000.0;
+    const double target_latency =
+        latency_controller.GetTargetLatency(configured_latency, low_latency);
+    const auto target_frames = static_cast<std::size_t>(target_latency * native_sample_rate);
+
+    if (perform_time_stretching) {
+        // The stretcher takes the whole fifo at once and keeps its backlog at the target itself
+        time_stretcher.SetTargetLatency(target_latency);
+        return target_frames;
+    }
+
+    // The low latency mode keeps a smaller working buffer, at the cost of dropping samples more
+    // often when the emulation runs faster than the sink
+    const std::size_t max_frames = low_latency ? target_frames * 3 / 2 : target_frames * 2;
+    const std::size_t buffered_frames = fifo.Size();
+    if (buffered_frames > std::max(max_frames, num_frames)) {
+        fifo.Pop(stretch_input.data(), buffered_frames - std::max(target_frames, num_frames));
+    }
+    return target_frames;
+}
+
 void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
+    const std::size_t target_frames = UpdateLatency(num_frames);
+
     std::size_t frames_written;
     if (perform_time_stretching) {
-        const std::vector<s16> in{fifo.Pop()};
-        const std::size_t num_in{in.size() / 2};
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
+        const std::size_t num_in = fifo.Pop(stretch_input.data(), FIFO_CAPACITY);
+        frames_written = time_stretcher.Process(stretch_input.data(), num_in, buffer, num_frames);
     } else if (flushing_time_stretcher) {
         time_stretcher.Flush();
         frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
@@ -68,14 +124,52 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
         std::memcpy(buffer + 2 * i, &last_frame[0], 2 * sizeof(s16));
     }
 
-    // Implementation of the hardware volume slider with a dynamic range of 60 dB
+    if (frames_written < num_frames && playing) {
+        latency_controller.OnUnderrun();
+        ++stats_underruns;
+    }
+    playing = frames_written > 0;
+
+    std::size_t buffered_frames = fifo.Size();
+    if (perform_time_stretching) {
+        buffered_frames += time_stretcher.GetBacklog();
+    }
+    stats_buffered_frames = buffered_frames;
+    stats_target_frames = target_frames;
+    stats_stretch_ratio =
+        perform_time_stretching ? static_cast<float>(time_stretcher.GetStretchRatio()) : 1.0f;
+
+    ApplyVolume(buffer, num_frames);
+}
+
+void DspInterface::ApplyVolume(s16* buffer, std::size_t num_frames) {
     const float linear_volume = std::clamp(Settings::values.volume, 0.0f, 1.0f);
-    if (linear_volume != 1.0) {
+    if (linear_volume == 1.0f)
+        return;
+
+    if (linear_volume != current_volume) {
+        // Implementation of the hardware volume slider with a dynamic range of 60 dB
         const float volume_scale_factor = std::exp(6.90775f * linear_volume) * 0.001f;
-        for (std::size_t i = 0; i < num_frames; i++) {
-            buffer[i * 2 + 0] = static_cast<s16>(buffer[i * 2 + 0] * volume_scale_factor);
-            buffer[i * 2 + 1] = static_cast<s16>(buffer[i * 2 + 1] * volume_scale_factor);
-        }
+        volume_gain = static_cast<s16>(std::min(volume_scale_factor * 0x8000, 32767.0f));
+        current_volume = linear_volume;
+    }
+
+    // Computes (sample * gain) >> 15 for each sample, the gain is below 1.0 so this never
+    // overflows
+    const std::size_t num_samples = num_frames * 2;
+    std::size_t i = 0;
+#ifdef ARCHITECTURE_x86_64
+    const __m128i gain = _mm_set1_epi16(volume_gain);
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + i));
+        // Bits 15 to 30 of the 32-bit products
+        const __m128i low = _mm_srli_epi16(_mm_mullo_epi16(in, gain), 15);
+        const __m128i high = _mm_slli_epi16(_mm_mulhi_epi16(in, gain), 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer + i), _mm_or_si128(high, low));
+    }
+#endif
+    for (; i < num_samples; i++) {
+        buffer[i] = static_cast<s16>((buffer[i] * volume_gain) >> 15);
     }
 }
 
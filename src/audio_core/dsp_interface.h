@@ -4,9 +4,11 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "audio_core/audio_types.h"
+#include "audio_core/latency_controller.h"
 #include "audio_core/time_stretch.h"
 #include "common/common_types.h"
 #include "common/ring_buffer.h"
@@ -36,18 +38,19 @@ public:
     virtual DspState GetDspState() const = 0;
 
     /**
-     * Reads `length` bytes from the DSP pipe identified with `pipe_number`.
+     * Reads `length` bytes from the DSP pipe identified with `pipe_number`, directly into the
+     * buffer of the caller.
      * @note Can read up to the maximum value of a u16 in bytes (65,535).
-     * @note IF an error is encoutered with either an invalid `pipe_number` or `length` value, an
-     * empty vector will be returned.
-     * @note IF `length` is set to 0, an empty vector will be returned.
+     * @note IF an error is encoutered with either an invalid `pipe_number` or `length` value,
+     * nothing is read.
      * @note IF `length` is greater than the amount of data available, this function will only read
      * the available amount.
      * @param pipe_number a `DspPipe`
+     * @param buffer Receives the bytes read, must be at least `length` bytes long.
      * @param length the number of bytes to read. The max is 65,535 (max of u16).
-     * @returns a vector of bytes from the specified pipe. On error, will be empty.
+     * @returns the number of bytes read from the specified pipe. On error, will be zero.
      */
-    virtual std::vector<u8> PipeRead(DspPipe pipe_number, u32 length) = 0;
+    virtual std::size_t PipeRead(DspPipe pipe_number, u8* buffer, std::size_t length) = 0;
 
     /**
      * How much data is left in pipe
@@ -61,8 +64,9 @@ public:
      * Write to a DSP pipe.
      * @param pipe_number The Pipe ID
      * @param buffer The data to write to the pipe.
+     * @param length The length of the data in bytes.
      */
-    virtual void PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer) = 0;
+    virtual void PipeWrite(DspPipe pipe_number, const u8* buffer, std::size_t length) = 0;
 
     /// Returns a reference to the array backing DSP memory
     virtual std::array<u8, Memory::DSP_RAM_SIZE>& GetDspMemory() = 0;
@@ -72,24 +76,77 @@ public:
 
     /// Select the sink to use based on sink id.
     void SetSink(const std::string& sink_id, const std::string& audio_device);
+    /// Use the given sink.
+    void SetSink(std::unique_ptr<Sink> sink);
     /// Get the current sink
     Sink& GetSink();
     /// Enable/Disable audio stretching.
     void EnableStretching(bool enable);
 
+    struct OutputStats {
+        /// Duration of the audio buffered for the sink, in seconds
+        double latency;
+        /// Latency targeted by the latency controller, in seconds
+        double target_latency;
+        /// Number of times the sink ran out of samples since the last reset
+        u32 underruns;
+        /// Tempo of the time stretcher, 1.0 when it is disabled
+        double stretch_ratio;
+    };
+
+    /// Returns statistics about the audio output, as of the last callback of the sink, and resets
+    /// the underrun count.
+    OutputStats GetAndResetOutputStats();
+
 protected:
     void OutputFrame(StereoFrame16& frame);
 
 private:
+    /// Number of stereo frames buffered between the emulation and the audio thread
+    static constexpr std::size_t FIFO_CAPACITY = 0x2000;
+
     void FlushResidualStretcherAudio();
+
+    /**
+     * Fills the buffer of the sink, runs on the real-time audio thread of the sink. It must not
+     * allocate memory nor take locks, all its buffers are allocated beforehand.
+     */
     void OutputCallback(s16* buffer, std::size_t num_frames);
 
+    /// Applies the volume setting to the output. Only called from the audio thread.
+    void ApplyVolume(s16* buffer, std::size_t num_frames);
+
+    /**
+     * Updates the target latency from the latency settings, and drops the oldest samples of the
+     * fifo once it holds too much more than the target. Only called from the audio thread.
+     * @returns The target latency in frames at the native sample rate
+     */
+    std::size_t UpdateLatency(std::size_t num_frames);
+
     std::unique_ptr<Sink> sink;
     std::atomic<bool> perform_time_stretching = false;
     std::atomic<bool> flushing_time_stretcher = false;
-    Common::RingBuffer<s16, 0x2000, 2> fifo;
+    Common::RingBuffer<s16, FIFO_CAPACITY, 2> fifo;
     std::array<s16, 2> last_frame{};
     TimeStretcher time_stretcher;
+
+    /// Input of the time stretcher, holds the whole contents of the fifo
+    std::array<s16, FIFO_CAPACITY * 2> stretch_input{};
+
+    LatencyController latency_controller;
+    /// Whether the sink received samples in the previous callback, used to count underruns once
+    bool playing = false;
+
+    // Statistics of the audio output, written by the audio thread
+    std::atomic<std::size_t> stats_buffered_frames{0};
+    std::atomic<std::size_t> stats_target_frames{0};
+    std::atomic<u32> stats_underruns{0};
+    std::atomic<float> stats_stretch_ratio{1.0f};
+
+    /// Volume setting the gain was computed for
+    float current_volume = 1.0f;
+    /// Output gain in 1.15 fixed point
+    s16 volume_gain = 0x7FFF;
 };
 
 } // namespace AudioCore
@@ -0,0 +1,122 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <utility>
+#include "audio_core/file_sink.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "common/swap.h"
+
+namespace AudioCore {
+
+/// Size of the blocks handed over to the writer thread, about 8 seconds of audio
+constexpr std::size_t BLOCK_SIZE = 1024 * 1024;
+
+struct WavHeader {
+    std::array<char, 4> riff_id{'R', 'I', 'F', 'F'};
+    u32_le riff_size;
+    std::array<char, 4> wave_id{'W', 'A', 'V', 'E'};
+    std::array<char, 4> fmt_id{'f', 'm', 't', ' '};
+    u32_le fmt_size = 16;
+    u16_le format = 1; // PCM
+    u16_le num_channels = 2;
+    u32_le sample_rate = native_sample_rate;
+    u32_le byte_rate = native_sample_rate * 2 * sizeof(s16);
+    u16_le block_align = 2 * sizeof(s16);
+    u16_le bits_per_sample = 16;
+    std::array<char, 4> data_id{'d', 'a', 't', 'a'};
+    u32_le data_size;
+};
+static_assert(sizeof(WavHeader) == 44, "WavHeader has incorrect size");
+
+static WavHeader MakeWavHeader(u64 data_size) {
+    // Sizes above 4 GiB do not fit the header, the file is still readable by most tools
+    const u32 size = static_cast<u32>(std::min<u64>(data_size, 0xFFFFFFFF - sizeof(WavHeader)));
+    WavHeader header;
+    header.riff_size = static_cast<u32>(sizeof(WavHeader) - 8 + size);
+    header.data_size = size;
+    return header;
+}
+
+FileSink::FileSink(std::string path) {
+    if (path.empty() || path == auto_device_name) {
+        path = FileUtil::GetUserPath(FileUtil::UserPath::UserDir) + "audio_capture.wav";
+    }
+
+    std::string extension;
+    Common::SplitPath(path, nullptr, nullptr, &extension);
+    is_wav = Common::ToLower(extension) == ".wav";
+
+    if (!file.Open(path, "wb")) {
+        LOG_ERROR(Audio, "Could not open audio capture file {}", path);
+        return;
+    }
+    if (is_wav) {
+        // The sizes are filled in once the capture is complete
+        file.WriteObject(MakeWavHeader(0));
+    }
+    block.reserve(BLOCK_SIZE);
+    LOG_INFO(Audio, "Capturing audio output to {}", path);
+}
+
+FileSink::~FileSink() {
+    if (!file.IsOpen())
+        return;
+
+    SubmitBlock();
+    writer.WaitForIdle();
+    if (is_wav) {
+        file.Seek(0, SEEK_SET);
+        file.WriteObject(MakeWavHeader(data_size));
+    }
+    if (!file.Close() || !file.IsGood()) {
+        LOG_ERROR(Audio, "Error while writing the audio capture file");
+    }
+    LOG_INFO(Audio, "Captured {} audio samples", data_size / (2 * sizeof(s16)));
+}
+
+void FileSink::PushSamples(const s16* samples, std::size_t sample_count) {
+    if (!file.IsOpen())
+        return;
+
+    const u8* const bytes = reinterpret_cast<const u8*>(samples);
+    const std::size_t size = sample_count * 2 * sizeof(s16);
+    block.insert(block.end(), bytes, bytes + size);
+    data_size += size;
+    if (block.size() >= BLOCK_SIZE) {
+        SubmitBlock();
+    }
+}
+
+void FileSink::SubmitBlock() {
+    if (block.empty())
+        return;
+
+    auto data = std::make_shared<std::vector<u8>>(std::move(block));
+    writer.Push([this, data] { file.WriteBytes(data->data(), data->size()); });
+    block = {};
+    block.reserve(BLOCK_SIZE);
+}
+
+ChecksumSink::ChecksumSink(std::string) {}
+
+ChecksumSink::~ChecksumSink() {
+    LOG_INFO(Audio, "Audio output checksum: {:016X} ({} samples)", checksum, sample_count);
+}
+
+void ChecksumSink::PushSamples(const s16* samples, std::size_t count) {
+    constexpr u64 FNV_PRIME = 0x100000001B3;
+    for (std::size_t i = 0; i < count * 2; i++) {
+        const u16 sample = static_cast<u16>(samples[i]);
+        checksum = (checksum ^ (sample & 0xFF)) * FNV_PRIME;
+        checksum = (checksum ^ (sample >> 8)) * FNV_PRIME;
+    }
+    sample_count += count;
+}
+
+} // namespace AudioCore
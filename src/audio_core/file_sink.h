@@ -0,0 +1,91 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "audio_core/audio_types.h"
+#include "audio_core/sink.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/thread_pool.h"
+
+namespace AudioCore {
+
+/**
+ * Sink capturing the output of the DSP to a file, as fast as it is produced. Files with a .wav
+ * extension get a WAV header, any other file receives the raw interleaved stereo PCM16 samples.
+ * The samples are gathered in large blocks which are written by a background thread.
+ */
+class FileSink final : public Sink {
+public:
+    /// @param path Path of the file to write, "auto" captures to the user directory
+    explicit FileSink(std::string path);
+    ~FileSink() override;
+
+    unsigned int GetNativeSampleRate() const override {
+        return native_sample_rate;
+    }
+
+    void SetCallback(std::function<void(s16*, std::size_t)>) override {}
+
+    bool IsRealTime() const override {
+        return false;
+    }
+
+    void PushSamples(const s16* samples, std::size_t sample_count) override;
+
+private:
+    /// Hands the current block over to the writer thread
+    void SubmitBlock();
+
+    FileUtil::IOFile file;
+    bool is_wav = false;
+    u64 data_size = 0; ///< Number of bytes of samples captured so far
+    std::vector<u8> block;
+    Common::ThreadPool writer{1, "AudioFileSink"};
+};
+
+/**
+ * Sink hashing the output of the DSP instead of playing it, so that it can be validated without
+ * capturing it. The checksum is logged when the sink is destroyed.
+ */
+class ChecksumSink final : public Sink {
+public:
+    explicit ChecksumSink(std::string);
+    ~ChecksumSink() override;
+
+    unsigned int GetNativeSampleRate() const override {
+        return native_sample_rate;
+    }
+
+    void SetCallback(std::function<void(s16*, std::size_t)>) override {}
+
+    bool IsRealTime() const override {
+        return false;
+    }
+
+    void PushSamples(const s16* samples, std::size_t sample_count) override;
+
+    /**
+     * Returns the 64-bit FNV-1a hash of the samples received so far, in little endian. It only
+     * depends on the samples themselves, not on how they were pushed, so it can also be computed
+     * from a raw capture of the FileSink.
+     */
+    u64 GetChecksum() const {
+        return checksum;
+    }
+
+    u64 GetSampleCount() const {
+        return sample_count;
+    }
+
+private:
+    u64 checksum = 0xCBF29CE484222325;
+    u64 sample_count = 0;
+};
+
+} // namespace AudioCore
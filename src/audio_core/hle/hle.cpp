@@ -2,16 +2,24 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
 #include "audio_core/audio_types.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/hle.h"
 #include "audio_core/hle/mixers.h"
 #include "audio_core/hle/shared_memory.h"
 #include "audio_core/hle/source.h"
+#include "audio_core/hle/trace.h"
 #include "audio_core/sink.h"
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/ring_buffer.h"
+#include "common/thread.h"
 #include "core/core_timing.h"
 
 using InterruptType = Service::DSP::DSP_DSP::InterruptType;
@@ -20,22 +28,28 @@ using Service::DSP::DSP_DSP;
 namespace AudioCore {
 
 static constexpr u64 audio_frame_ticks = 1310252ull; ///< Units: ARM11 cycles
+/// Number of bytes each pipe holds, far more than the DSP ever writes before they are read
+static constexpr std::size_t pipe_capacity = 0x1000;
 
 struct DspHle::Impl final {
 public:
-    explicit Impl(DspHle& parent);
+    Impl(DspHle& parent, bool use_worker_thread);
     ~Impl();
 
     DspState GetDspState() const;
 
-    std::vector<u8> PipeRead(DspPipe pipe_number, u32 length);
+    std::size_t PipeRead(DspPipe pipe_number, u8* buffer, std::size_t length);
     std::size_t GetPipeReadableSize(DspPipe pipe_number) const;
-    void PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer);
+    void PipeWrite(DspPipe pipe_number, const u8* buffer, std::size_t length);
 
     std::array<u8, Memory::DSP_RAM_SIZE>& GetDspMemory();
 
     void SetServiceToInterrupt(std::weak_ptr<DSP_DSP> dsp);
 
+    void StartTraceCapture(const std::string& path);
+    void ReplayTraceFrame(const HLE::TraceFrame& frame);
+    void SetStageTimes(HLE::StageTimes* times);
+
 private:
     void ResetPipes();
     void WriteU16(DspPipe pipe_number, u16 value);
@@ -45,12 +59,21 @@ private:
     HLE::SharedMemory& ReadRegion();
     HLE::SharedMemory& WriteRegion();
 
-    StereoFrame16 GenerateCurrentFrame();
+    /// Reads a sample buffer for the sources, from the replayed trace or from the emulated memory
+    const u8* ReadBuffer(const HLE::BufferRead& read);
+    StereoFrame16 GenerateCurrentFrame(HLE::SharedMemory& read, HLE::SharedMemory& write);
     bool Tick();
     void AudioTickCallback(s64 cycles_late);
 
+    /// Copies the configuration of the application to the input of the worker thread.
+    void SnapshotWorkerInput();
+    /// Writes the results of the frame of the worker thread to the shared memory, once it is done.
+    void FinishWorkerFrame();
+    void WorkerThreadLoop();
+
     DspState dsp_state = DspState::Off;
-    std::array<std::vector<u8>, num_dsp_pipe> pipe_data;
+    /// Data written by the DSP to each pipe, waiting to be read by the application
+    std::array<Common::RingBuffer<u8, pipe_capacity>, num_dsp_pipe> pipe_data;
 
     HLE::DspMemory dsp_memory;
     std::array<HLE::Source, HLE::num_sources> sources{{
@@ -66,11 +89,40 @@ private:
     CoreTiming::EventType* tick_event;
 
     std::weak_ptr<DSP_DSP> dsp_dsp;
+
+    // With a worker thread, the emulation thread only copies the configuration of the application
+    // to worker_read, and the results from worker_write back to the shared memory. The frame
+    // itself is generated on the worker thread, while the emulation continues.
+    std::thread worker_thread;
+    Common::Event worker_frame_requested;
+    Common::Event worker_frame_done;
+    std::atomic_bool worker_stop{false};
+    bool worker_frame_pending = false;
+    std::unique_ptr<HLE::SharedMemory> worker_read;
+    std::unique_ptr<HLE::SharedMemory> worker_write;
+    StereoFrame16 worker_output_frame;
+
+    std::unique_ptr<HLE::TraceWriter> trace_writer;
+    HLE::TraceFrame trace_frame; ///< Inputs of the frame being generated, when capturing a trace
+    bool replaying_trace = false;
+    /// Latest contents of the sample buffers of the replayed trace, by address
+    std::unordered_map<PAddr, const std::vector<u8>*> replay_buffers;
+    HLE::StageTimes* stage_times = nullptr;
 };
 
-DspHle::Impl::Impl(DspHle& parent_) : parent(parent_) {
+DspHle::Impl::Impl(DspHle& parent_, bool use_worker_thread) : parent(parent_) {
     dsp_memory.raw_memory.fill(0);
 
+    for (HLE::Source& source : sources) {
+        source.SetBufferReader([this](const HLE::BufferRead& read) { return ReadBuffer(read); });
+    }
+
+    if (use_worker_thread) {
+        worker_read = std::make_unique<HLE::SharedMemory>();
+        worker_write = std::make_unique<HLE::SharedMemory>();
+        worker_thread = std::thread([this] { WorkerThreadLoop(); });
+    }
+
     tick_event =
         CoreTiming::RegisterEvent("AudioCore::DspHle::tick_event", [this](u64, s64 cycles_late) {
             this->AudioTickCallback(cycles_late);
@@ -80,41 +132,41 @@ DspHle::Impl::Impl(DspHle& parent_) : parent(parent_) {
 
 DspHle::Impl::~Impl() {
     CoreTiming::UnscheduleEvent(tick_event, 0);
+
+    if (worker_thread.joinable()) {
+        worker_stop = true;
+        worker_frame_requested.Set();
+        worker_thread.join();
+    }
 }
 
 DspState DspHle::Impl::GetDspState() const {
     return dsp_state;
 }
 
-std::vector<u8> DspHle::Impl::PipeRead(DspPipe pipe_number, u32 length) {
+std::size_t DspHle::Impl::PipeRead(DspPipe pipe_number, u8* buffer, std::size_t length) {
     const std::size_t pipe_index = static_cast<std::size_t>(pipe_number);
 
     if (pipe_index >= num_dsp_pipe) {
         LOG_ERROR(Audio_DSP, "pipe_number = {} invalid", pipe_index);
-        return {};
+        return 0;
     }
 
     if (length > UINT16_MAX) { // Can only read at most UINT16_MAX from the pipe
         LOG_ERROR(Audio_DSP, "length of {} greater than max of {}", length, UINT16_MAX);
-        return {};
+        return 0;
     }
 
-    std::vector<u8>& data = pipe_data[pipe_index];
+    auto& data = pipe_data[pipe_index];
 
-    if (length > data.size()) {
+    if (length > data.Size()) {
         LOG_WARNING(
             Audio_DSP,
             "pipe_number = {} is out of data, application requested read of {} but {} remain",
-            pipe_index, length, data.size());
-        length = static_cast<u32>(data.size());
+            pipe_index, length, data.Size());
     }
 
-    if (length == 0)
-        return {};
-
-    std::vector<u8> ret(data.begin(), data.begin() + length);
-    data.erase(data.begin(), data.begin() + length);
-    return ret;
+    return data.Pop(buffer, length);
 }
 
 size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) const {
@@ -125,15 +177,14 @@ size_t DspHle::Impl::GetPipeReadableSize(DspPipe pipe_number) const {
         return 0;
     }
 
-    return pipe_data[pipe_index].size();
+    return pipe_data[pipe_index].Size();
 }
 
-void DspHle::Impl::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer) {
+void DspHle::Impl::PipeWrite(DspPipe pipe_number, const u8* buffer, std::size_t length) {
     switch (pipe_number) {
     case DspPipe::Audio: {
-        if (buffer.size() != 4) {
-            LOG_ERROR(Audio_DSP, "DspPipe::Audio: Unexpected buffer length {} was written",
-                      buffer.size());
+        if (length != 4) {
+            LOG_ERROR(Audio_DSP, "DspPipe::Audio: Unexpected buffer length {} was written", length);
             return;
         }
 
@@ -200,7 +251,7 @@ void DspHle::Impl::SetServiceToInterrupt(std::weak_ptr<DSP_DSP> dsp) {
 
 void DspHle::Impl::ResetPipes() {
     for (auto& data : pipe_data) {
-        data.clear();
+        data.Clear();
     }
     dsp_state = DspState::Off;
 }
@@ -208,10 +259,11 @@ void DspHle::Impl::ResetPipes() {
 void DspHle::Impl::WriteU16(DspPipe pipe_number, u16 value) {
     const std::size_t pipe_index = static_cast<std::size_t>(pipe_number);
 
-    std::vector<u8>& data = pipe_data.at(pipe_index);
     // Little endian
-    data.emplace_back(value & 0xFF);
-    data.emplace_back(value >> 8);
+    const std::array<u8, 2> bytes{static_cast<u8>(value & 0xFF), static_cast<u8>(value >> 8)};
+    if (pipe_data.at(pipe_index).Push(bytes.data(), bytes.size()) != bytes.size()) {
+        LOG_ERROR(Audio_DSP, "pipe_number = {} is full, data was dropped", pipe_index);
+    }
 }
 
 void DspHle::Impl::AudioPipeWriteStructAddresses() {
@@ -274,9 +326,38 @@ HLE::SharedMemory& DspHle::Impl::WriteRegion() {
     return CurrentRegionIndex() != 0 ? dsp_memory.region_0 : dsp_memory.region_1;
 }
 
-StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
-    HLE::SharedMemory& read = ReadRegion();
-    HLE::SharedMemory& write = WriteRegion();
+MICROPROFILE_DEFINE(Audio_DSP_Frame, "Audio", "DSP Frame", MP_RGB(255, 160, 0));
+
+const u8* DspHle::Impl::ReadBuffer(const HLE::BufferRead& read) {
+    const u8* memory = nullptr;
+    if (replaying_trace) {
+        const auto it = replay_buffers.find(read.physical_address);
+        if (it != replay_buffers.end() && it->second->size() >= read.size) {
+            memory = it->second->data();
+        }
+    } else {
+        memory = Memory::GetPhysicalPointer(read.physical_address);
+    }
+
+    if (memory != nullptr && trace_writer && trace_writer->IsNewBuffer(read, memory)) {
+        trace_frame.buffers.push_back(
+            {read.physical_address, std::vector<u8>(memory, memory + read.size)});
+    }
+    return memory;
+}
+
+StereoFrame16 DspHle::Impl::GenerateCurrentFrame(HLE::SharedMemory& read,
+                                                  HLE::SharedMemory& write) {
+    MICROPROFILE_SCOPE(Audio_DSP_Frame);
+
+    // The configuration is recorded before the sources consume its dirty flags
+    if (trace_writer) {
+        trace_frame.source_configurations = read.source_configurations;
+        trace_frame.adpcm_coefficients = read.adpcm_coefficients;
+        trace_frame.dsp_configuration = read.dsp_configuration;
+        trace_frame.intermediate_mix_samples = read.intermediate_mix_samples;
+        trace_frame.buffers.clear();
+    }
 
     std::array<QuadFrame32, 3> intermediate_mixes = {};
 
@@ -284,39 +365,130 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
     for (std::size_t i = 0; i < HLE::num_sources; i++) {
         write.source_statuses.status[i] =
             sources[i].Tick(read.source_configurations.config[i], read.adpcm_coefficients.coeff[i]);
+        HLE::StageTimer timer(stage_times, &HLE::StageTimes::mix);
         for (std::size_t mix = 0; mix < 3; mix++) {
             sources[i].MixInto(intermediate_mixes[mix], mix);
         }
     }
 
     // Generate final mix
-    write.dsp_status = mixers.Tick(read.dsp_configuration, read.intermediate_mix_samples,
-                                   write.intermediate_mix_samples, intermediate_mixes);
+    StereoFrame16 output_frame;
+    {
+        HLE::StageTimer timer(stage_times, &HLE::StageTimes::mix);
+        write.dsp_status = mixers.Tick(read.dsp_configuration, read.intermediate_mix_samples,
+                                       write.intermediate_mix_samples, intermediate_mixes);
+        output_frame = mixers.GetOutput();
+    }
 
-    StereoFrame16 output_frame = mixers.GetOutput();
+    if (trace_writer) {
+        trace_writer->WriteFrame(trace_frame);
+    }
 
     // Write current output frame to the shared memory region
-    for (std::size_t samplei = 0; samplei < output_frame.size(); samplei++) {
-        for (std::size_t channeli = 0; channeli < output_frame[0].size(); channeli++) {
-            write.final_samples.pcm16[samplei][channeli] = s16_le(output_frame[samplei][channeli]);
-        }
-    }
+    std::copy_n(output_frame[0].data(), output_frame.size() * 2, write.final_samples.pcm16[0]);
 
     return output_frame;
 }
 
 bool DspHle::Impl::Tick() {
-    StereoFrame16 current_frame = {};
-
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
-    current_frame = GenerateCurrentFrame();
+
+    if (worker_thread.joinable()) {
+        if (worker_frame_pending)
+            worker_frame_done.Wait();
+
+        // The configuration of the application, and the aux samples it returns, are taken before
+        // the results of the previous frame are written back to the shared memory
+        SnapshotWorkerInput();
+        if (worker_frame_pending)
+            FinishWorkerFrame();
+
+        worker_frame_pending = true;
+        worker_frame_requested.Set();
+        return true;
+    }
+
+    StereoFrame16 current_frame = GenerateCurrentFrame(ReadRegion(), WriteRegion());
 
     parent.OutputFrame(current_frame);
 
     return true;
 }
 
+void DspHle::Impl::SnapshotWorkerInput() {
+    HLE::SharedMemory& read = ReadRegion();
+    worker_read->source_configurations = read.source_configurations;
+    worker_read->adpcm_coefficients = read.adpcm_coefficients;
+    worker_read->dsp_configuration = read.dsp_configuration;
+    worker_read->intermediate_mix_samples = read.intermediate_mix_samples;
+
+    // The configuration changes are consumed now, as the application may make new ones before
+    // the worker thread is done with these
+    for (auto& config : read.source_configurations.config) {
+        config.dirty_raw = 0;
+    }
+    read.dsp_configuration.dirty_raw = 0;
+}
+
+void DspHle::Impl::FinishWorkerFrame() {
+    // The results go to the region the application reads and fills next, as the results of a
+    // synchronous frame would. This includes the samples sent to its aux effects, which it returns
+    // in the same region.
+    HLE::SharedMemory& write = WriteRegion();
+    write.source_statuses = worker_write->source_statuses;
+    write.dsp_status = worker_write->dsp_status;
+    write.final_samples = worker_write->final_samples;
+    write.intermediate_mix_samples = worker_write->intermediate_mix_samples;
+
+    parent.OutputFrame(worker_output_frame);
+}
+
+void DspHle::Impl::WorkerThreadLoop() {
+    Common::SetCurrentThreadName("DspHle");
+
+    while (true) {
+        worker_frame_requested.Wait();
+        if (worker_stop)
+            return;
+
+        worker_output_frame = GenerateCurrentFrame(*worker_read, *worker_write);
+        worker_frame_done.Set();
+    }
+}
+
+void DspHle::Impl::StartTraceCapture(const std::string& path) {
+    trace_writer = std::make_unique<HLE::TraceWriter>(path);
+    if (!trace_writer->IsOpen()) {
+        trace_writer.reset();
+    }
+}
+
+void DspHle::Impl::ReplayTraceFrame(const HLE::TraceFrame& frame) {
+    ASSERT_MSG(!worker_thread.joinable(), "Traces cannot be replayed with a worker thread");
+
+    replaying_trace = true;
+    for (const HLE::TraceFrame::Buffer& buffer : frame.buffers) {
+        replay_buffers[buffer.physical_address] = &buffer.data;
+    }
+
+    HLE::SharedMemory& read = ReadRegion();
+    read.source_configurations = frame.source_configurations;
+    read.adpcm_coefficients = frame.adpcm_coefficients;
+    read.dsp_configuration = frame.dsp_configuration;
+    read.intermediate_mix_samples = frame.intermediate_mix_samples;
+
+    StereoFrame16 current_frame = GenerateCurrentFrame(read, WriteRegion());
+    parent.OutputFrame(current_frame);
+}
+
+void DspHle::Impl::SetStageTimes(HLE::StageTimes* times) {
+    stage_times = times;
+    for (HLE::Source& source : sources) {
+        source.SetStageTimes(times);
+    }
+}
+
 void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     if (Tick()) {
         // TODO(merry): Signal all the other interrupts as appropriate.
@@ -331,23 +503,24 @@ void DspHle::Impl::AudioTickCallback(s64 cycles_late) {
     CoreTiming::ScheduleEvent(audio_frame_ticks - cycles_late, tick_event);
 }
 
-DspHle::DspHle() : impl(std::make_unique<Impl>(*this)) {}
+DspHle::DspHle(bool use_worker_thread)
+    : impl(std::make_unique<Impl>(*this, use_worker_thread)) {}
 DspHle::~DspHle() = default;
 
 DspState DspHle::GetDspState() const {
     return impl->GetDspState();
 }
 
-std::vector<u8> DspHle::PipeRead(DspPipe pipe_number, u32 length) {
-    return impl->PipeRead(pipe_number, length);
+std::size_t DspHle::PipeRead(DspPipe pipe_number, u8* buffer, std::size_t length) {
+    return impl->PipeRead(pipe_number, buffer, length);
 }
 
 size_t DspHle::GetPipeReadableSize(DspPipe pipe_number) const {
     return impl->GetPipeReadableSize(pipe_number);
 }
 
-void DspHle::PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer) {
-    impl->PipeWrite(pipe_number, buffer);
+void DspHle::PipeWrite(DspPipe pipe_number, const u8* buffer, std::size_t length) {
+    impl->PipeWrite(pipe_number, buffer, length);
 }
 
 std::array<u8, Memory::DSP_RAM_SIZE>& DspHle::GetDspMemory() {
@@ -358,4 +531,16 @@ void DspHle::SetServiceToInterrupt(std::weak_ptr<DSP_DSP> dsp) {
     impl->SetServiceToInterrupt(std::move(dsp));
 }
 
+void DspHle::StartTraceCapture(const std::string& path) {
+    impl->StartTraceCapture(path);
+}
+
+void DspHle::ReplayTraceFrame(const HLE::TraceFrame& frame) {
+    impl->ReplayTraceFrame(frame);
+}
+
+void DspHle::SetStageTimes(HLE::StageTimes* times) {
+    impl->SetStageTimes(times);
+}
+
 } // namespace AudioCore
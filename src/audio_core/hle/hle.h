@@ -6,6 +6,7 @@
 
 #include <array>
 #include <memory>
+#include <string>
 #include <vector>
 #include "audio_core/audio_types.h"
 #include "audio_core/dsp_interface.h"
@@ -15,21 +16,47 @@
 
 namespace AudioCore {
 
+namespace HLE {
+struct StageTimes;
+struct TraceFrame;
+} // namespace HLE
+
 class DspHle final : public DspInterface {
 public:
-    DspHle();
+    /**
+     * @param use_worker_thread Whether to generate the audio frames on a worker thread, one frame
+     * behind the emulated DSP, instead of on the emulation thread.
+     */
+    explicit DspHle(bool use_worker_thread);
     ~DspHle();
 
     DspState GetDspState() const override;
 
-    std::vector<u8> PipeRead(DspPipe pipe_number, u32 length) override;
+    std::size_t PipeRead(DspPipe pipe_number, u8* buffer, std::size_t length) override;
     std::size_t GetPipeReadableSize(DspPipe pipe_number) const override;
-    void PipeWrite(DspPipe pipe_number, const std::vector<u8>& buffer) override;
+    void PipeWrite(DspPipe pipe_number, const u8* buffer, std::size_t length) override;
 
     std::array<u8, Memory::DSP_RAM_SIZE>& GetDspMemory() override;
 
     void SetServiceToInterrupt(std::weak_ptr<Service::DSP::DSP_DSP> dsp) override;
 
+    /**
+     * Records the inputs of each audio frame to a trace file, see HLE::TraceFrame. Must be called
+     * before the first audio frame.
+     */
+    void StartTraceCapture(const std::string& path);
+
+    /**
+     * Generates an audio frame from a frame of a trace, instead of from the emulated application
+     * and memory. Once a frame is replayed, the sample buffers are only read from the replayed
+     * frames, which must outlive the DSP. Not supported with a worker thread.
+     */
+    void ReplayTraceFrame(const HLE::TraceFrame& frame);
+
+    /// Sets where to accumulate the time spent in each stage of the audio processing, nullptr to
+    /// not measure it.
+    void SetStageTimes(HLE::StageTimes* times);
+
 private:
     struct Impl;
     friend struct Impl;
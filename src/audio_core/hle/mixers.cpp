@@ -4,6 +4,9 @@
 
 #include <algorithm>
 #include <cstddef>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/hle/mixers.h"
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -95,22 +98,52 @@ static std::array<s16, 2> AddAndClampToS16(const std::array<s16, 2>& a,
             ClampToS16(static_cast<s32>(a[1]) + static_cast<s32>(b[1]))};
 }
 
+#ifdef ARCHITECTURE_x86_64
+/// Clamps four left and four right samples to s16, then mixes them into four stereo samples of
+/// the frame.
+static void AddAndClampToS16(__m128i left, __m128i right, std::array<s16, 2>* samples) {
+    const __m128i stereo = _mm_packs_epi32(_mm_unpacklo_epi32(left, right),
+                                           _mm_unpackhi_epi32(left, right));
+    __m128i* const out = reinterpret_cast<__m128i*>(samples);
+    _mm_storeu_si128(out, _mm_adds_epi16(_mm_loadu_si128(out), stereo));
+}
+#endif
+
 void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& samples) {
     // TODO(merry): Limiter. (Currently we're performing final mixing assuming a disabled limiter.)
 
+    // Silent intermediate mixes contribute nothing
+    if (gain == 0.0f)
+        return;
+
+    std::size_t i = 0;
+#ifdef ARCHITECTURE_x86_64
+    const __m128 gain_vector = _mm_set1_ps(gain);
+    // Loads four samples of a channel from the current position, and applies the gain to them
+    const auto load = [&samples, &gain_vector, &i](std::size_t channel) {
+        const __m128i* const in = reinterpret_cast<const __m128i*>(&samples[channel][i]);
+        return _mm_mul_ps(gain_vector, _mm_cvtepi32_ps(_mm_loadu_si128(in)));
+    };
+#endif
+
     switch (state.output_format) {
     case OutputFormat::Mono:
-        std::transform(
-            current_frame.begin(), current_frame.end(), samples.begin(), current_frame.begin(),
-            [gain](const std::array<s16, 2>& accumulator,
-                   const std::array<s32, 4>& sample) -> std::array<s16, 2> {
-                // Downmix to mono
-                s16 mono = ClampToS16(static_cast<s32>(
-                    (gain * sample[0] + gain * sample[1] + gain * sample[2] + gain * sample[3]) /
-                    2));
-                // Mix into current frame
-                return AddAndClampToS16(accumulator, {mono, mono});
-            });
+#ifdef ARCHITECTURE_x86_64
+        for (; i + 4 <= samples_per_frame; i += 4) {
+            const __m128 sum =
+                _mm_add_ps(_mm_add_ps(_mm_add_ps(load(0), load(1)), load(2)), load(3));
+            const __m128i mono = _mm_cvttps_epi32(_mm_div_ps(sum, _mm_set1_ps(2.0f)));
+            AddAndClampToS16(mono, mono, &current_frame[i]);
+        }
+#endif
+        for (; i < samples_per_frame; i++) {
+            // Downmix to mono
+            s16 mono = ClampToS16(static_cast<s32>((gain * samples[0][i] + gain * samples[1][i] +
+                                                    gain * samples[2][i] + gain * samples[3][i]) /
+                                                   2));
+            // Mix into current frame
+            current_frame[i] = AddAndClampToS16(current_frame[i], {mono, mono});
+        }
         return;
 
     case OutputFormat::Surround:
@@ -118,16 +151,20 @@ void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& sample
         // fallthrough
 
     case OutputFormat::Stereo:
-        std::transform(
-            current_frame.begin(), current_frame.end(), samples.begin(), current_frame.begin(),
-            [gain](const std::array<s16, 2>& accumulator,
-                   const std::array<s32, 4>& sample) -> std::array<s16, 2> {
-                // Downmix to stereo
-                s16 left = ClampToS16(static_cast<s32>(gain * sample[0] + gain * sample[2]));
-                s16 right = ClampToS16(static_cast<s32>(gain * sample[1] + gain * sample[3]));
-                // Mix into current frame
-                return AddAndClampToS16(accumulator, {left, right});
-            });
+#ifdef ARCHITECTURE_x86_64
+        for (; i + 4 <= samples_per_frame; i += 4) {
+            const __m128i left = _mm_cvttps_epi32(_mm_add_ps(load(0), load(2)));
+            const __m128i right = _mm_cvttps_epi32(_mm_add_ps(load(1), load(3)));
+            AddAndClampToS16(left, right, &current_frame[i]);
+        }
+#endif
+        for (; i < samples_per_frame; i++) {
+            // Downmix to stereo
+            s16 left = ClampToS16(static_cast<s32>(gain * samples[0][i] + gain * samples[2][i]));
+            s16 right = ClampToS16(static_cast<s32>(gain * samples[1][i] + gain * samples[3][i]));
+            // Mix into current frame
+            current_frame[i] = AddAndClampToS16(current_frame[i], {left, right});
+        }
         return;
     }
 
@@ -135,50 +172,42 @@ void Mixers::DownmixAndMixIntoCurrentFrame(float gain, const QuadFrame32& sample
 }
 
 void Mixers::AuxReturn(const IntermediateMixSamples& read_samples) {
-    // NOTE: read_samples.mix{1,2}.pcm32 annoyingly have their dimensions in reverse order to
-    // QuadFrame32.
+    // NOTE: read_samples.mix{1,2}.pcm32 have the same planar layout as QuadFrame32.
 
     if (state.mixer1_enabled) {
-        for (std::size_t sample = 0; sample < samples_per_frame; sample++) {
-            for (std::size_t channel = 0; channel < 4; channel++) {
-                state.intermediate_mix_buffer[1][sample][channel] =
-                    read_samples.mix1.pcm32[channel][sample];
-            }
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            std::copy_n(read_samples.mix1.pcm32[channel], samples_per_frame,
+                        state.intermediate_mix_buffer[1][channel].begin());
         }
     }
 
     if (state.mixer2_enabled) {
-        for (std::size_t sample = 0; sample < samples_per_frame; sample++) {
-            for (std::size_t channel = 0; channel < 4; channel++) {
-                state.intermediate_mix_buffer[2][sample][channel] =
-                    read_samples.mix2.pcm32[channel][sample];
-            }
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            std::copy_n(read_samples.mix2.pcm32[channel], samples_per_frame,
+                        state.intermediate_mix_buffer[2][channel].begin());
         }
     }
 }
 
 void Mixers::AuxSend(IntermediateMixSamples& write_samples,
                      const std::array<QuadFrame32, 3>& input) {
-    // NOTE: read_samples.mix{1,2}.pcm32 annoyingly have their dimensions in reverse order to
-    // QuadFrame32.
+    // NOTE: write_samples.mix{1,2}.pcm32 have the same planar layout as QuadFrame32.
 
     state.intermediate_mix_buffer[0] = input[0];
 
     if (state.mixer1_enabled) {
-        for (std::size_t sample = 0; sample < samples_per_frame; sample++) {
-            for (std::size_t channel = 0; channel < 4; channel++) {
-                write_samples.mix1.pcm32[channel][sample] = input[1][sample][channel];
-            }
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            std::copy(input[1][channel].begin(), input[1][channel].end(),
+                      write_samples.mix1.pcm32[channel]);
         }
     } else {
         state.intermediate_mix_buffer[1] = input[1];
     }
 
     if (state.mixer2_enabled) {
-        for (std::size_t sample = 0; sample < samples_per_frame; sample++) {
-            for (std::size_t channel = 0; channel < 4; channel++) {
-                write_samples.mix2.pcm32[channel][sample] = input[2][sample][channel];
-            }
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            std::copy(input[2][channel].begin(), input[2][channel].end(),
+                      write_samples.mix2.pcm32[channel]);
         }
     } else {
         state.intermediate_mix_buffer[2] = input[2];
@@ -4,6 +4,9 @@
 
 #include <algorithm>
 #include <array>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
@@ -11,37 +14,98 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/memory.h"
+#include "core/settings.h"
 
 namespace AudioCore {
 namespace HLE {
 
+/// Size in bytes of a buffer of `length` samples
+static std::size_t GetBufferSize(SourceConfiguration::Configuration::Format format,
+                                 unsigned num_channels, u32 length) {
+    using Format = SourceConfiguration::Configuration::Format;
+    switch (format) {
+    case Format::PCM8:
+        return std::size_t{length} * num_channels;
+    case Format::PCM16:
+        return std::size_t{length} * num_channels * sizeof(s16);
+    case Format::ADPCM:
+        // Frames of 8 bytes containing 14 samples each
+        return (std::size_t{length} + 13) / 14 * 8;
+    default:
+        return 0;
+    }
+}
+
+void Source::SetBufferReader(BufferReader reader) {
+    buffer_reader = std::move(reader);
+}
+
+void Source::SetStageTimes(StageTimes* times) {
+    stage_times = times;
+}
+
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
                                   const s16_le (&adpcm_coeffs)[16]) {
     ParseConfig(config, adpcm_coeffs);
 
     if (state.enabled) {
         GenerateFrame();
+        StageTimer timer(stage_times, &StageTimes::mix);
+        PrepareMixInput();
     }
 
     return GetCurrentStatus();
 }
 
+/// Accumulates gain * input into output, truncating each product to an integer.
+static void MixChannel(float gain, const std::array<float, samples_per_frame>& input,
+                       std::array<s32, samples_per_frame>& output) {
+    std::size_t i = 0;
+#ifdef ARCHITECTURE_x86_64
+    const __m128 gain_vector = _mm_set1_ps(gain);
+    for (; i + 4 <= samples_per_frame; i += 4) {
+        const __m128i product = _mm_cvttps_epi32(_mm_mul_ps(gain_vector, _mm_loadu_ps(&input[i])));
+        __m128i* const out = reinterpret_cast<__m128i*>(&output[i]);
+        _mm_storeu_si128(out, _mm_add_epi32(_mm_loadu_si128(out), product));
+    }
+#endif
+    for (; i < samples_per_frame; i++) {
+        output[i] += static_cast<s32>(gain * input[i]);
+    }
+}
+
 void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
-    if (!state.enabled)
+    if (!state.enabled || frame_silent)
         return;
 
     const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
-    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+    for (std::size_t channel = 0; channel < 4; channel++) {
+        // Silent channels contribute nothing
+        if (gains[channel] == 0.0f)
+            continue;
         // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
-        dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
-        dest[samplei][1] += static_cast<s32>(gains[1] * current_frame[samplei][1]);
-        dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
-        dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
+        MixChannel(gains[channel], mix_input[channel % 2], dest[channel]);
+    }
+}
+
+void Source::PrepareMixInput() {
+    if (!state.enabled) {
+        frame_silent = true;
+        return;
+    }
+
+    s16 any_sample = 0;
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        mix_input[0][samplei] = current_frame[samplei][0];
+        mix_input[1][samplei] = current_frame[samplei][1];
+        any_sample |= current_frame[samplei][0] | current_frame[samplei][1];
     }
+    frame_silent = any_sample == 0;
 }
 
 void Source::Reset() {
     current_frame.fill({});
+    frame_silent = true;
     state = {};
 }
 
@@ -229,22 +293,41 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
 void Source::GenerateFrame() {
     current_frame.fill({});
 
-    if (state.current_buffer.empty() && !DequeueBuffer()) {
+    if (state.current_buffer.Empty() && !RefillCurrentBuffer()) {
         state.enabled = false;
         state.buffer_update = true;
         state.current_buffer_id = 0;
         return;
     }
 
+    // The polyphase filter is only used when enabled, otherwise the linear interpolation that was
+    // used for it so far is kept.
+    InterpolationMode interpolation_mode = state.interpolation_mode;
+    if (interpolation_mode == InterpolationMode::Polyphase &&
+        !Settings::values.enable_polyphase_interpolation) {
+        interpolation_mode = InterpolationMode::Linear;
+    }
+    if (interpolation_mode != state.active_interpolation_mode) {
+        // The history of the interpolator switched to is stale, it was last used long ago
+        if (interpolation_mode == InterpolationMode::Polyphase) {
+            state.interp_state.polyphase_history = {};
+        } else {
+            state.interp_state.xn1 = {};
+            state.interp_state.xn2 = {};
+        }
+        state.active_interpolation_mode = interpolation_mode;
+    }
+
     std::size_t frame_position = 0;
 
     state.current_sample_number = state.next_sample_number;
     while (frame_position < current_frame.size()) {
-        if (state.current_buffer.empty() && !DequeueBuffer()) {
+        if (state.current_buffer.Empty() && !RefillCurrentBuffer()) {
             break;
         }
 
-        switch (state.interpolation_mode) {
+        StageTimer timer(stage_times, &StageTimes::interpolate);
+        switch (interpolation_mode) {
         case InterpolationMode::None:
             AudioInterp::None(state.interp_state, state.current_buffer, state.rate_multiplier,
                               current_frame, frame_position);
@@ -254,10 +337,8 @@ void Source::GenerateFrame() {
                                 current_frame, frame_position);
             break;
         case InterpolationMode::Polyphase:
-            // TODO(merry): Implement polyphase interpolation
-            LOG_DEBUG(Audio_DSP, "Polyphase interpolation unimplemented; falling back to linear");
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            AudioInterp::Polyphase(state.interp_state, state.current_buffer,
+                                   state.rate_multiplier, current_frame, frame_position);
             break;
         default:
             UNIMPLEMENTED();
@@ -266,11 +347,29 @@ void Source::GenerateFrame() {
     }
     state.next_sample_number += static_cast<u32>(frame_position);
 
+    StageTimer timer(stage_times, &StageTimes::filter);
     state.filters.ProcessFrame(current_frame);
 }
 
+bool Source::RefillCurrentBuffer() {
+    StageTimer timer(stage_times, &StageTimes::decode);
+    if (state.decode_position == state.decode_length)
+        return DequeueBuffer();
+
+    const u8* const memory = ReadCurrentBuffer();
+    if (memory == nullptr) {
+        LOG_WARNING(Audio_DSP, "source_id={}: Buffer at {:#010x} is no longer mapped", source_id,
+                    state.decode_address);
+        state.decode_position = state.decode_length;
+        return true;
+    }
+
+    DecodeCurrentBuffer(memory);
+    return true;
+}
+
 bool Source::DequeueBuffer() {
-    ASSERT_MSG(state.current_buffer.empty(),
+    ASSERT_MSG(state.current_buffer.Empty(),
                "Shouldn't dequeue; we still have data in current_buffer");
 
     if (state.input_queue.empty())
@@ -284,30 +383,23 @@ bool Source::DequeueBuffer() {
         state.adpcm_state.yn2 = buf.adpcm_yn[1];
     }
 
-    const u8* const memory = Memory::GetPhysicalPointer(buf.physical_address);
-    if (memory) {
-        const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
-        switch (buf.format) {
-        case Format::PCM8:
-            state.current_buffer = Codec::DecodePCM8(num_channels, memory, buf.length);
-            break;
-        case Format::PCM16:
-            state.current_buffer = Codec::DecodePCM16(num_channels, memory, buf.length);
-            break;
-        case Format::ADPCM:
-            DEBUG_ASSERT(num_channels == 1);
-            state.current_buffer =
-                Codec::DecodeADPCM(memory, buf.length, state.adpcm_coeffs, state.adpcm_state);
-            break;
-        default:
-            UNIMPLEMENTED();
-            break;
-        }
+    const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
+    state.decode_address = buf.physical_address;
+    state.decode_size = GetBufferSize(buf.format, num_channels, buf.length);
+    state.decode_buffer_id = buf.buffer_id;
+    state.decode_format = buf.format;
+    state.decode_num_channels = num_channels;
+    state.decode_length = buf.length;
+    state.decode_position = 0;
+    const u8* const memory = ReadCurrentBuffer();
+    if (memory != nullptr) {
+        DecodeCurrentBuffer(memory);
     } else {
         LOG_WARNING(Audio_DSP,
                     "source_id={} buffer_id={} length={}: Invalid physical address {:#010x}",
                     source_id, buf.buffer_id, buf.length, buf.physical_address);
-        state.current_buffer.clear();
+        state.decode_length = state.decode_position = 0;
+        state.current_buffer.Clear();
         return true;
     }
 
@@ -322,11 +414,59 @@ bool Source::DequeueBuffer() {
         state.input_queue.push(buf);
     }
 
-    LOG_TRACE(Audio_DSP, "source_id={} buffer_id={} from_queue={} current_buffer.size()={}",
-              source_id, buf.buffer_id, buf.from_queue, state.current_buffer.size());
+    LOG_TRACE(Audio_DSP, "source_id={} buffer_id={} from_queue={} length={}", source_id,
+              buf.buffer_id, buf.from_queue, buf.length);
     return true;
 }
 
+const u8* Source::ReadCurrentBuffer() {
+    if (!buffer_reader)
+        return Memory::GetPhysicalPointer(state.decode_address);
+
+    // ADPCM samples are decoded from the start of their frame
+    const u32 first_sample = state.decode_format == Format::ADPCM
+                                 ? state.decode_position - state.decode_position % 14
+                                 : state.decode_position;
+    const u32 end_sample = state.decode_position + static_cast<u32>(GetDecodeCount());
+    const std::size_t decode_offset =
+        GetBufferSize(state.decode_format, state.decode_num_channels, first_sample);
+    const std::size_t decode_end =
+        GetBufferSize(state.decode_format, state.decode_num_channels, end_sample);
+    return buffer_reader({state.decode_address, state.decode_length, state.decode_buffer_id,
+                          state.decode_size, decode_offset, decode_end - decode_offset});
+}
+
+std::size_t Source::GetDecodeCount() const {
+    return std::min<std::size_t>(state.current_buffer.FreeSpace(),
+                                 state.decode_length - state.decode_position);
+}
+
+void Source::DecodeCurrentBuffer(const u8* memory) {
+    const std::size_t count = GetDecodeCount();
+    const unsigned num_channels = state.decode_num_channels;
+    const std::size_t first_sample = state.decode_position;
+    state.current_buffer.Append(count, [&](StereoBuffer16::Sample* output, std::size_t offset,
+                                           std::size_t length) {
+        switch (state.decode_format) {
+        case Format::PCM8:
+            Codec::DecodePCM8(num_channels, memory, first_sample + offset, length, output);
+            break;
+        case Format::PCM16:
+            Codec::DecodePCM16(num_channels, memory, first_sample + offset, length, output);
+            break;
+        case Format::ADPCM:
+            DEBUG_ASSERT(num_channels == 1);
+            Codec::DecodeADPCM(memory, first_sample + offset, length, state.adpcm_coeffs,
+                               state.adpcm_state, output);
+            break;
+        default:
+            UNIMPLEMENTED();
+            break;
+        }
+    });
+    state.decode_position += static_cast<u32>(count);
+}
+
 SourceStatus::Status Source::GetCurrentStatus() {
     SourceStatus::Status ret;
 
@@ -5,12 +5,14 @@
 #pragma once
 
 #include <array>
+#include <functional>
 #include <vector>
 #include <queue>
 #include "audio_core/audio_types.h"
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/filter.h"
+#include "audio_core/hle/trace.h"
 #include "audio_core/interpolate.h"
 #include "common/common_types.h"
 
@@ -54,9 +56,27 @@ public:
      */
     void MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const;
 
+    /**
+     * Reads a sample buffer from guest memory. Returns a pointer to the contents of the whole
+     * buffer, or nullptr if the address is invalid.
+     */
+    using BufferReader = std::function<const u8*(const BufferRead& read)>;
+
+    /// Sets how the sample buffers are read, they are read from the emulated memory by default.
+    void SetBufferReader(BufferReader reader);
+
+    /// Sets where to accumulate the time spent in each processing stage, nullptr to not measure it.
+    void SetStageTimes(StageTimes* times);
+
 private:
     const std::size_t source_id;
+    BufferReader buffer_reader;
+    StageTimes* stage_times = nullptr;
     StereoFrame16 current_frame;
+    /// current_frame converted to float, indexed by channel then by sample, for mixing.
+    std::array<std::array<float, samples_per_frame>, 2> mix_input;
+    /// Whether current_frame only contains silence, in which case it is not mixed.
+    bool frame_silent = true;
 
     using Format = SourceConfiguration::Configuration::Format;
     using InterpolationMode = SourceConfiguration::Configuration::InterpolationMode;
@@ -108,7 +128,19 @@ private:
 
         u32 current_sample_number = 0;
         u32 next_sample_number = 0;
-        AudioInterp::StereoBuffer16 current_buffer;
+        /// Decoded samples of the current buffer that have not been played yet. The current
+        /// buffer is decoded progressively as it is played.
+        StereoBuffer16 current_buffer;
+
+        /// Location of the current buffer, read again on every refill as the application can
+        /// write to it while it is played
+        PAddr decode_address = 0;
+        std::size_t decode_size = 0; ///< Size of the current buffer in bytes
+        u16 decode_buffer_id = 0;
+        Format decode_format = Format::PCM16;
+        unsigned decode_num_channels = 1;
+        u32 decode_length = 0;   ///< Length of the current buffer in samples
+        u32 decode_position = 0; ///< Number of samples of the current buffer decoded so far
 
         // buffer_id state
 
@@ -124,6 +156,8 @@ private:
 
         float rate_multiplier = 1.0;
         InterpolationMode interpolation_mode = InterpolationMode::Polyphase;
+        /// Interpolation used for the last frame, which may differ from interpolation_mode
+        InterpolationMode active_interpolation_mode = InterpolationMode::Linear;
         AudioInterp::State interp_state = {};
 
         // Filter state
@@ -138,9 +172,20 @@ private:
     void ParseConfig(SourceConfiguration::Configuration& config, const s16_le (&adpcm_coeffs)[16]);
     /// INTERNAL: Generate the current audio output for this frame based on our internal state.
     void GenerateFrame();
-    /// INTERNAL: Dequeues a buffer and does preprocessing on it (decoding, resampling). Puts it
-    /// into current_buffer.
+    /// INTERNAL: Converts current_frame into mix_input, and detects silence.
+    void PrepareMixInput();
+    /// INTERNAL: Decodes the next samples of the current buffer into current_buffer, or dequeues
+    /// the next buffer if the current one has been entirely decoded.
+    bool RefillCurrentBuffer();
+    /// INTERNAL: Dequeues a buffer and starts decoding it into current_buffer.
     bool DequeueBuffer();
+    /// INTERNAL: Reads the current buffer through buffer_reader, or from the emulated memory,
+    /// before decoding more of it.
+    const u8* ReadCurrentBuffer();
+    /// INTERNAL: Number of samples DecodeCurrentBuffer decodes next.
+    std::size_t GetDecodeCount() const;
+    /// INTERNAL: Decodes as many samples of the current buffer as fit in current_buffer.
+    void DecodeCurrentBuffer(const u8* memory);
     /// INTERNAL: Generates a SourceStatus::Status based on our internal state.
     SourceStatus::Status GetCurrentStatus();
 };
@@ -0,0 +1,151 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstdio>
+#include <cstring>
+#include "audio_core/hle/trace.h"
+#include "common/hash.h"
+#include "common/logging/log.h"
+
+namespace AudioCore {
+namespace HLE {
+
+// Trace files start with a header, followed by the frames up to the end of the file. Each frame is
+// made of its configuration structures, then of the number of its buffers, each written as its
+// address, its size and its contents. The frames are not counted in the header, so that a trace
+// interrupted by a crash can still be loaded.
+constexpr u32 trace_magic = 0x54505344; // "DSPT"
+constexpr u32 trace_version = 2;
+
+struct TraceHeader {
+    u32_le magic;
+    u32_le version;
+};
+static_assert(sizeof(TraceHeader) == 8, "TraceHeader has incorrect size");
+
+struct TraceBufferHeader {
+    u32_le physical_address;
+    u32_le size;
+};
+static_assert(sizeof(TraceBufferHeader) == 8, "TraceBufferHeader has incorrect size");
+
+TraceWriter::TraceWriter(const std::string& path) {
+    if (!file.Open(path, "wb")) {
+        LOG_ERROR(Audio_DSP, "Could not open DSP trace file {}", path);
+        return;
+    }
+    file.WriteObject(TraceHeader{trace_magic, trace_version});
+    LOG_INFO(Audio_DSP, "Recording DSP trace to {}", path);
+}
+
+TraceWriter::~TraceWriter() {
+    if (!file.IsOpen())
+        return;
+
+    if (!file.Close() || !file.IsGood()) {
+        LOG_ERROR(Audio_DSP, "Error while writing the DSP trace");
+    }
+    LOG_INFO(Audio_DSP, "Recorded {} frames of DSP trace", frame_count);
+}
+
+void TraceWriter::WriteFrame(const TraceFrame& frame) {
+    if (!file.IsOpen())
+        return;
+
+    file.WriteObject(frame.source_configurations);
+    file.WriteObject(frame.adpcm_coefficients);
+    file.WriteObject(frame.dsp_configuration);
+    file.WriteObject(frame.intermediate_mix_samples);
+    file.WriteObject(static_cast<u32_le>(static_cast<u32>(frame.buffers.size())));
+    for (const TraceFrame::Buffer& buffer : frame.buffers) {
+        file.WriteObject(TraceBufferHeader{buffer.physical_address,
+                                           static_cast<u32>(buffer.data.size())});
+        file.WriteBytes(buffer.data.data(), buffer.data.size());
+    }
+    frame_count++;
+}
+
+bool TraceWriter::IsNewBuffer(const BufferRead& read, const u8* data) {
+    const auto [it, inserted] = recorded_buffers.try_emplace(read.physical_address);
+    RecordedBuffer& recorded = it->second;
+    const bool same_buffer = !inserted && recorded.length == read.length &&
+                             recorded.buffer_id == read.buffer_id &&
+                             recorded.data.size() == read.size;
+
+    // A buffer still played, or played again, is only compared where the source decodes it, as
+    // the application may write to it while it is played
+    if (same_buffer && std::memcmp(recorded.data.data() + read.decode_offset,
+                                   data + read.decode_offset, read.decode_size) == 0) {
+        return false;
+    }
+
+    const u64 hash = Common::ComputeHash64(data, read.size);
+    if (!same_buffer) {
+        recorded.length = read.length;
+        recorded.buffer_id = read.buffer_id;
+        if (!inserted && recorded.hash == hash && recorded.data.size() == read.size)
+            return false;
+    }
+
+    recorded.hash = hash;
+    recorded.data.assign(data, data + read.size);
+    return true;
+}
+
+/**
+ * Reads a frame of a trace, checking the sizes it contains against the size of the file before
+ * allocating anything.
+ * @returns false if the file ends before the frame does
+ */
+static bool ReadTraceFrame(FileUtil::IOFile& file, u64 file_size, TraceFrame& frame) {
+    u32_le buffer_count;
+    file.ReadBytes(&frame.source_configurations, sizeof(frame.source_configurations));
+    file.ReadBytes(&frame.adpcm_coefficients, sizeof(frame.adpcm_coefficients));
+    file.ReadBytes(&frame.dsp_configuration, sizeof(frame.dsp_configuration));
+    file.ReadBytes(&frame.intermediate_mix_samples, sizeof(frame.intermediate_mix_samples));
+    file.ReadBytes(&buffer_count, sizeof(buffer_count));
+    if (!file.IsGood() || buffer_count > (file_size - file.Tell()) / sizeof(TraceBufferHeader))
+        return false;
+
+    frame.buffers.resize(buffer_count);
+    for (TraceFrame::Buffer& buffer : frame.buffers) {
+        TraceBufferHeader buffer_header;
+        if (file.ReadBytes(&buffer_header, sizeof(buffer_header)) != sizeof(buffer_header) ||
+            buffer_header.size > file_size - file.Tell()) {
+            return false;
+        }
+        buffer.physical_address = buffer_header.physical_address;
+        buffer.data.resize(buffer_header.size);
+        if (file.ReadBytes(buffer.data.data(), buffer.data.size()) != buffer.data.size())
+            return false;
+    }
+    return true;
+}
+
+std::vector<TraceFrame> LoadTrace(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    TraceHeader header;
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != trace_magic || header.version != trace_version) {
+        LOG_ERROR(Audio_DSP, "{} is not a valid DSP trace", path);
+        return {};
+    }
+
+    const u64 file_size = file.GetSize();
+    std::vector<TraceFrame> frames;
+    while (file.Tell() < file_size) {
+        TraceFrame frame;
+        if (!ReadTraceFrame(file, file_size, frame)) {
+            // The last frame is incomplete if the recording was interrupted
+            LOG_WARNING(Audio_DSP, "DSP trace {} is truncated after {} frames", path,
+                        frames.size());
+            break;
+        }
+        frames.push_back(std::move(frame));
+    }
+    return frames;
+}
+
+} // namespace HLE
+} // namespace AudioCore
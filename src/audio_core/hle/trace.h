@@ -0,0 +1,119 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "audio_core/hle/shared_memory.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace AudioCore {
+namespace HLE {
+
+/**
+ * Inputs of the HLE DSP for one audio frame: the configuration the application wrote to the shared
+ * memory, and the sample buffers the sources started playing during the frame. A sequence of
+ * frames allows replaying the audio processing of a game without the rest of the emulator.
+ */
+struct TraceFrame {
+    struct Buffer {
+        PAddr physical_address;
+        std::vector<u8> data;
+    };
+
+    SourceConfiguration source_configurations;
+    AdpcmCoefficients adpcm_coefficients;
+    DspConfiguration dsp_configuration;
+    IntermediateMixSamples intermediate_mix_samples;
+    /// Sample buffers read from guest memory during the frame. A buffer is only recorded again
+    /// when its contents changed since the last time it was recorded.
+    std::vector<Buffer> buffers;
+};
+
+/// A read of a sample buffer by a source, before it decodes part of the buffer
+struct BufferRead {
+    PAddr physical_address;
+    u32 length;                ///< Length of the buffer in samples
+    u16 buffer_id;             ///< Buffers are identified by their address, length and id
+    std::size_t size;          ///< Size of the buffer in bytes
+    std::size_t decode_offset; ///< Offset in bytes of the part of the buffer to decode
+    std::size_t decode_size;   ///< Size in bytes of the part of the buffer to decode
+};
+
+/// Writes a trace file, frame by frame as they are generated.
+class TraceWriter {
+public:
+    explicit TraceWriter(const std::string& path);
+    ~TraceWriter();
+
+    bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    void WriteFrame(const TraceFrame& frame);
+
+    /**
+     * Whether a buffer should be recorded, that is if the contents last recorded at its address
+     * differ. The whole buffer is only hashed when a source dequeues it for the first time, after
+     * that only the part of it the source decodes is compared.
+     * @param data Contents of the whole buffer
+     */
+    bool IsNewBuffer(const BufferRead& read, const u8* data);
+
+private:
+    struct RecordedBuffer {
+        u32 length;
+        u16 buffer_id;
+        u64 hash;
+        std::vector<u8> data;
+    };
+
+    FileUtil::IOFile file;
+    u32 frame_count = 0;
+    /// Buffer whose contents were last recorded at each address, as they are replayed by address
+    std::unordered_map<PAddr, RecordedBuffer> recorded_buffers;
+};
+
+/**
+ * Loads a trace file written by TraceWriter. The last frame is dropped if it is incomplete, as
+ * when the recording was interrupted.
+ * @returns The frames of the trace, empty if the file could not be read
+ */
+std::vector<TraceFrame> LoadTrace(const std::string& path);
+
+/// Time spent in each stage of the audio processing, accumulated over several frames
+struct StageTimes {
+    std::chrono::nanoseconds decode{};
+    std::chrono::nanoseconds interpolate{};
+    std::chrono::nanoseconds filter{};
+    std::chrono::nanoseconds mix{};
+};
+
+/// Adds the time spent in its scope to a stage of a StageTimes, if there is one
+class StageTimer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    StageTimer(StageTimes* times, std::chrono::nanoseconds StageTimes::*stage)
+        : counter(times != nullptr ? &(times->*stage) : nullptr) {
+        if (counter != nullptr)
+            start = Clock::now();
+    }
+
+    ~StageTimer() {
+        if (counter != nullptr)
+            *counter += Clock::now() - start;
+    }
+
+private:
+    std::chrono::nanoseconds* counter;
+    Clock::time_point start;
+};
+
+} // namespace HLE
+} // namespace AudioCore
@@ -3,6 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -21,10 +26,16 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
                             std::size_t& outputi, Function fn) {
     ASSERT(rate > 0);
 
-    if (input.empty())
+    if (input.Empty())
         return;
 
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    // The two historical samples precede the samples of the input
+    const auto sample_at = [&state, &input](std::size_t index) -> const std::array<s16, 2>& {
+        if (index >= 2)
+            return input[index - 2];
+        return index == 0 ? state.xn2 : state.xn1;
+    };
+    const std::size_t input_size = input.Size() + 2;
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
@@ -33,22 +44,25 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     while (outputi < output.size()) {
         inputi = static_cast<std::size_t>(fposition / scale_factor);
 
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
+        if (inputi + 2 >= input_size) {
+            inputi = input_size - 2;
             break;
         }
 
         u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+        output[outputi++] =
+            fn(fraction, sample_at(inputi), sample_at(inputi + 1), sample_at(inputi + 2));
 
         fposition += step_size;
     }
 
-    state.xn2 = input[inputi];
-    state.xn1 = input[inputi + 1];
+    const std::array<s16, 2> xn2 = sample_at(inputi);
+    const std::array<s16, 2> xn1 = sample_at(inputi + 1);
+    state.xn2 = xn2;
+    state.xn1 = xn1;
     state.fposition = fposition - inputi * scale_factor;
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    input.Pop(inputi);
 }
 
 void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
@@ -74,5 +88,181 @@ void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& outp
                     });
 }
 
+// The polyphase filter has one set of coefficients per 1/polyphase_phases of a sample. The
+// coefficients of the two phases surrounding the fractional position are blended linearly.
+constexpr std::size_t polyphase_phases = 64;
+constexpr u64 polyphase_phase_shift = 24 - 6;
+static_assert(scale_factor >> polyphase_phase_shift == polyphase_phases);
+constexpr std::size_t polyphase_history = polyphase_taps - 1;
+/// Position in the filter window of the input sample an output sample is aligned with.
+constexpr std::size_t polyphase_center = polyphase_taps / 2 - 1;
+
+namespace {
+
+struct PolyphaseTable {
+    /// One cache line of coefficients per phase, followed by phase 0 of the next sample.
+    alignas(64) std::array<std::array<float, polyphase_taps>, polyphase_phases + 1> coefficients;
+
+    PolyphaseTable() {
+        constexpr double pi = 3.14159265358979323846;
+        constexpr double half_width = polyphase_taps / 2;
+
+        for (std::size_t phase = 0; phase <= polyphase_phases; phase++) {
+            const double fraction = static_cast<double>(phase) / polyphase_phases;
+            std::array<double, polyphase_taps> taps;
+            double sum = 0.0;
+            for (std::size_t tap = 0; tap < polyphase_taps; tap++) {
+                // Distance from the interpolated position to the input sample of the tap
+                const double t = static_cast<double>(tap) - polyphase_center - fraction;
+                const double sinc = t == 0.0 ? 1.0 : std::sin(pi * t) / (pi * t);
+                // Blackman window, reaching zero half_width samples away
+                const double x = t / half_width;
+                const double window = 0.42 + 0.5 * std::cos(pi * x) + 0.08 * std::cos(2 * pi * x);
+                taps[tap] = sinc * window;
+                sum += taps[tap];
+            }
+
+            // Unity gain at DC
+            for (std::size_t tap = 0; tap < polyphase_taps; tap++) {
+                coefficients[phase][tap] = static_cast<float>(taps[tap] / sum);
+            }
+        }
+
+        // On the input samples themselves, the filter passes them through exactly
+        coefficients[0].fill(0.0f);
+        coefficients[0][polyphase_center] = 1.0f;
+        coefficients[polyphase_phases].fill(0.0f);
+        coefficients[polyphase_phases][polyphase_center + 1] = 1.0f;
+    }
+};
+
+const PolyphaseTable& GetPolyphaseTable() {
+    static const PolyphaseTable table;
+    return table;
+}
+
+/**
+ * Computes an output sample from polyphase_taps input samples of each channel. The SSE and the
+ * scalar versions perform the same operations in the same order, and give the same results.
+ * @param left, right Input samples of each channel
+ * @param coeffs0, coeffs1 Coefficients of the phases surrounding the position
+ * @param blend Position between the two phases, from 0 to 1
+ */
+std::array<s16, 2> ApplyPolyphaseFilter(const float* left, const float* right,
+                                        const float* coeffs0, const float* coeffs1, float blend) {
+#ifdef ARCHITECTURE_x86_64
+    const __m128 blend_vector = _mm_set1_ps(blend);
+    __m128 left_sum = _mm_setzero_ps();
+    __m128 right_sum = _mm_setzero_ps();
+    for (std::size_t i = 0; i < polyphase_taps; i += 4) {
+        const __m128 c0 = _mm_load_ps(coeffs0 + i);
+        const __m128 c1 = _mm_load_ps(coeffs1 + i);
+        const __m128 coeffs = _mm_add_ps(c0, _mm_mul_ps(blend_vector, _mm_sub_ps(c1, c0)));
+        left_sum = _mm_add_ps(left_sum, _mm_mul_ps(coeffs, _mm_loadu_ps(left + i)));
+        right_sum = _mm_add_ps(right_sum, _mm_mul_ps(coeffs, _mm_loadu_ps(right + i)));
+    }
+
+    // {left0 + left2, right0 + right2, left1 + left3, right1 + right3}
+    const __m128 pairs = _mm_add_ps(_mm_unpacklo_ps(left_sum, right_sum),
+                                    _mm_unpackhi_ps(left_sum, right_sum));
+    const __m128 sums = _mm_add_ps(pairs, _mm_movehl_ps(pairs, pairs));
+    const __m128i samples = _mm_cvtps_epi32(sums);
+    const s32 packed = _mm_cvtsi128_si32(_mm_packs_epi32(samples, samples));
+
+    std::array<s16, 2> result;
+    std::memcpy(result.data(), &packed, sizeof(result));
+    return result;
+#else
+    std::array<float, 4> left_sum{};
+    std::array<float, 4> right_sum{};
+    for (std::size_t i = 0; i < polyphase_taps; i += 4) {
+        for (std::size_t lane = 0; lane < 4; lane++) {
+            const float c0 = coeffs0[i + lane];
+            const float coeffs = c0 + blend * (coeffs1[i + lane] - c0);
+            left_sum[lane] += coeffs * left[i + lane];
+            right_sum[lane] += coeffs * right[i + lane];
+        }
+    }
+
+    const auto to_s16 = [](float sum) {
+        return static_cast<s16>(std::clamp(std::nearbyint(sum), -32768.0f, 32767.0f));
+    };
+    return {to_s16((left_sum[0] + left_sum[2]) + (left_sum[1] + left_sum[3])),
+            to_s16((right_sum[0] + right_sum[2]) + (right_sum[1] + right_sum[3]))};
+#endif
+}
+
+} // namespace
+
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi) {
+    ASSERT(rate > 0);
+
+    if (input.Empty())
+        return;
+
+    // The historical samples precede the samples of the input
+    const auto sample_at = [&state, &input](std::size_t index) -> const std::array<s16, 2>& {
+        if (index >= polyphase_history)
+            return input[index - polyphase_history];
+        return state.polyphase_history[index];
+    };
+    const std::size_t input_size = input.Size() + polyphase_history;
+
+    const u64 step_size = static_cast<u64>(rate * scale_factor);
+    u64 fposition = state.fposition;
+
+    if (step_size == scale_factor && (fposition & scale_mask) == 0) {
+        // The filter passes the input samples through, they are copied as they are
+        for (std::size_t inputi = static_cast<std::size_t>(fposition / scale_factor);
+             outputi < output.size() && inputi + polyphase_taps <= input_size; inputi++) {
+            output[outputi++] = sample_at(inputi + polyphase_center);
+            fposition += step_size;
+        }
+    } else {
+        // The samples used by this call are converted to float once, one channel after the other
+        std::array<std::array<float, StereoBuffer16::CAPACITY + polyphase_history>, 2> samples;
+        const u64 end_position = fposition + (output.size() - outputi) * step_size;
+        const std::size_t last = std::min<std::size_t>(
+            input_size, static_cast<std::size_t>(end_position / scale_factor) + polyphase_taps);
+        const std::size_t first =
+            std::min(static_cast<std::size_t>(fposition / scale_factor), last);
+        for (std::size_t i = first; i < last; i++) {
+            const std::array<s16, 2>& sample = sample_at(i);
+            samples[0][i - first] = sample[0];
+            samples[1][i - first] = sample[1];
+        }
+
+        const PolyphaseTable& table = GetPolyphaseTable();
+        while (outputi < output.size()) {
+            const std::size_t inputi = static_cast<std::size_t>(fposition / scale_factor);
+            if (inputi + polyphase_taps > last)
+                break;
+
+            const u64 fraction = fposition & scale_mask;
+            const std::size_t phase = static_cast<std::size_t>(fraction >> polyphase_phase_shift);
+            const float blend = static_cast<float>(fraction & ((1 << polyphase_phase_shift) - 1)) /
+                                (1 << polyphase_phase_shift);
+            output[outputi++] = ApplyPolyphaseFilter(
+                &samples[0][inputi - first], &samples[1][inputi - first],
+                table.coefficients[phase].data(), table.coefficients[phase + 1].data(), blend);
+
+            fposition += step_size;
+        }
+    }
+
+    // Keep the samples preceding the next position as history
+    const std::size_t inputi = std::min(static_cast<std::size_t>(fposition / scale_factor),
+                                        input_size - polyphase_history);
+    std::array<std::array<s16, 2>, polyphase_history> history;
+    for (std::size_t i = 0; i < polyphase_history; i++) {
+        history[i] = sample_at(inputi + i);
+    }
+    state.polyphase_history = history;
+    state.fposition = fposition - inputi * scale_factor;
+
+    input.Pop(inputi);
+}
+
 } // namespace AudioInterp
 } // namespace AudioCore
@@ -5,20 +5,22 @@
 #pragma once
 
 #include <array>
-#include <deque>
+#include <cstddef>
 #include "audio_core/audio_types.h"
 #include "common/common_types.h"
 
 namespace AudioCore {
 namespace AudioInterp {
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/// Number of input samples each output sample of the polyphase filter is computed from.
+constexpr std::size_t polyphase_taps = 16;
 
 struct State {
     /// Two historical samples.
     std::array<s16, 2> xn1 = {}; ///< x[n-1]
     std::array<s16, 2> xn2 = {}; ///< x[n-2]
+    /// Historical samples of the polyphase filter, oldest first.
+    std::array<std::array<s16, 2>, polyphase_taps - 1> polyphase_history = {};
     /// Current fractional position.
     u64 fposition = 0;
 };
@@ -26,7 +28,7 @@ struct State {
 /**
  * No interpolation. This is equivalent to a zero-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
- * @param input Input buffer.
+ * @param input Input buffer. The consumed samples are removed from it.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
@@ -38,7 +40,7 @@ void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output
 /**
  * Linear interpolation. This is equivalent to a first-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
- * @param input Input buffer.
+ * @param input Input buffer. The consumed samples are removed from it.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
@@ -47,5 +49,18 @@ void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output
 void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
             std::size_t& outputi);
 
+/**
+ * Polyphase interpolation with a windowed sinc filter of polyphase_taps taps. There is an
+ * eight-sample predelay. At a rate of exactly 1.0 the input is copied unmodified.
+ * @param state Interpolation state.
+ * @param input Input buffer. The consumed samples are removed from it.
+ * @param rate Stretch factor. Must be a positive non-zero value.
+ *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
+ * @param output The resampled audio buffer.
+ * @param outputi The index of output to start writing to.
+ */
+void Polyphase(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
+               std::size_t& outputi);
+
 } // namespace AudioInterp
 } // namespace AudioCore
@@ -0,0 +1,56 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include "audio_core/latency_controller.h"
+
+namespace AudioCore {
+
+/// Time it takes for the jitter and the underrun margin to decay by a factor of e, in seconds
+constexpr double decay_time_scale = 5.0;
+/// Latency added by each underrun, in seconds
+constexpr double underrun_step = static_cast<double>(samples_per_frame) / native_sample_rate;
+/// Largest latency added by the underruns, in seconds
+constexpr double max_underrun_margin = 0.1;
+/**
+ * The emulation produces the audio frames of a whole emulated screen refresh at once, about 3.3
+ * audio frames, so the buffer must hold at least this much on top of the needs of the sink.
+ */
+constexpr double producer_burst = 4.0 * samples_per_frame / native_sample_rate;
+
+LatencyController::LatencyController(unsigned int sample_rate) : sample_rate(sample_rate) {}
+
+void LatencyController::SetSampleRate(unsigned int sample_rate_) {
+    sample_rate = sample_rate_;
+}
+
+void LatencyController::OnCallback(Clock::time_point now, std::size_t num_frames) {
+    const double period = static_cast<double>(num_frames) / sample_rate;
+    if (last_callback) {
+        // The previous callback requested audio for callback_period, so the sink should have come
+        // back for more after that long
+        const double interval = std::chrono::duration<double>(now - *last_callback).count();
+        const double decay = std::exp(-interval / decay_time_scale);
+        jitter = std::max(std::abs(interval - callback_period), jitter * decay);
+        underrun_margin *= decay;
+    }
+    last_callback = now;
+    callback_period = period;
+}
+
+void LatencyController::OnUnderrun() {
+    underrun_margin = std::min(underrun_margin + underrun_step, max_underrun_margin);
+}
+
+double LatencyController::GetMinimumLatency() const {
+    return callback_period + 2.0 * jitter + producer_burst + underrun_margin;
+}
+
+double LatencyController::GetTargetLatency(double configured_latency, bool low_latency) const {
+    const double minimum_latency = GetMinimumLatency();
+    return low_latency ? minimum_latency : std::max(configured_latency, minimum_latency);
+}
+
+} // namespace AudioCore
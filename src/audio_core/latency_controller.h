@@ -0,0 +1,66 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include "audio_core/audio_types.h"
+
+namespace AudioCore {
+
+/**
+ * Chooses how much audio to keep buffered for the sink. It measures the jitter of the callbacks of
+ * the sink and counts the underruns to estimate the smallest latency playing without gaps, then
+ * targets the larger of that and the configured latency. It runs on the audio thread, and never
+ * allocates memory nor takes locks.
+ */
+class LatencyController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// @param sample_rate Sample rate of the sink, used to convert callback sizes to durations
+    explicit LatencyController(unsigned int sample_rate = native_sample_rate);
+
+    void SetSampleRate(unsigned int sample_rate);
+
+    /**
+     * Records a callback of the sink, called at its start.
+     * @param now Time at which the callback started
+     * @param num_frames Number of frames the sink requested
+     */
+    void OnCallback(Clock::time_point now, std::size_t num_frames);
+
+    /// Records that the sink ran out of samples during the last callback.
+    void OnUnderrun();
+
+    /// Smallest latency estimated to play without gaps, in seconds
+    double GetMinimumLatency() const;
+
+    /**
+     * Latency to keep buffered, in seconds.
+     * @param configured_latency Latency configured by the user, in seconds
+     * @param low_latency Whether to target the smallest latency estimated to play without gaps,
+     * instead of the configured latency
+     */
+    double GetTargetLatency(double configured_latency, bool low_latency) const;
+
+    /// Jitter of the callbacks of the sink, that is how late or early they recently ran at worst
+    double GetJitter() const {
+        return jitter;
+    }
+
+private:
+    unsigned int sample_rate;
+    std::optional<Clock::time_point> last_callback;
+    /// Duration of the audio requested by the last callback, in seconds
+    double callback_period = 0.0;
+    /// Decaying peak of the callback jitter, in seconds
+    double jitter = 0.0;
+    /// Extra latency added after underruns, decaying back to zero, in seconds
+    double underrun_margin = 0.0;
+};
+
+} // namespace AudioCore
@@ -20,6 +20,12 @@ public:
     }
 
     void SetCallback(std::function<void(s16*, std::size_t)>) override {}
+
+    bool IsRealTime() const override {
+        return false;
+    }
+
+    void PushSamples(const s16*, std::size_t) override {}
 };
 
 } // namespace AudioCore
@@ -30,6 +30,22 @@ public:
      * @param sample_count Number of samples.
      */
     virtual void SetCallback(std::function<void(s16*, std::size_t)> cb) = 0;
+
+    /**
+     * Whether this sink plays samples in real time, pulling them through the callback. Sinks that
+     * are not real-time are instead handed the frames of the DSP through PushSamples as soon as
+     * they are produced, without time stretching nor volume, so they never pace the emulation.
+     */
+    virtual bool IsRealTime() const {
+        return true;
+    }
+
+    /**
+     * Receives the frames of the DSP, only called for sinks that are not real-time.
+     * @param samples Samples in interleaved stereo PCM16 format.
+     * @param sample_count Number of samples.
+     */
+    virtual void PushSamples(const s16* samples, std::size_t sample_count) {}
 };
 
 } // namespace AudioCore
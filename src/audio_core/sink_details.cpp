@@ -6,6 +6,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "audio_core/file_sink.h"
 #include "audio_core/null_sink.h"
 #include "audio_core/sink_details.h"
 #ifdef HAVE_SDL2
@@ -28,6 +29,11 @@ const std::vector<SinkDetails> g_sink_details = {
 #endif
     SinkDetails{"null", &std::make_unique<NullSink, std::string>,
                 [] { return std::vector<std::string>{"null"}; }},
+    // The device of the file sink is the path of the capture
+    SinkDetails{"file", &std::make_unique<FileSink, std::string>,
+                [] { return std::vector<std::string>{}; }},
+    SinkDetails{"checksum", &std::make_unique<ChecksumSink, std::string>,
+                [] { return std::vector<std::string>{"checksum"}; }},
 };
 
 const SinkDetails& GetSinkDetails(std::string_view sink_id) {
@@ -6,15 +6,18 @@
 #include <cmath>
 #include <cstddef>
 #include <memory>
+#include <vector>
 #include <SoundTouch.h>
 #include "audio_core/audio_types.h"
 #include "audio_core/time_stretch.h"
+#include "common/assert.h"
 #include "common/logging/log.h"
 
 namespace AudioCore {
 
 TimeStretcher::TimeStretcher()
-    : sample_rate(native_sample_rate), sound_touch(std::make_unique<soundtouch::SoundTouch>()) {
+    : sample_rate(native_sample_rate), output_sample_rate(native_sample_rate),
+      sound_touch(std::make_unique<soundtouch::SoundTouch>()) {
     sound_touch->setChannels(2);
     sound_touch->setSampleRate(native_sample_rate);
     sound_touch->setPitch(1.0);
@@ -25,15 +28,49 @@ TimeStretcher::~TimeStretcher() = default;
 
 void TimeStretcher::SetOutputSampleRate(unsigned int sample_rate) {
     sound_touch->setSampleRate(sample_rate);
+    output_sample_rate = sample_rate;
     sample_rate = native_sample_rate;
 }
 
+void TimeStretcher::Prime(std::size_t max_input_frames) {
+    ASSERT(max_input_frames > 0);
+
+    // Besides the input of a call, SoundTouch keeps less than a second of input until it has a
+    // whole processing window, its length depends on the tempo
+    const std::size_t max_pending_frames = max_input_frames + output_sample_rate;
+    // Process only stops pushing input once the backlog is four times its maximum, the input it
+    // pushes before that is stretched at most by the lowest ratio. At that ratio the windows are
+    // much shorter than a second.
+    const auto max_backlog_frames =
+        static_cast<std::size_t>(4.0 * 2.0 * MAX_TARGET_LATENCY * sample_rate);
+    const auto max_output_frames =
+        max_backlog_frames + static_cast<std::size_t>((max_input_frames + output_sample_rate / 4) /
+                                                      MIN_STRETCH_RATIO);
+
+    std::vector<s16> silence(2 * max_pending_frames);
+
+    // The highest ratio needs the longest input to fill a window
+    sound_touch->setTempo(MAX_STRETCH_RATIO);
+    sound_touch->putSamples(silence.data(), static_cast<u32>(max_pending_frames));
+    sound_touch->clear();
+
+    // The lowest ratio produces the most output per input frame
+    sound_touch->setTempo(MIN_STRETCH_RATIO);
+    while (sound_touch->numSamples() < max_output_frames) {
+        sound_touch->putSamples(silence.data(), static_cast<u32>(max_input_frames));
+    }
+
+    // Clearing keeps the capacity of the buffers
+    sound_touch->clear();
+    sound_touch->setTempo(stretch_ratio);
+}
+
 std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
                                    std::size_t num_out) {
     const double time_delta = static_cast<double>(num_out) / sample_rate; // seconds
     double current_ratio = static_cast<double>(num_in) / static_cast<double>(num_out);
 
-    const double max_latency = 0.25; // seconds
+    const double max_latency = 2.0 * target_latency; // seconds
     const double max_backlog = sample_rate * max_latency;
     const double backlog_fullness = sound_touch->numSamples() / max_backlog;
     if (backlog_fullness > 4.0) {
@@ -56,7 +93,8 @@ std::size_t TimeStretcher::Process(const s16* in, std::size_t num_in, s16* out,
 
     // Place a lower limit of 5% speed.  When a game boots up, there will be
     // many silence samples.  These do not need to be timestretched.
-    stretch_ratio = std::max(stretch_ratio, 0.05);
+    // The upper limit bounds the buffers Prime allocates.
+    stretch_ratio = std::clamp(stretch_ratio, MIN_STRETCH_RATIO, MAX_STRETCH_RATIO);
     sound_touch->setTempo(stretch_ratio);
 
     LOG_TRACE(Audio, "{:5}/{:5} ratio:{:0.6f} backlog:{:0.6f}", num_in, num_out, stretch_ratio,
@@ -74,4 +112,12 @@ void TimeStretcher::Flush() {
     sound_touch->flush();
 }
 
+void TimeStretcher::SetTargetLatency(double latency) {
+    target_latency = std::min(latency, MAX_TARGET_LATENCY);
+}
+
+std::size_t TimeStretcher::GetBacklog() const {
+    return sound_touch->numSamples();
+}
+
 } // namespace AudioCore
@@ -22,6 +22,14 @@ public:
 
     void SetOutputSampleRate(unsigned int sample_rate);
 
+    /**
+     * Grows the buffers of the stretcher to the largest size Process can need, at any stretch
+     * ratio and target latency, so that Process does not allocate memory afterwards. Discards the
+     * contents of the stretcher.
+     * @param max_input_frames Largest number of input frames passed to Process in one call
+     */
+    void Prime(std::size_t max_input_frames);
+
     /// @param in       Input sample buffer
     /// @param num_in   Number of input frames in `in`
     /// @param out      Output sample buffer
@@ -33,10 +41,30 @@ public:
 
     void Flush();
 
+    /// Sets the duration of the audio to keep in the backlog of the stretcher, in seconds.
+    void SetTargetLatency(double latency);
+
+    /// Returns the number of frames in the backlog of the stretcher.
+    std::size_t GetBacklog() const;
+
+    /// Returns the current tempo of the stretcher.
+    double GetStretchRatio() const {
+        return stretch_ratio;
+    }
+
 private:
+    /// Bounds of the stretch ratio, the lower one lets the silence at boot go through quickly
+    static constexpr double MIN_STRETCH_RATIO = 0.05;
+    static constexpr double MAX_STRETCH_RATIO = 16.0;
+    /// Largest target latency of the backlog, in seconds
+    static constexpr double MAX_TARGET_LATENCY = 0.5;
+
     unsigned int sample_rate;
+    /// Sample rate SoundTouch sizes its processing windows for
+    unsigned int output_sample_rate;
     std::unique_ptr<soundtouch::SoundTouch> sound_touch;
     double stretch_ratio = 1.0;
+    double target_latency = 0.125; // seconds
 };
 
 } // namespace AudioCore
@@ -101,6 +101,7 @@ void Config::ReadValues() {
 
     // Core
     Settings::values.use_cpu_jit = sdl2_config->GetBoolean("Core", "use_cpu_jit", true);
+    Settings::values.skip_idle_loops = sdl2_config->GetBoolean("Core", "skip_idle_loops", false);
 
     // Renderer
     Settings::values.use_hw_renderer = sdl2_config->GetBoolean("Renderer", "use_hw_renderer", true);
@@ -158,12 +159,25 @@ void Config::ReadValues() {
     Settings::values.sink_id = sdl2_config->GetString("Audio", "output_engine", "auto");
     Settings::values.enable_audio_stretching =
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
+    Settings::values.enable_dsp_thread =
+        sdl2_config->GetBoolean("Audio", "enable_dsp_thread", false);
+    Settings::values.audio_latency =
+        static_cast<u16>(sdl2_config->GetInteger("Audio", "audio_latency", 100));
+    Settings::values.enable_low_latency_audio =
+        sdl2_config->GetBoolean("Audio", "enable_low_latency_audio", false);
+    Settings::values.enable_polyphase_interpolation =
+        sdl2_config->GetBoolean("Audio", "enable_polyphase_interpolation", false);
     Settings::values.audio_device_id = sdl2_config->GetString("Audio", "output_device", "auto");
     Settings::values.volume = sdl2_config->GetReal("Audio", "volume", 1);
+    Settings::values.dsp_trace_path = sdl2_config->GetString("Audio", "dsp_trace_path", "");
 
     // Data Storage
     Settings::values.use_virtual_sd =
         sdl2_config->GetBoolean("Data Storage", "use_virtual_sd", true);
+    Settings::values.romfs_cache_size =
+        static_cast<u16>(sdl2_config->GetInteger("Data Storage", "romfs_cache_size", 16));
+    Settings::values.cache_decrypted_content =
+        sdl2_config->GetBoolean("Data Storage", "cache_decrypted_content", false);
 
     // System
     Settings::values.is_new_3ds = sdl2_config->GetBoolean("System", "is_new_3ds", false);
@@ -220,6 +234,8 @@ void Config::ReadValues() {
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
+    Settings::values.record_hle_call_stats =
+        sdl2_config->GetBoolean("Debugging", "record_hle_call_stats", false);
 
     for (const auto& service_module : Service::service_module_map) {
         bool use_lle = sdl2_config->GetBoolean("Debugging", "LLE\\" + service_module.name, false);
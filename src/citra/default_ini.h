@@ -89,6 +89,11 @@ udp_pad_index=
 # 0: Interpreter (slow), 1 (default): JIT (fast)
 use_cpu_jit =
 
+# Whether to skip ahead to the next scheduled event when a thread spins in an idle loop. This
+# changes the timing of the emulated system.
+# 0 (default): No, 1: Yes
+skip_idle_loops =
+
 [Renderer]
 # Whether to use software or hardware rendering.
 # 0: Software, 1 (default): Hardware
@@ -168,7 +173,10 @@ swap_screen =
 
 [Audio]
 # Which audio output engine to use.
-# auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available)
+# auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available),
+# file: Capture to the file given as output_device (.wav, or raw samples for other extensions),
+# checksum: Log a checksum of the audio output on exit
+# null, file and checksum do not run in real time, the audio is processed as fast as it is emulated
 output_engine =
 
 # Whether or not to enable the audio-stretching post-processing effect.
@@ -177,19 +185,55 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
+# Whether or not to generate the audio on a separate thread.
+# This removes the audio processing from the emulation thread on multi-core hosts. The application
+# sees the results of the audio processing one audio frame (about 5 ms) later.
+# 0 (default): No, 1: Yes
+enable_dsp_thread =
+
+# Audio latency to target, in milliseconds.
+# It is raised automatically when the audio output needs more to play without gaps.
+# Default: 100
+audio_latency =
+
+# Whether or not to target the lowest audio latency the audio output can play without gaps,
+# instead of audio_latency. This keeps less audio buffered and drops samples more readily.
+# 0 (default): No, 1: Yes
+enable_low_latency_audio =
+
+# Whether or not to resample the audio sources configured for polyphase interpolation with a
+# windowed sinc filter. When disabled, they use linear interpolation.
+# 0 (default): No, 1: Yes
+enable_polyphase_interpolation =
+
 # Which audio device to use.
-# auto (default): Auto-select
+# auto (default): Auto-select, or the path of the capture for the file output engine
 output_device =
 
 # Output volume.
 # 1.0 (default): 100%, 0.0; mute
 volume =
 
+# Path of a file to record the inputs of the audio processing to, for benchmarking and debugging.
+# The recording can be replayed without the rest of the emulator by the audio benchmark.
+# Empty (default): No recording
+dsp_trace_path =
+
 [Data Storage]
 # Whether to create a virtual SD card.
 # 1 (default): Yes, 0: No
 use_virtual_sd =
 
+# Size in MiB of the cache of decrypted RomFS blocks, used for each opened RomFS.
+# 0: Disabled, 16 (default)
+romfs_cache_size =
+
+# Whether to keep decrypted copies of the ExeFS and RomFS of encrypted games in the cache
+# directory, so that they don't need to be decrypted again the next time they are loaded.
+# Decrypted RomFS copies take as much disk space as the games themselves.
+# 0 (default): No, 1: Yes
+cache_decrypted_content =
+
 [System]
 # The system model that Citra will try to emulate
 # 0: Old 3DS (default), 1: New 3DS
@@ -239,6 +283,9 @@ log_filter = *:Info
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
+# Record call counts and host time of HLE service commands and SVCs, dumped to
+# log/hle_call_stats.json on shutdown. 0 (default): Off, 1: On
+record_hle_call_stats =
 # To LLE a service module add "LLE\<module name>=true"
 
 [WebService]
@@ -87,6 +87,7 @@ void Config::ReadValues() {
 
     qt_config->beginGroup("Core");
     Settings::values.use_cpu_jit = ReadSetting("use_cpu_jit", true).toBool();
+    Settings::values.skip_idle_loops = ReadSetting("skip_idle_loops", false).toBool();
     qt_config->endGroup();
 
     qt_config->beginGroup("Renderer");
@@ -134,9 +135,16 @@ void Config::ReadValues() {
     Settings::values.sink_id = ReadSetting("output_engine", "auto").toString().toStdString();
     Settings::values.enable_audio_stretching =
         ReadSetting("enable_audio_stretching", true).toBool();
+    Settings::values.enable_dsp_thread = ReadSetting("enable_dsp_thread", false).toBool();
+    Settings::values.audio_latency = static_cast<u16>(ReadSetting("audio_latency", 100).toInt());
+    Settings::values.enable_low_latency_audio =
+        ReadSetting("enable_low_latency_audio", false).toBool();
+    Settings::values.enable_polyphase_interpolation =
+        ReadSetting("enable_polyphase_interpolation", false).toBool();
     Settings::values.audio_device_id =
         ReadSetting("output_device", "auto").toString().toStdString();
     Settings::values.volume = ReadSetting("volume", 1).toFloat();
+    Settings::values.dsp_trace_path = ReadSetting("dsp_trace_path", "").toString().toStdString();
     qt_config->endGroup();
 
     using namespace Service::CAM;
@@ -162,6 +170,9 @@ void Config::ReadValues() {
 
     qt_config->beginGroup("Data Storage");
     Settings::values.use_virtual_sd = ReadSetting("use_virtual_sd", true).toBool();
+    Settings::values.romfs_cache_size = ReadSetting("romfs_cache_size", 16).toInt();
+    Settings::values.cache_decrypted_content =
+        ReadSetting("cache_decrypted_content", false).toBool();
     qt_config->endGroup();
 
     qt_config->beginGroup("System");
@@ -180,6 +191,7 @@ void Config::ReadValues() {
     qt_config->beginGroup("Debugging");
     Settings::values.use_gdbstub = ReadSetting("use_gdbstub", false).toBool();
     Settings::values.gdbstub_port = ReadSetting("gdbstub_port", 24689).toInt();
+    Settings::values.record_hle_call_stats = ReadSetting("record_hle_call_stats", false).toBool();
 
     qt_config->beginGroup("LLE");
     for (const auto& service_module : Service::service_module_map) {
@@ -355,6 +367,7 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Core");
     WriteSetting("use_cpu_jit", Settings::values.use_cpu_jit, true);
+    WriteSetting("skip_idle_loops", Settings::values.skip_idle_loops, false);
     qt_config->endGroup();
 
     qt_config->beginGroup("Renderer");
@@ -393,8 +406,14 @@ void Config::SaveValues() {
     qt_config->beginGroup("Audio");
     WriteSetting("output_engine", QString::fromStdString(Settings::values.sink_id), "auto");
     WriteSetting("enable_audio_stretching", Settings::values.enable_audio_stretching, true);
+    WriteSetting("enable_dsp_thread", Settings::values.enable_dsp_thread, false);
+    WriteSetting("audio_latency", Settings::values.audio_latency, 100);
+    WriteSetting("enable_low_latency_audio", Settings::values.enable_low_latency_audio, false);
+    WriteSetting("enable_polyphase_interpolation",
+                 Settings::values.enable_polyphase_interpolation, false);
     WriteSetting("output_device", QString::fromStdString(Settings::values.audio_device_id), "auto");
     WriteSetting("volume", Settings::values.volume, 1.0f);
+    WriteSetting("dsp_trace_path", QString::fromStdString(Settings::values.dsp_trace_path), "");
     qt_config->endGroup();
 
     using namespace Service::CAM;
@@ -418,6 +437,8 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Data Storage");
     WriteSetting("use_virtual_sd", Settings::values.use_virtual_sd, true);
+    WriteSetting("romfs_cache_size", Settings::values.romfs_cache_size, 16);
+    WriteSetting("cache_decrypted_content", Settings::values.cache_decrypted_content, false);
     qt_config->endGroup();
 
     qt_config->beginGroup("System");
@@ -436,6 +457,7 @@ void Config::SaveValues() {
     qt_config->beginGroup("Debugging");
     WriteSetting("use_gdbstub", Settings::values.use_gdbstub, false);
     WriteSetting("gdbstub_port", Settings::values.gdbstub_port, 24689);
+    WriteSetting("record_hle_call_stats", Settings::values.record_hle_call_stats, false);
 
     qt_config->beginGroup("LLE");
     for (const auto& service_module : Settings::values.lle_modules) {
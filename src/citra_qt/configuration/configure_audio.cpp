@@ -6,6 +6,7 @@
 #include "audio_core/sink.h"
 #include "audio_core/sink_details.h"
 #include "citra_qt/configuration/configure_audio.h"
+#include "core/core.h"
 #include "core/settings.h"
 #include "ui_configure_audio.h"
 
@@ -21,6 +22,8 @@ ConfigureAudio::ConfigureAudio(QWidget* parent)
 
     connect(ui->volume_slider, &QSlider::valueChanged, this,
             &ConfigureAudio::setVolumeIndicatorText);
+    connect(ui->toggle_low_latency_audio, &QCheckBox::toggled, this,
+            [this](bool checked) { ui->audio_latency_spinbox->setEnabled(!checked); });
 
     this->setConfiguration();
     connect(ui->output_sink_combo_box,
@@ -39,6 +42,11 @@ void ConfigureAudio::setConfiguration() {
     setAudioDeviceFromDeviceID();
 
     ui->toggle_audio_stretching->setChecked(Settings::values.enable_audio_stretching);
+    ui->toggle_dsp_thread->setChecked(Settings::values.enable_dsp_thread);
+    ui->toggle_dsp_thread->setEnabled(!Core::System::GetInstance().IsPoweredOn());
+    ui->audio_latency_spinbox->setValue(Settings::values.audio_latency);
+    ui->toggle_low_latency_audio->setChecked(Settings::values.enable_low_latency_audio);
+    ui->audio_latency_spinbox->setEnabled(!Settings::values.enable_low_latency_audio);
     ui->volume_slider->setValue(Settings::values.volume * ui->volume_slider->maximum());
     setVolumeIndicatorText(ui->volume_slider->sliderPosition());
 }
@@ -80,6 +88,9 @@ void ConfigureAudio::applyConfiguration() {
         ui->output_sink_combo_box->itemText(ui->output_sink_combo_box->currentIndex())
             .toStdString();
     Settings::values.enable_audio_stretching = ui->toggle_audio_stretching->isChecked();
+    Settings::values.enable_dsp_thread = ui->toggle_dsp_thread->isChecked();
+    Settings::values.audio_latency = static_cast<u16>(ui->audio_latency_spinbox->value());
+    Settings::values.enable_low_latency_audio = ui->toggle_low_latency_audio->isChecked();
     Settings::values.audio_device_id =
         ui->audio_device_combo_box->itemText(ui->audio_device_combo_box->currentIndex())
             .toStdString();
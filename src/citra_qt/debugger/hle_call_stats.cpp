@@ -0,0 +1,146 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include "citra_qt/debugger/hle_call_stats.h"
+#include "core/core.h"
+#include "core/hle/call_profiler.h"
+#include "core/settings.h"
+
+namespace {
+
+enum Column {
+    COLUMN_NAME,
+    COLUMN_CALLS,
+    COLUMN_TOTAL,
+    COLUMN_MEAN,
+    COLUMN_P99,
+    COLUMN_MAX,
+    COLUMN_COUNT,
+};
+
+constexpr int REFRESH_INTERVAL_MS = 1000;
+
+/// Tree item that sorts numerically on the statistics columns.
+class CallStatsItem : public QTreeWidgetItem {
+public:
+    using QTreeWidgetItem::QTreeWidgetItem;
+
+    bool operator<(const QTreeWidgetItem& other) const override {
+        const int column = treeWidget()->sortColumn();
+        if (column == COLUMN_NAME) {
+            return QTreeWidgetItem::operator<(other);
+        }
+        return data(column, Qt::UserRole).toULongLong() <
+               other.data(column, Qt::UserRole).toULongLong();
+    }
+};
+
+void SetStats(QTreeWidgetItem* item, const QString& name,
+              const HLE::CallProfiler::CallStats& stats) {
+    const auto set_time = [item](int column, u64 ns) {
+        item->setText(column, QString::number(ns / 1000.0, 'f', 1));
+        item->setData(column, Qt::UserRole, static_cast<qulonglong>(ns));
+    };
+
+    item->setText(COLUMN_NAME, name);
+    item->setText(COLUMN_CALLS, QString::number(stats.count));
+    item->setData(COLUMN_CALLS, Qt::UserRole, static_cast<qulonglong>(stats.count));
+    set_time(COLUMN_TOTAL, stats.total_ns);
+    set_time(COLUMN_MEAN, stats.count == 0 ? 0 : stats.total_ns / stats.count);
+    set_time(COLUMN_P99, stats.EstimatePercentileNs(0.99));
+    set_time(COLUMN_MAX, stats.max_ns);
+}
+
+} // Anonymous namespace
+
+HLECallStatsWidget::HLECallStatsWidget(QWidget* parent)
+    : QDockWidget(tr("HLE Call Statistics"), parent) {
+    setObjectName("HLECallStatsWidget");
+
+    record_checkbox = new QCheckBox(tr("Record"));
+    record_checkbox->setChecked(Settings::values.record_hle_call_stats);
+    connect(record_checkbox, &QCheckBox::toggled, this, &HLECallStatsWidget::OnRecordToggled);
+
+    QPushButton* reset_button = new QPushButton(tr("Reset"));
+    connect(reset_button, &QPushButton::clicked, this, &HLECallStatsWidget::OnReset);
+
+    QHBoxLayout* controls_layout = new QHBoxLayout;
+    controls_layout->addWidget(record_checkbox);
+    controls_layout->addStretch();
+    controls_layout->addWidget(reset_button);
+
+    tree = new QTreeWidget;
+    tree->setColumnCount(COLUMN_COUNT);
+    tree->setHeaderLabels({tr("Name"), tr("Calls"), tr("Total (us)"), tr("Mean (us)"),
+                           tr("p99 (us)"), tr("Max (us)")});
+    tree->header()->setSectionResizeMode(COLUMN_NAME, QHeaderView::Stretch);
+    tree->setSortingEnabled(true);
+    tree->sortByColumn(COLUMN_TOTAL, Qt::DescendingOrder);
+
+    services_item = new QTreeWidgetItem(tree, {tr("Services")});
+    svcs_item = new QTreeWidgetItem(tree, {tr("SVCs")});
+    services_item->setExpanded(true);
+    svcs_item->setExpanded(true);
+
+    QVBoxLayout* main_layout = new QVBoxLayout;
+    main_layout->addLayout(controls_layout);
+    main_layout->addWidget(tree);
+
+    QWidget* main_widget = new QWidget;
+    main_widget->setLayout(main_layout);
+    setWidget(main_widget);
+
+    update_timer.setInterval(REFRESH_INTERVAL_MS);
+    connect(&update_timer, &QTimer::timeout, this, &HLECallStatsWidget::Refresh);
+}
+
+HLECallStatsWidget::~HLECallStatsWidget() = default;
+
+void HLECallStatsWidget::showEvent(QShowEvent* ev) {
+    Refresh();
+    update_timer.start();
+    QDockWidget::showEvent(ev);
+}
+
+void HLECallStatsWidget::hideEvent(QHideEvent* ev) {
+    update_timer.stop();
+    QDockWidget::hideEvent(ev);
+}
+
+void HLECallStatsWidget::Refresh() {
+    const auto& call_profiler = Core::System::GetInstance().call_profiler;
+
+    qDeleteAll(services_item->takeChildren());
+    for (const auto& call : call_profiler.GetServiceCallStats()) {
+        const QString name = QStringLiteral("%1::%2 (0x%3)")
+                                 .arg(QString::fromStdString(call.service_name),
+                                      QString::fromStdString(call.function_name))
+                                 .arg(call.command_id, 4, 16, QLatin1Char('0'));
+        SetStats(new CallStatsItem(services_item), name, call.stats);
+    }
+
+    qDeleteAll(svcs_item->takeChildren());
+    for (const auto& call : call_profiler.GetSVCCallStats()) {
+        const QString name = QStringLiteral("%1 (0x%2)")
+                                 .arg(QString::fromStdString(call.svc_name))
+                                 .arg(call.svc_id, 2, 16, QLatin1Char('0'));
+        SetStats(new CallStatsItem(svcs_item), name, call.stats);
+    }
+}
+
+void HLECallStatsWidget::OnRecordToggled(bool checked) {
+    Settings::values.record_hle_call_stats = checked;
+    Core::System::GetInstance().call_profiler.SetEnabled(checked);
+}
+
+void HLECallStatsWidget::OnReset() {
+    Core::System::GetInstance().call_profiler.Reset();
+    Refresh();
+}
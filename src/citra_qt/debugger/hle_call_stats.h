@@ -0,0 +1,40 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <QDockWidget>
+#include <QTimer>
+
+class QCheckBox;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/// Shows the call counts and host time of HLE service commands and SVCs, as recorded by
+/// HLE::CallProfiler.
+class HLECallStatsWidget : public QDockWidget {
+    Q_OBJECT
+
+public:
+    explicit HLECallStatsWidget(QWidget* parent = nullptr);
+    ~HLECallStatsWidget();
+
+protected:
+    void showEvent(QShowEvent* ev) override;
+    void hideEvent(QHideEvent* ev) override;
+
+private:
+    void Refresh();
+    void OnRecordToggled(bool checked);
+    void OnReset();
+
+    QCheckBox* record_checkbox;
+    QTreeWidget* tree;
+    QTreeWidgetItem* services_item;
+    QTreeWidgetItem* svcs_item;
+
+    /// Refreshes the statistics periodically. To save resources, it only runs while the widget is
+    /// visible.
+    QTimer update_timer;
+};
@@ -645,13 +645,8 @@ void GameList::LoadInterfaceLayout() {
     item_model->sort(header->sortIndicatorSection(), header->sortIndicatorOrder());
 }
 
-const QStringList GameList::supported_file_extensions = {"3ds", "3dsx", "elf", "axf",
-                                                         "cci", "cxi",  "app"};
-
-static bool HasSupportedFileExtension(const std::string& file_name) {
-    QFileInfo file = QFileInfo(QString::fromStdString(file_name));
-    return GameList::supported_file_extensions.contains(file.suffix(), Qt::CaseInsensitive);
-}
+const QStringList GameList::supported_file_extensions = {"3ds", "3dsx", "elf",  "axf", "cci",
+                                                         "cxi", "app",  "zcci", "zcxi"};
 
 void GameList::RefreshGameDirectory() {
     if (!UISettings::values.game_dirs.isEmpty() && current_worker != nullptr) {
@@ -678,88 +673,57 @@ QString GameList::FindGameByProgramID(QStandardItem* current_item, u64 program_i
     return "";
 }
 
-void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
-                                             GameListDir* parent_dir) {
-    const auto callback = [this, recursion, parent_dir](u64* num_entries_out,
-                                                        const std::string& directory,
-                                                        const std::string& virtual_name) -> bool {
-        std::string physical_name = directory + DIR_SEP + virtual_name;
-
-        if (stop_processing)
-            return false; // Breaks the callback loop.
-
-        bool is_dir = FileUtil::IsDirectory(physical_name);
-        if (!is_dir && HasSupportedFileExtension(physical_name)) {
-            std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(physical_name);
-            if (!loader)
-                return true;
-
-            u64 program_id = 0;
-            loader->ReadProgramId(program_id);
-
-            u64 extdata_id = 0;
-            loader->ReadExtdataId(extdata_id);
-
-            std::vector<u8> smdh = [program_id, &loader]() -> std::vector<u8> {
-                std::vector<u8> original_smdh;
-                loader->ReadIcon(original_smdh);
-
-                if (program_id < 0x0004000000000000 || program_id > 0x00040000FFFFFFFF)
-                    return original_smdh;
-
-                std::string update_path = Service::AM::GetTitleContentPath(
-                    Service::FS::MediaType::SDMC, program_id + 0x0000000E00000000);
-
-                if (!FileUtil::Exists(update_path))
-                    return original_smdh;
-
-                std::unique_ptr<Loader::AppLoader> update_loader = Loader::GetLoader(update_path);
-
-                if (!update_loader)
-                    return original_smdh;
+static std::vector<std::string> GetScannedExtensions() {
+    std::vector<std::string> extensions;
+    for (const QString& extension : GameList::supported_file_extensions) {
+        extensions.push_back(extension.toLower().toStdString());
+    }
+    return extensions;
+}
 
-                std::vector<u8> update_smdh;
-                update_loader->ReadIcon(update_smdh);
-                return update_smdh;
-            }();
+GameListWorker::GameListWorker(
+    QList<UISettings::GameDir>& game_dirs,
+    const std::unordered_map<std::string, std::pair<QString, QString>>& compatibility_list)
+    : game_dirs(game_dirs), compatibility_list(compatibility_list),
+      scanner(GetScannedExtensions(), FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) +
+                                          "game_list" DIR_SEP "metadata.bin") {}
 
-            if (!Loader::IsValidSMDH(smdh) && UISettings::values.game_list_hide_no_icon) {
-                // Skip this invalid entry
-                return true;
-            }
+void GameListWorker::AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
+                                             GameListDir* parent_dir) {
+    const auto directory_callback = [this](const std::string& path) {
+        watch_list.append(QString::fromStdString(path));
+    };
 
-            auto it = FindMatchingCompatibilityEntry(compatibility_list, program_id);
-
-            // The game list uses this as compatibility number for untested games
-            QString compatibility("99");
-            if (it != compatibility_list.end())
-                compatibility = it->second.first;
-
-            emit EntryReady(
-                {
-                    new GameListItemPath(QString::fromStdString(physical_name), smdh, program_id,
-                                         extdata_id),
-                    new GameListItemCompat(compatibility),
-                    new GameListItemRegion(smdh),
-                    new GameListItem(
-                        QString::fromStdString(Loader::GetFileTypeString(loader->GetFileType()))),
-                    new GameListItemSize(FileUtil::GetSize(physical_name)),
-                },
-                parent_dir);
-
-        } else if (is_dir && recursion > 0) {
-            watch_list.append(QString::fromStdString(physical_name));
-            AddFstEntriesToGameList(physical_name, recursion - 1, parent_dir);
+    const auto game_callback = [this, parent_dir](const Core::GameEntry& entry) {
+        if (!Loader::IsValidSMDH(entry.smdh) && UISettings::values.game_list_hide_no_icon) {
+            // Skip this invalid entry
+            return;
         }
 
-        return true;
+        auto it = FindMatchingCompatibilityEntry(compatibility_list, entry.program_id);
+
+        // The game list uses this as compatibility number for untested games
+        QString compatibility("99");
+        if (it != compatibility_list.end())
+            compatibility = it->second.first;
+
+        emit EntryReady(
+            {
+                new GameListItemPath(QString::fromStdString(entry.path), entry.smdh,
+                                     entry.program_id, entry.extdata_id),
+                new GameListItemCompat(compatibility),
+                new GameListItemRegion(entry.smdh),
+                new GameListItem(
+                    QString::fromStdString(Loader::GetFileTypeString(entry.file_type))),
+                new GameListItemSize(entry.size),
+            },
+            parent_dir);
     };
 
-    FileUtil::ForeachDirectoryEntry(nullptr, dir_path, callback);
+    scanner.ScanDirectory(dir_path, recursion, directory_callback, game_callback);
 }
 
 void GameListWorker::run() {
-    stop_processing = false;
     for (UISettings::GameDir& game_dir : game_dirs) {
         if (game_dir.path == "INSTALLED") {
             QString path =
@@ -787,12 +751,13 @@ void GameListWorker::run() {
                                     game_list_dir);
         }
     };
+    scanner.SaveCache();
     emit Finished(watch_list);
 }
 
 void GameListWorker::Cancel() {
     this->disconnect();
-    stop_processing = true;
+    scanner.Cancel();
 }
 
 GameListPlaceholder::GameListPlaceholder(GMainWindow* parent) : QWidget{parent} {
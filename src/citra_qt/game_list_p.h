@@ -21,6 +21,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "core/game_scanner.h"
 #include "core/loader/smdh.h"
 
 enum class GameListItemType {
@@ -383,8 +384,7 @@ class GameListWorker : public QObject, public QRunnable {
 public:
     explicit GameListWorker(
         QList<UISettings::GameDir>& game_dirs,
-        const std::unordered_map<std::string, std::pair<QString, QString>>& compatibility_list)
-        : game_dirs(game_dirs), compatibility_list(compatibility_list) {}
+        const std::unordered_map<std::string, std::pair<QString, QString>>& compatibility_list);
 
 public slots:
     /// Starts the processing of directory tree information.
@@ -412,7 +412,7 @@ private:
     QStringList watch_list;
     const std::unordered_map<std::string, std::pair<QString, QString>>& compatibility_list;
     QList<UISettings::GameDir>& game_dirs;
-    std::atomic_bool stop_processing;
+    Core::GameScanner scanner;
 
     void AddFstEntriesToGameList(const std::string& dir_path, unsigned int recursion,
                                  GameListDir* parent_dir);
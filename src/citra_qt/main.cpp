@@ -30,6 +30,7 @@
 #include "citra_qt/debugger/graphics/graphics_surface.h"
 #include "citra_qt/debugger/graphics/graphics_tracing.h"
 #include "citra_qt/debugger/graphics/graphics_vertex_shader.h"
+#include "citra_qt/debugger/hle_call_stats.h"
 #include "citra_qt/debugger/lle_service_modules.h"
 #include "citra_qt/debugger/profiler.h"
 #include "citra_qt/debugger/registers.h"
@@ -306,6 +307,11 @@ void GMainWindow::InitializeDebugWidgets() {
     connect(this, &GMainWindow::EmulationStopping, waitTreeWidget,
             &WaitTreeWidget::OnEmulationStopping);
 
+    hleCallStatsWidget = new HLECallStatsWidget(this);
+    addDockWidget(Qt::RightDockWidgetArea, hleCallStatsWidget);
+    hleCallStatsWidget->hide();
+    debug_menu->addAction(hleCallStatsWidget->toggleViewAction());
+
     lleServiceModulesWidget = new LLEServiceModulesWidget(this);
     addDockWidget(Qt::RightDockWidgetArea, lleServiceModulesWidget);
     lleServiceModulesWidget->hide();
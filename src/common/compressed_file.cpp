@@ -0,0 +1,328 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <thread>
+#include "common/compressed_file.h"
+#include "common/compression.h"
+#include "common/logging/log.h"
+
+namespace FileUtil {
+
+bool CompressedFile::IsCompressedFile(IOFile& file) {
+    std::array<char, 4> magic;
+    return file.GetSize() >= sizeof(CompressedROM::Header) &&
+           file.ReadBytesAt(magic.data(), magic.size(), 0) == magic.size() &&
+           magic == CompressedROM::MAGIC;
+}
+
+CompressedFile::CompressedFile(IOFile&& file_, std::size_t cache_size) : file(std::move(file_)) {
+    CompressedROM::Header header;
+    if (file.ReadBytesAt(&header, sizeof(header), 0) != sizeof(header) ||
+        header.magic != CompressedROM::MAGIC) {
+        LOG_ERROR(Common_Filesystem, "File is not a compressed ROM");
+        file.Close();
+        return;
+    }
+
+    const u64 num_blocks = header.num_blocks;
+    if (header.version != CompressedROM::VERSION || header.block_size == 0 ||
+        num_blocks != (header.uncompressed_size + header.block_size - 1) / header.block_size) {
+        LOG_ERROR(Common_Filesystem, "Unsupported or invalid compressed ROM header (version {})",
+                  static_cast<u32>(header.version));
+        file.Close();
+        return;
+    }
+
+    std::vector<u64_le> index(num_blocks + 1);
+    const std::size_t index_size = index.size() * sizeof(u64_le);
+    if (file.ReadBytesAt(index.data(), index_size, sizeof(header)) != index_size) {
+        LOG_ERROR(Common_Filesystem, "Could not read the compressed ROM index");
+        file.Close();
+        return;
+    }
+
+    block_offsets.assign(index.begin(), index.end());
+    for (std::size_t i = 0; i < num_blocks; ++i) {
+        if (block_offsets[i] > block_offsets[i + 1] ||
+            block_offsets[i + 1] - block_offsets[i] > header.block_size) {
+            LOG_ERROR(Common_Filesystem, "Invalid compressed ROM index entry {}", i);
+            file.Close();
+            return;
+        }
+    }
+
+    uncompressed_size = header.uncompressed_size;
+    block_size = header.block_size;
+    max_cached_blocks = std::max<std::size_t>(cache_size / block_size, 1);
+}
+
+std::size_t CompressedFile::ReadBytesAt(void* data, std::size_t length, u64 offset) {
+    if (!IsOpen() || offset >= uncompressed_size)
+        return 0;
+    length = static_cast<std::size_t>(std::min<u64>(length, uncompressed_size - offset));
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    u8* const out = static_cast<u8*>(data);
+    std::size_t read_length = 0;
+    while (read_length < length) {
+        const u64 position = offset + read_length;
+        const CachedBlock* block = GetBlock(static_cast<std::size_t>(position / block_size));
+        if (block == nullptr)
+            break;
+
+        const std::size_t block_offset = static_cast<std::size_t>(position % block_size);
+        const std::size_t copy_length =
+            std::min(length - read_length, block->data.size() - block_offset);
+        std::memcpy(out + read_length, block->data.data() + block_offset, copy_length);
+        read_length += copy_length;
+    }
+    return read_length;
+}
+
+CompressedFile::CacheStats CompressedFile::GetCacheStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+const CompressedFile::CachedBlock* CompressedFile::GetBlock(std::size_t index) {
+    auto itr = block_map.find(index);
+    if (itr != block_map.end()) {
+        stats.hits++;
+        cached_blocks.splice(cached_blocks.begin(), cached_blocks, itr->second);
+        return &cached_blocks.front();
+    }
+
+    stats.misses++;
+
+    // Reuse the buffer of the least recently used block if the cache is full
+    std::vector<u8> data;
+    if (cached_blocks.size() >= max_cached_blocks) {
+        data = std::move(cached_blocks.back().data);
+        block_map.erase(cached_blocks.back().index);
+        cached_blocks.pop_back();
+    }
+
+    const u64 block_start = static_cast<u64>(index) * block_size;
+    const std::size_t data_size =
+        static_cast<std::size_t>(std::min<u64>(block_size, uncompressed_size - block_start));
+    const std::size_t stored_size =
+        static_cast<std::size_t>(block_offsets[index + 1] - block_offsets[index]);
+    data.resize(data_size);
+
+    bool success;
+    if (stored_size == data_size) {
+        success = file.ReadBytesAt(data.data(), data_size, block_offsets[index]) == data_size;
+    } else {
+        compressed_buffer.resize(stored_size);
+        success = file.ReadBytesAt(compressed_buffer.data(), stored_size, block_offsets[index]) ==
+                      stored_size &&
+                  Common::Compression::DecompressLZ(compressed_buffer.data(), stored_size,
+                                                    data.data(), data_size);
+    }
+
+    if (!success) {
+        LOG_ERROR(Common_Filesystem, "Could not read compressed ROM block {}", index);
+        return nullptr;
+    }
+
+    cached_blocks.push_front({index, std::move(data)});
+    block_map[index] = cached_blocks.begin();
+    return &cached_blocks.front();
+}
+
+ROMFile::ROMFile(const std::string& path) : ROMFile(IOFile(path, "rb")) {}
+
+ROMFile::ROMFile(IOFile&& file_) {
+    if (file_.IsOpen() && CompressedFile::IsCompressedFile(file_)) {
+        compressed_file = std::make_unique<CompressedFile>(std::move(file_));
+    } else {
+        file = std::move(file_);
+    }
+}
+
+u64 ROMFile::GetSize() const {
+    return compressed_file != nullptr ? compressed_file->GetSize() : file.GetSize();
+}
+
+bool ROMFile::Seek(s64 off, int origin) {
+    if (compressed_file == nullptr)
+        return file.Seek(off, origin);
+
+    s64 new_position;
+    switch (origin) {
+    case SEEK_SET:
+        new_position = off;
+        break;
+    case SEEK_CUR:
+        new_position = static_cast<s64>(position) + off;
+        break;
+    case SEEK_END:
+        new_position = static_cast<s64>(compressed_file->GetSize()) + off;
+        break;
+    default:
+        return false;
+    }
+
+    if (new_position < 0)
+        return false;
+    position = static_cast<u64>(new_position);
+    return true;
+}
+
+u64 ROMFile::Tell() const {
+    return compressed_file != nullptr ? position : file.Tell();
+}
+
+std::size_t ROMFile::ReadBytesAt(void* data, std::size_t length, u64 offset) {
+    if (compressed_file != nullptr)
+        return compressed_file->ReadBytesAt(data, length, offset);
+    return file.ReadBytesAt(data, length, offset);
+}
+
+bool CompressROM(const std::string& source_path, const std::string& dest_path,
+                 std::size_t block_size, unsigned num_threads,
+                 const std::function<void(u64, u64)>& update_callback) {
+    IOFile source(source_path, "rb");
+    if (!source.IsOpen()) {
+        LOG_ERROR(Common_Filesystem, "Could not open {}", source_path);
+        return false;
+    }
+    if (block_size == 0 || block_size > 0xFFFFFFFF)
+        return false;
+
+    IOFile dest(dest_path, "wb");
+    if (!dest.IsOpen()) {
+        LOG_ERROR(Common_Filesystem, "Could not create {}", dest_path);
+        return false;
+    }
+
+    const u64 size = source.GetSize();
+    const u64 num_blocks = (size + block_size - 1) / block_size;
+
+    CompressedROM::Header header{};
+    header.magic = CompressedROM::MAGIC;
+    header.version = CompressedROM::VERSION;
+    header.block_size = static_cast<u32>(block_size);
+    header.uncompressed_size = size;
+    header.num_blocks = num_blocks;
+
+    // The index is written again once the block offsets are known
+    std::vector<u64_le> index(num_blocks + 1);
+    dest.WriteBytes(&header, sizeof(header));
+    dest.WriteBytes(index.data(), index.size() * sizeof(u64_le));
+
+    // Compressed blocks that are waiting to be written, by index. Workers stay at most a few
+    // blocks ahead of the writer to bound memory usage.
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::map<u64, std::vector<u8>> compressed_blocks;
+    u64 next_block = 0;
+    u64 next_write = 0;
+    bool failed = false;
+    num_threads = std::max(num_threads, 1U);
+    const u64 max_blocks_ahead = num_threads * 4;
+
+    const auto compress_blocks = [&] {
+        std::vector<u8> buffer(block_size);
+        while (true) {
+            u64 block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&] {
+                    return failed || next_block >= num_blocks ||
+                           next_block < next_write + max_blocks_ahead;
+                });
+                if (failed || next_block >= num_blocks)
+                    return;
+                block = next_block++;
+            }
+
+            const std::size_t length =
+                static_cast<std::size_t>(std::min<u64>(block_size, size - block * block_size));
+            const bool read =
+                source.ReadBytesAt(buffer.data(), length, block * block_size) == length;
+
+            std::vector<u8> result;
+            if (read) {
+                result = Common::Compression::CompressLZ(buffer.data(), length);
+                // Blocks that do not shrink are stored raw, see CompressedROM
+                if (result.size() >= length)
+                    result.assign(buffer.begin(), buffer.begin() + length);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (read) {
+                    compressed_blocks.emplace(block, std::move(result));
+                } else {
+                    LOG_ERROR(Common_Filesystem, "Could not read {}", source_path);
+                    failed = true;
+                }
+            }
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < num_threads; ++i) {
+        threads.emplace_back(compress_blocks);
+    }
+
+    u64 offset = sizeof(header) + index.size() * sizeof(u64_le);
+    for (u64 block = 0; block < num_blocks; ++block) {
+        std::vector<u8> data;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return failed || compressed_blocks.count(block) != 0; });
+            if (failed)
+                break;
+            auto itr = compressed_blocks.find(block);
+            data = std::move(itr->second);
+            compressed_blocks.erase(itr);
+            next_write = block + 1;
+        }
+        cv.notify_all();
+
+        index[block] = offset;
+        if (dest.WriteBytes(data.data(), data.size()) != data.size()) {
+            LOG_ERROR(Common_Filesystem, "Could not write to {}", dest_path);
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = true;
+            break;
+        }
+        offset += data.size();
+
+        if (update_callback)
+            update_callback(std::min<u64>((block + 1) * block_size, size), size);
+    }
+    cv.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    index[num_blocks] = offset;
+    if (!failed) {
+        failed = !dest.Seek(sizeof(header), SEEK_SET) ||
+                 dest.WriteBytes(index.data(), index.size() * sizeof(u64_le)) !=
+                     index.size() * sizeof(u64_le) ||
+                 !dest.Close();
+    }
+
+    if (failed) {
+        dest.Close();
+        Delete(dest_path);
+        return false;
+    }
+
+    LOG_INFO(Common_Filesystem, "Compressed {} from {} to {} bytes", source_path, size, offset);
+    return true;
+}
+
+} // namespace FileUtil
@@ -0,0 +1,186 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/swap.h"
+
+namespace FileUtil {
+
+/**
+ * Compressed ROM container. The data is split into fixed-size blocks that are compressed
+ * independently with Common::Compression::CompressLZ, so that any part of the data can be read
+ * without decompressing what comes before it. The file layout is:
+ *  - a Header
+ *  - the index: num_blocks + 1 little-endian u64 file offsets, block i being stored between
+ *    entries i and i + 1. Blocks whose stored size is their decompressed size are stored raw.
+ *  - the blocks
+ */
+namespace CompressedROM {
+
+constexpr std::array<char, 4> MAGIC{{'C', 'R', 'O', 'M'}};
+constexpr u32 VERSION = 1;
+constexpr std::size_t DEFAULT_BLOCK_SIZE = 0x10000;
+
+struct Header {
+    std::array<char, 4> magic;
+    u32_le version;
+    u32_le block_size;
+    u32_le reserved;
+    u64_le uncompressed_size;
+    u64_le num_blocks;
+};
+static_assert(sizeof(Header) == 0x20, "CompressedROM::Header has incorrect size");
+
+} // namespace CompressedROM
+
+/**
+ * Reads the data of a compressed ROM container. Recently read blocks are kept decompressed in a
+ * LRU cache. Reading is thread-safe.
+ */
+class CompressedFile : public NonCopyable {
+public:
+    struct CacheStats {
+        u64 hits = 0;
+        u64 misses = 0;
+    };
+
+    /// Returns whether a file is a compressed ROM container.
+    static bool IsCompressedFile(IOFile& file);
+
+    /**
+     * Opens a compressed ROM container. On failure, IsOpen() returns false.
+     * @param file The container file
+     * @param cache_size Size of the decompressed block cache, in bytes
+     */
+    explicit CompressedFile(IOFile&& file, std::size_t cache_size = 0x800000);
+
+    bool IsOpen() const {
+        return file.IsOpen();
+    }
+
+    /// Returns the size of the decompressed data.
+    u64 GetSize() const {
+        return uncompressed_size;
+    }
+
+    /**
+     * Reads decompressed data.
+     * @returns The number of bytes read, lower than length if the data ends or is corrupted
+     */
+    std::size_t ReadBytesAt(void* data, std::size_t length, u64 offset);
+
+    CacheStats GetCacheStats() const;
+
+private:
+    struct CachedBlock {
+        std::size_t index;
+        std::vector<u8> data;
+    };
+
+    /// Returns the cached block with the specified index, decompressing it first if needed.
+    /// Returns nullptr if the block could not be read.
+    const CachedBlock* GetBlock(std::size_t index);
+
+    IOFile file;
+    u64 uncompressed_size = 0;
+    std::size_t block_size = 0;
+    std::vector<u64> block_offsets;
+
+    mutable std::mutex mutex;
+    std::size_t max_cached_blocks;
+    /// Cached blocks, the most recently used first
+    std::list<CachedBlock> cached_blocks;
+    std::unordered_map<std::size_t, std::list<CachedBlock>::iterator> block_map;
+    std::vector<u8> compressed_buffer;
+    CacheStats stats;
+};
+
+/**
+ * Read-only file that transparently decompresses compressed ROM containers. It provides the part
+ * of the IOFile interface used to read ROMs, so that loaders can read both kinds of files alike.
+ */
+class ROMFile {
+public:
+    ROMFile() = default;
+
+    /// Opens a file for reading, detecting whether it is a compressed ROM container.
+    explicit ROMFile(const std::string& path);
+
+    /// Takes over a file opened for reading, detecting whether it is a compressed ROM container.
+    ROMFile(IOFile&& file);
+
+    ROMFile(ROMFile&& other) = default;
+    ROMFile& operator=(ROMFile&& other) = default;
+
+    bool IsOpen() const {
+        return compressed_file != nullptr ? compressed_file->IsOpen() : file.IsOpen();
+    }
+
+    bool IsCompressed() const {
+        return compressed_file != nullptr;
+    }
+
+    /// Returns the underlying file if it is not compressed, nullptr otherwise.
+    const IOFile* GetRawFile() const {
+        return compressed_file == nullptr ? &file : nullptr;
+    }
+
+    u64 GetSize() const;
+    bool Seek(s64 off, int origin);
+    u64 Tell() const;
+
+    template <typename T>
+    std::size_t ReadBytes(T* data, std::size_t length) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        if (compressed_file == nullptr)
+            return file.ReadBytes(data, length);
+
+        const std::size_t read_length = compressed_file->ReadBytesAt(data, length, position);
+        position += read_length;
+        return read_length;
+    }
+
+    template <typename T>
+    std::size_t ReadArray(T* data, std::size_t length) {
+        if (compressed_file == nullptr)
+            return file.ReadArray(data, length);
+        return ReadBytes(data, length * sizeof(T)) / sizeof(T);
+    }
+
+    /// Reads bytes at the specified offset without moving the file position. Thread-safe.
+    std::size_t ReadBytesAt(void* data, std::size_t length, u64 offset);
+
+private:
+    IOFile file;
+    std::unique_ptr<CompressedFile> compressed_file;
+    u64 position = 0; ///< Read position in the decompressed data
+};
+
+/**
+ * Compresses a file into a compressed ROM container. Blocks are compressed by several threads at
+ * once and written out in order.
+ * @param source_path Path of the file to compress
+ * @param dest_path Path of the compressed ROM container to create
+ * @param block_size Size of the independently compressed blocks
+ * @param num_threads Number of compression threads
+ * @param update_callback Optional callback receiving the number of bytes processed and total size
+ * @returns Whether the container was written successfully
+ */
+bool CompressROM(const std::string& source_path, const std::string& dest_path,
+                 std::size_t block_size = CompressedROM::DEFAULT_BLOCK_SIZE,
+                 unsigned num_threads = 1,
+                 const std::function<void(u64, u64)>& update_callback = nullptr);
+
+} // namespace FileUtil
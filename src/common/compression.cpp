@@ -0,0 +1,147 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "common/compression.h"
+
+namespace Common::Compression {
+
+constexpr std::size_t MIN_MATCH_LENGTH = 4;
+constexpr std::size_t MAX_MATCH_OFFSET = 0xFFFF;
+constexpr u32 HASH_BITS = 16;
+constexpr u32 LENGTH_NIBBLE_MAX = 15;
+
+static u32 HashSequence(const u8* data) {
+    u32 sequence;
+    std::memcpy(&sequence, data, sizeof(sequence));
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+static void WriteExtraLength(std::vector<u8>& out, std::size_t length) {
+    for (; length >= 0xFF; length -= 0xFF) {
+        out.push_back(0xFF);
+    }
+    out.push_back(static_cast<u8>(length));
+}
+
+static void WriteSequence(std::vector<u8>& out, const u8* literals, std::size_t literal_count,
+                          std::size_t match_offset, std::size_t match_length) {
+    const bool has_match = match_length != 0;
+    const std::size_t match_code = has_match ? match_length - MIN_MATCH_LENGTH : 0;
+
+    out.push_back(static_cast<u8>(std::min<std::size_t>(literal_count, LENGTH_NIBBLE_MAX) << 4 |
+                                  std::min<std::size_t>(match_code, LENGTH_NIBBLE_MAX)));
+    if (literal_count >= LENGTH_NIBBLE_MAX)
+        WriteExtraLength(out, literal_count - LENGTH_NIBBLE_MAX);
+    out.insert(out.end(), literals, literals + literal_count);
+
+    if (!has_match)
+        return;
+
+    out.push_back(static_cast<u8>(match_offset));
+    out.push_back(static_cast<u8>(match_offset >> 8));
+    if (match_code >= LENGTH_NIBBLE_MAX)
+        WriteExtraLength(out, match_code - LENGTH_NIBBLE_MAX);
+}
+
+std::vector<u8> CompressLZ(const u8* data, std::size_t size) {
+    std::vector<u8> out;
+    out.reserve(size + size / 0xFF + 16);
+
+    // Position + 1 of the last sequence seen with each hash, 0 meaning none
+    std::vector<std::size_t> table(std::size_t{1} << HASH_BITS, 0);
+
+    std::size_t anchor = 0;
+    std::size_t position = 0;
+    while (position + MIN_MATCH_LENGTH <= size) {
+        const u32 hash = HashSequence(data + position);
+        const std::size_t candidate = table[hash];
+        table[hash] = position + 1;
+
+        if (candidate == 0 || position - (candidate - 1) > MAX_MATCH_OFFSET ||
+            std::memcmp(data + candidate - 1, data + position, MIN_MATCH_LENGTH) != 0) {
+            ++position;
+            continue;
+        }
+
+        const std::size_t match_position = candidate - 1;
+        std::size_t match_length = MIN_MATCH_LENGTH;
+        while (position + match_length < size &&
+               data[match_position + match_length] == data[position + match_length]) {
+            ++match_length;
+        }
+
+        WriteSequence(out, data + anchor, position - anchor, position - match_position,
+                      match_length);
+        position += match_length;
+        anchor = position;
+    }
+
+    WriteSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+/// Reads extra length bytes. Returns false if the data ends before the length does.
+static bool ReadExtraLength(const u8*& in, const u8* in_end, std::size_t& length) {
+    u8 value;
+    do {
+        if (in == in_end)
+            return false;
+        value = *in++;
+        length += value;
+    } while (value == 0xFF);
+    return true;
+}
+
+bool DecompressLZ(const u8* compressed, std::size_t compressed_size, u8* decompressed,
+                  std::size_t decompressed_size) {
+    const u8* in = compressed;
+    const u8* const in_end = compressed + compressed_size;
+    u8* out = decompressed;
+    u8* const out_end = decompressed + decompressed_size;
+
+    while (in != in_end) {
+        const u8 token = *in++;
+
+        std::size_t literal_count = token >> 4;
+        if (literal_count == LENGTH_NIBBLE_MAX && !ReadExtraLength(in, in_end, literal_count))
+            return false;
+        if (literal_count > static_cast<std::size_t>(in_end - in) ||
+            literal_count > static_cast<std::size_t>(out_end - out))
+            return false;
+        std::memcpy(out, in, literal_count);
+        in += literal_count;
+        out += literal_count;
+
+        // The last sequence has no match
+        if (in == in_end)
+            break;
+
+        if (in_end - in < 2)
+            return false;
+        const std::size_t match_offset = in[0] | in[1] << 8;
+        in += 2;
+
+        std::size_t match_length = token & 0xF;
+        if (match_length == LENGTH_NIBBLE_MAX && !ReadExtraLength(in, in_end, match_length))
+            return false;
+        match_length += MIN_MATCH_LENGTH;
+
+        if (match_offset == 0 || match_offset > static_cast<std::size_t>(out - decompressed) ||
+            match_length > static_cast<std::size_t>(out_end - out))
+            return false;
+
+        // Matches can overlap the data they produce, so they are copied byte by byte
+        const u8* match = out - match_offset;
+        for (std::size_t i = 0; i < match_length; ++i) {
+            out[i] = match[i];
+        }
+        out += match_length;
+    }
+
+    return out == out_end;
+}
+
+} // namespace Common::Compression
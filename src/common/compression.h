@@ -0,0 +1,36 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "common/common_types.h"
+
+/**
+ * Fast LZ77-family compression of independent blocks of data, in the spirit of LZ4. Compressed
+ * data is a sequence of (literals, match) pairs:
+ *  - a token byte, whose high nibble is the number of literals and low nibble is the match length
+ *    minus 4. A nibble of 15 is followed by extra length bytes, added up until one is not 255.
+ *  - the literals
+ *  - the match offset, as a 16-bit little-endian value, and the extra match length bytes
+ * The last sequence only contains literals and ends at the end of the compressed data.
+ */
+namespace Common::Compression {
+
+/// Compresses a block of data. The result can be larger than the input for incompressible data.
+std::vector<u8> CompressLZ(const u8* data, std::size_t size);
+
+/**
+ * Decompresses a block of data compressed with CompressLZ.
+ * @param compressed The compressed data
+ * @param compressed_size Size of the compressed data
+ * @param decompressed Buffer to decompress the data into
+ * @param decompressed_size Size of the decompressed data
+ * @returns Whether the data was valid and decompressed to exactly decompressed_size bytes
+ */
+bool DecompressLZ(const u8* compressed, std::size_t compressed_size, u8* decompressed,
+                  std::size_t decompressed_size);
+
+} // namespace Common::Compression
@@ -42,6 +42,7 @@
 #include <cstring>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -267,6 +268,24 @@ bool Rename(const std::string& srcFilename, const std::string& destFilename) {
     return false;
 }
 
+// atomically replaces destFilename with srcFilename, returns true on success
+bool Replace(const std::string& srcFilename, const std::string& destFilename) {
+    LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
+#ifdef _WIN32
+    // _wrename fails when the destination exists
+    if (MoveFileExW(Common::UTF8ToUTF16W(srcFilename).c_str(),
+                    Common::UTF8ToUTF16W(destFilename).c_str(),
+                    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        return true;
+#else
+    if (rename(srcFilename.c_str(), destFilename.c_str()) == 0)
+        return true;
+#endif
+    LOG_ERROR(Common_Filesystem, "failed {} --> {}: {}", srcFilename, destFilename,
+              GetLastErrorMsg());
+    return false;
+}
+
 // copies file srcFilename to destFilename, returns true on success
 bool Copy(const std::string& srcFilename, const std::string& destFilename) {
     LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
@@ -350,6 +369,19 @@ u64 GetSize(const std::string& filename) {
     return 0;
 }
 
+s64 GetModificationTime(const std::string& filename) {
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+        return static_cast<s64>(buf.st_mtime);
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+}
+
 // Overloaded GetSize, accepts file descriptor
 u64 GetSize(const int fd) {
     struct stat buf;
@@ -816,6 +848,9 @@ IOFile& IOFile::operator=(IOFile&& other) {
 void IOFile::Swap(IOFile& other) {
     std::swap(m_file, other.m_file);
     std::swap(m_good, other.m_good);
+#ifdef _WIN32
+    std::swap(read_handle, other.read_handle);
+#endif
 }
 
 bool IOFile::Open(const std::string& filename, const char openmode[], int flags) {
@@ -832,6 +867,19 @@ bool IOFile::Open(const std::string& filename, const char openmode[], int flags)
     m_file = fopen(filename.c_str(), openmode);
 #endif
 
+#ifdef _WIN32
+    if (IsOpen()) {
+        // Positional reads go through a second handle opened for overlapped I/O, so that they
+        // neither move the file pointer the stdio functions use nor get serialized by Windows.
+        const HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(m_file)));
+        read_handle = ReOpenFile(handle, GENERIC_READ,
+                                 FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                 FILE_FLAG_OVERLAPPED);
+        if (read_handle == INVALID_HANDLE_VALUE)
+            read_handle = nullptr;
+    }
+#endif
+
     m_good = IsOpen();
     return m_good;
 }
@@ -841,6 +889,13 @@ bool IOFile::Close() {
         m_good = false;
 
     m_file = nullptr;
+
+#ifdef _WIN32
+    if (read_handle != nullptr)
+        CloseHandle(read_handle);
+    read_handle = nullptr;
+#endif
+
     return m_good;
 }
 
@@ -865,6 +920,64 @@ u64 IOFile::Tell() const {
     return -1;
 }
 
+#ifdef _WIN32
+/// Returns an event owned by the calling thread, used to wait for its overlapped reads.
+static HANDLE GetReadEvent() {
+    struct Event {
+        HANDLE handle = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        ~Event() {
+            CloseHandle(handle);
+        }
+    };
+    static thread_local Event event;
+    return event.handle;
+}
+#endif
+
+std::size_t IOFile::ReadBytesAt(void* data, std::size_t length, u64 offset) {
+#ifdef _WIN32
+    if (!IsOpen() || read_handle == nullptr) {
+#else
+    if (!IsOpen()) {
+#endif
+        m_good = false;
+        return std::numeric_limits<std::size_t>::max();
+    }
+
+    u8* const out = static_cast<u8*>(data);
+    std::size_t total_read = 0;
+    while (total_read < length) {
+        const u64 position = offset + total_read;
+#ifdef _WIN32
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(position);
+        overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+        overlapped.hEvent = GetReadEvent();
+        const DWORD chunk_size =
+            static_cast<DWORD>(std::min<std::size_t>(length - total_read, 0x40000000));
+        if (!ReadFile(read_handle, out + total_read, chunk_size, nullptr, &overlapped) &&
+            GetLastError() != ERROR_IO_PENDING)
+            break;
+        DWORD bytes_read = 0;
+        if (!GetOverlappedResult(read_handle, &overlapped, &bytes_read, TRUE) || bytes_read == 0)
+            break;
+#else
+        const ssize_t bytes_read =
+            pread(fileno(m_file), out + total_read, length - total_read, position);
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read <= 0)
+            break;
+#endif
+        total_read += static_cast<std::size_t>(bytes_read);
+    }
+
+    if (total_read != length)
+        m_good = false;
+
+    return total_read;
+}
+
 bool IOFile::Flush() {
     if (!IsOpen() || 0 != std::fflush(m_file))
         m_good = false;
@@ -872,6 +985,19 @@ bool IOFile::Flush() {
     return m_good;
 }
 
+bool IOFile::Sync() {
+    if (!Flush() || 0 !=
+#ifdef _WIN32
+                        _commit(_fileno(m_file))
+#else
+                        fsync(fileno(m_file))
+#endif
+    )
+        m_good = false;
+
+    return m_good;
+}
+
 bool IOFile::Resize(u64 size) {
     if (!IsOpen() || 0 !=
 #ifdef _WIN32
@@ -888,4 +1014,73 @@ bool IOFile::Resize(u64 size) {
     return m_good;
 }
 
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(const IOFile& file) {
+    const u64 file_size = file.GetSize();
+    if (file_size == 0 || file_size > std::numeric_limits<std::size_t>::max())
+        return;
+
+#ifdef _WIN32
+    const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.m_file)));
+    const HANDLE handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (handle == nullptr) {
+        LOG_ERROR(Common_Filesystem, "CreateFileMapping failed: {}", GetLastErrorMsg());
+        return;
+    }
+    void* view = MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        LOG_ERROR(Common_Filesystem, "MapViewOfFile failed: {}", GetLastErrorMsg());
+        CloseHandle(handle);
+        return;
+    }
+    mapping_handle = handle;
+#else
+    void* view = mmap(nullptr, static_cast<std::size_t>(file_size), PROT_READ, MAP_SHARED,
+                      fileno(file.m_file), 0);
+    if (view == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "mmap failed: {}", GetLastErrorMsg());
+        return;
+    }
+#endif
+
+    data = static_cast<const u8*>(view);
+    size = static_cast<std::size_t>(file_size);
+}
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) {
+    if (this != &other) {
+        Unmap();
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(mapping_handle, other.mapping_handle);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::Unmap() {
+    if (data == nullptr)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(static_cast<HANDLE>(mapping_handle));
+    mapping_handle = nullptr;
+#else
+    munmap(const_cast<u8*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
 } // namespace FileUtil
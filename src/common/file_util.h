@@ -55,6 +55,9 @@ u64 GetSize(const int fd);
 // Overloaded GetSize, accepts FILE*
 u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds since the epoch, 0 on failure
+s64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
@@ -71,6 +74,10 @@ bool DeleteDir(const std::string& filename);
 // renames file srcFilename to destFilename, returns true on success
 bool Rename(const std::string& srcFilename, const std::string& destFilename);
 
+// atomically replaces destFilename with srcFilename, creating it if it does not exist, returns
+// true on success
+bool Replace(const std::string& srcFilename, const std::string& destFilename);
+
 // copies file srcFilename to destFilename, returns true on success
 bool Copy(const std::string& srcFilename, const std::string& destFilename);
 
@@ -218,6 +225,14 @@ public:
         return WriteArray(reinterpret_cast<const char*>(data), length);
     }
 
+    /**
+     * Reads bytes at the specified offset without using or changing the file position, so it is
+     * safe to call from several threads at once. This bypasses the stdio buffer and must not be
+     * mixed with buffered writes that have not been flushed yet.
+     * @returns The number of bytes read, lower than length on error or at the end of the file
+     */
+    std::size_t ReadBytesAt(void* data, std::size_t length, u64 offset);
+
     template <typename T>
     std::size_t WriteObject(const T& object) {
         static_assert(!std::is_pointer_v<T>, "WriteObject arguments must not be a pointer");
@@ -246,6 +261,9 @@ public:
     bool Resize(u64 size);
     bool Flush();
 
+    /// Flushes the file and waits until its contents are written to the storage device.
+    bool Sync();
+
     // clear error state
     void Clear() {
         m_good = true;
@@ -255,6 +273,49 @@ public:
 private:
     std::FILE* m_file = nullptr;
     bool m_good = true;
+#ifdef _WIN32
+    void* read_handle = nullptr; ///< Overlapped handle to the same file, used by ReadBytesAt
+#endif
+
+    friend class MappedFile;
+};
+
+/**
+ * Read-only memory mapping of a whole file. Pages of the file are only read from the disk when they
+ * are first accessed, and can be dropped again by the OS under memory pressure.
+ */
+class MappedFile : public NonCopyable {
+public:
+    MappedFile();
+
+    /// Maps the specified file. On failure, IsOpen() returns false.
+    explicit MappedFile(const IOFile& file);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+
+    bool IsOpen() const {
+        return data != nullptr;
+    }
+
+    const u8* GetData() const {
+        return data;
+    }
+
+    std::size_t GetSize() const {
+        return size;
+    }
+
+private:
+    void Unmap();
+
+    const u8* data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
 };
 
 } // namespace FileUtil
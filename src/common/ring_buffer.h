@@ -89,6 +89,11 @@ public:
         return out;
     }
 
+    /// Discards all the slots of the ring buffer. Must be called from the consumer side.
+    void Clear() {
+        m_read_index.store(m_write_index.load());
+    }
+
     /// @returns Number of slots used
     std::size_t Size() const {
         return m_write_index.load() - m_read_index.load();
@@ -0,0 +1,56 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Fixed-size pool of worker threads running tasks in the order they were pushed. Tasks that are
+ * still queued when the pool is destroyed are run before the threads are joined.
+ */
+class ThreadPool : NonCopyable {
+public:
+    /**
+     * @param num_threads Number of worker threads, at least one thread is always started
+     * @param name Name given to the worker threads, for debugging
+     */
+    ThreadPool(std::size_t num_threads, std::string name);
+    ~ThreadPool();
+
+    /// Queues a task to be run on one of the worker threads.
+    void Push(std::function<void()> task);
+
+    /// Waits until all the queued tasks have been run.
+    void WaitForIdle();
+
+    std::size_t GetThreadCount() const {
+        return threads.size();
+    }
+
+private:
+    void WorkerLoop();
+
+    std::string name;
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable task_cv; ///< Signaled when a task is queued or the pool stops
+    std::condition_variable idle_cv; ///< Signaled when a task completes
+    std::deque<std::function<void()>> tasks;
+    std::size_t running_tasks = 0;
+    bool stopping = false;
+};
+
+} // namespace Common
@@ -6,6 +6,7 @@
 #include <utility>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/hle/hle.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/arm/arm_interface.h"
 #ifdef ARCHITECTURE_x86_64
@@ -59,7 +60,7 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
 
     // If we don't have a currently active thread then don't execute instructions,
     // instead advance to the next event and try to yield to the next thread
-    if (Kernel::GetCurrentThread() == nullptr) {
+    if (kernel->GetThreadManager().GetCurrentThread() == nullptr) {
         LOG_TRACE(Core_ARM11, "Idling");
         CoreTiming::Idle();
         CoreTiming::Advance();
@@ -126,7 +127,9 @@ System::ResultStatus System::Load(EmuWindow& emu_window, const std::string& file
         return init_result;
     }
 
-    const Loader::ResultStatus load_result{app_loader->Load(Kernel::g_current_process)};
+    Kernel::SharedPtr<Kernel::Process> process;
+    const Loader::ResultStatus load_result{app_loader->Load(process)};
+    kernel->SetCurrentProcess(process);
     if (Loader::ResultStatus::Success != load_result) {
         LOG_CRITICAL(Core, "Failed to load ROM (Error {})!", static_cast<u32>(load_result));
         System::Shutdown();
@@ -140,7 +143,7 @@ System::ResultStatus System::Load(EmuWindow& emu_window, const std::string& file
             return ResultStatus::ErrorLoader;
         }
     }
-    Memory::SetCurrentPageTable(&Kernel::g_current_process->vm_manager.page_table);
+    Memory::SetCurrentPageTable(&kernel->GetCurrentProcess()->vm_manager.page_table);
     status = ResultStatus::Success;
     m_emu_window = &emu_window;
     m_filepath = filepath;
@@ -148,12 +151,24 @@ System::ResultStatus System::Load(EmuWindow& emu_window, const std::string& file
 }
 
 void System::PrepareReschedule() {
-    cpu_core->PrepareReschedule();
+    // The kernel can run without a CPU core, as it does in the tests
+    if (cpu_core) {
+        cpu_core->PrepareReschedule();
+    }
     reschedule_pending = true;
 }
 
 PerfStats::Results System::GetAndResetPerfStats() {
-    return perf_stats.GetAndResetStats(CoreTiming::GetGlobalTimeUs());
+    PerfStats::Results results = perf_stats.GetAndResetStats(CoreTiming::GetGlobalTimeUs());
+    if (dsp_core) {
+        const AudioCore::DspInterface::OutputStats audio_stats =
+            dsp_core->GetAndResetOutputStats();
+        results.audio_latency = audio_stats.latency;
+        results.audio_target_latency = audio_stats.target_latency;
+        results.audio_underruns = audio_stats.underruns;
+        results.audio_stretch_ratio = audio_stats.stretch_ratio;
+    }
+    return results;
 }
 
 void System::Reschedule() {
@@ -162,7 +177,7 @@ void System::Reschedule() {
     }
 
     reschedule_pending = false;
-    Kernel::Reschedule();
+    kernel->GetThreadManager().Reschedule();
 }
 
 System::ResultStatus System::Init(EmuWindow& emu_window, u32 system_mode) {
@@ -181,7 +196,11 @@ System::ResultStatus System::Init(EmuWindow& emu_window, u32 system_mode) {
         cpu_core = std::make_unique<ARM_DynCom>(USER32MODE);
     }
 
-    dsp_core = std::make_unique<AudioCore::DspHle>();
+    auto dsp = std::make_unique<AudioCore::DspHle>(Settings::values.enable_dsp_thread);
+    if (!Settings::values.dsp_trace_path.empty()) {
+        dsp->StartTraceCapture(Settings::values.dsp_trace_path);
+    }
+    dsp_core = std::move(dsp);
     dsp_core->SetSink(Settings::values.sink_id, Settings::values.audio_device_id);
     dsp_core->EnableStretching(Settings::values.enable_audio_stretching);
 
@@ -197,6 +216,7 @@ System::ResultStatus System::Init(EmuWindow& emu_window, u32 system_mode) {
 
     HW::Init();
     kernel = std::make_unique<Kernel::KernelSystem>(system_mode);
+    kernel->GetThreadManager().SetCPU(*cpu_core);
     Service::Init(*this);
     GDBStub::Init();
 
@@ -252,9 +272,17 @@ void System::Shutdown() {
     Telemetry().AddField(Telemetry::FieldType::Performance, "Shutdown_Frametime",
                          perf_results.frametime * 1000.0);
 
+    if (call_profiler.IsEnabled()) {
+        call_profiler.DumpToFile(FileUtil::GetUserPath(FileUtil::UserPath::LogDir) +
+                                 "hle_call_stats.json");
+    }
+    call_profiler.Reset();
+
     // Shutdown emulation session
     GDBStub::Shutdown();
     VideoCore::Shutdown();
+    // Waits for the host I/O of pending FS requests, which refers to kernel objects
+    archive_manager.reset();
     Service::Shutdown();
     kernel.reset();
     HW::Shutdown();
@@ -8,6 +8,7 @@
 #include <string>
 #include "common/common_types.h"
 #include "core/frontend/applets/swkbd.h"
+#include "core/hle/call_profiler.h"
 #include "core/hle/shared_page.h"
 #include "core/loader/loader.h"
 #include "core/memory.h"
@@ -179,6 +180,7 @@ public:
 
     PerfStats perf_stats;
     FrameLimiter frame_limiter;
+    HLE::CallProfiler call_profiler;
 
     void SetStatus(ResultStatus new_status, const char* details = nullptr) {
         status = new_status;
@@ -140,6 +140,7 @@ public:
             std::make_unique<ExtSaveDataDelayGenerator>();
         auto disk_file =
             std::make_unique<FixSizeDiskFile>(std::move(file), rwmode, std::move(delay_generator));
+        disk_file->EnableWriteBack(full_path);
         return MakeResult<std::unique_ptr<FileBackend>>(std::move(disk_file));
     }
 
@@ -21,6 +21,9 @@ ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length
     if (!mode.read_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
+    if (write_back_cache != nullptr)
+        return MakeResult<std::size_t>(write_back_cache->Read(offset, length, buffer));
+
     file->Seek(offset, SEEK_SET);
     return MakeResult<std::size_t>(file->ReadBytes(buffer, length));
 }
@@ -30,6 +33,9 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
+    if (write_back_cache != nullptr)
+        return MakeResult<std::size_t>(write_back_cache->Write(offset, length, flush, buffer));
+
     file->Seek(offset, SEEK_SET);
     std::size_t written = file->WriteBytes(buffer, length);
     if (flush)
@@ -38,19 +44,45 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
 }
 
 u64 DiskFile::GetSize() const {
+    if (write_back_cache != nullptr)
+        return write_back_cache->GetSize();
     return file->GetSize();
 }
 
 bool DiskFile::SetSize(const u64 size) const {
+    if (write_back_cache != nullptr) {
+        write_back_cache->SetSize(size);
+        return true;
+    }
     file->Resize(size);
     file->Flush();
     return true;
 }
 
 bool DiskFile::Close() const {
+    // Other sessions may still use the file, its contents are committed in the background
+    if (write_back_cache != nullptr) {
+        write_back_cache->Flush();
+        return true;
+    }
     return file->Close();
 }
 
+void DiskFile::Flush() const {
+    if (write_back_cache != nullptr) {
+        write_back_cache->Flush();
+        return;
+    }
+    file->Flush();
+}
+
+void DiskFile::EnableWriteBack(const std::string& path) {
+    write_back_cache = WriteBackCache::Open(path, *file);
+    // The host file is replaced on commit, which fails on some hosts while it is open
+    if (write_back_cache != nullptr)
+        file->Close();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
 DiskDirectory::DiskDirectory(const std::string& path) {
@@ -13,6 +13,7 @@
 #include "core/file_sys/archive_backend.h"
 #include "core/file_sys/directory_backend.h"
 #include "core/file_sys/file_backend.h"
+#include "core/file_sys/write_back_cache.h"
 #include "core/hle/result.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -35,14 +36,19 @@ public:
     u64 GetSize() const override;
     bool SetSize(u64 size) const override;
     bool Close() const override;
+    void Flush() const override;
 
-    void Flush() const override {
-        file->Flush();
-    }
+    /**
+     * Serves the file from the write-back cache of its host path instead of accessing the host on
+     * every request. Does nothing if the file can not be cached.
+     * @param path Host path the file was opened from
+     */
+    void EnableWriteBack(const std::string& path);
 
 protected:
     Mode mode;
     std::unique_ptr<FileUtil::IOFile> file;
+    std::shared_ptr<WriteBackCache> write_back_cache; ///< Replaces `file` when set
 };
 
 class DiskDirectory : public DirectoryBackend {
@@ -2,19 +2,26 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstring>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
+#include <fmt/format.h>
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/core.h"
 #include "core/file_sys/ncch_container.h"
 #include "core/file_sys/seed_db.h"
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
+#include "core/settings.h"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // FileSys namespace
@@ -24,6 +31,9 @@ namespace FileSys {
 static const int kMaxSections = 8;   ///< Maximum number of sections (files) in an ExeFs
 static const int kBlockSize = 0x200; ///< Size of ExeFS blocks (in bytes)
 
+/// Guards the use of the NCCH key slots, from setting the KeyY to getting the normal key
+static std::mutex key_slot_mutex;
+
 /**
  * Get the decompressed size of an LZSS compressed ExeFS file
  * @param buffer Buffer of compressed file
@@ -104,15 +114,95 @@ static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decom
     return true;
 }
 
+/// Decryption of a whole RomFS section into the decrypted content cache
+struct NCCHContainer::RomFSCacheTask {
+    /**
+     * Decrypts the section, verifying the RomFS superblock hash from the NCCH header.
+     * @return True if the cache file was written, false on failure or cancellation
+     */
+    bool Run();
+
+    std::string source_path; ///< Path of the NCCH, opened again to read it from another thread
+    std::string path;        ///< Path of the cache file to create
+    u64 section_offset;
+    u64 section_size;
+    u64 hash_region_size;
+    std::array<u8, 16> key;
+    std::array<u8, 16> ctr;
+    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> expected_hash;
+
+    std::atomic<bool> cancel{false};
+    std::thread thread;
+};
+
+bool NCCHContainer::RomFSCacheTask::Run() {
+    if (!FileUtil::CreateFullPath(path))
+        return false;
+
+    FileUtil::ROMFile source(source_path);
+    if (!source.IsOpen())
+        return false;
+
+    const std::string temp_path = path + ".tmp";
+    FileUtil::IOFile cache_file(temp_path, "wb");
+    if (!cache_file.IsOpen())
+        return false;
+
+    const auto discard = [&cache_file, &temp_path] {
+        cache_file.Close();
+        FileUtil::Delete(temp_path);
+        return false;
+    };
+
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(), ctr.data());
+    CryptoPP::SHA256 sha;
+    std::vector<u8> chunk(0x100000);
+    for (u64 offset = 0; offset < section_size; offset += chunk.size()) {
+        if (cancel)
+            return discard();
+
+        const std::size_t chunk_size =
+            static_cast<std::size_t>(std::min<u64>(chunk.size(), section_size - offset));
+        if (source.ReadBytesAt(chunk.data(), chunk_size, section_offset + offset) != chunk_size)
+            return discard();
+
+        dec.ProcessData(chunk.data(), chunk.data(), chunk_size);
+        if (offset < hash_region_size) {
+            sha.Update(chunk.data(), static_cast<std::size_t>(
+                                         std::min<u64>(chunk_size, hash_region_size - offset)));
+        }
+        cache_file.WriteBytes(chunk.data(), chunk_size);
+    }
+
+    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> hash;
+    sha.Final(hash.data());
+    if (!cache_file.IsGood() || hash != expected_hash) {
+        LOG_WARNING(Service_FS, "Failed to verify the decrypted RomFS, not caching it");
+        return discard();
+    }
+
+    cache_file.Close();
+    return FileUtil::Rename(temp_path, path);
+}
+
 NCCHContainer::NCCHContainer(const std::string& filepath, u32 ncch_offset)
     : ncch_offset(ncch_offset), filepath(filepath) {
-    file = FileUtil::IOFile(filepath, "rb");
+    file = FileUtil::ROMFile(filepath);
+}
+
+NCCHContainer::NCCHContainer() = default;
+
+NCCHContainer::~NCCHContainer() {
+    if (romfs_cache_task != nullptr) {
+        romfs_cache_task->cancel = true;
+        romfs_cache_task->thread.join();
+    }
 }
 
 Loader::ResultStatus NCCHContainer::OpenFile(const std::string& filepath, u32 ncch_offset) {
     this->filepath = filepath;
     this->ncch_offset = ncch_offset;
-    file = FileUtil::IOFile(filepath, "rb");
+    file = FileUtil::ROMFile(filepath);
 
     if (!file.IsOpen()) {
         LOG_WARNING(Service_FS, "Failed to open {}", filepath);
@@ -159,6 +249,9 @@ Loader::ResultStatus NCCHContainer::Load() {
                 secondary_key.fill(0);
             } else {
                 using namespace HW::AES;
+                // The normal keys are derived through the global key slots, so the NCCHs loaded
+                // on several threads at once, such as by the game list, set them one at a time.
+                std::lock_guard<std::mutex> lock(key_slot_mutex);
                 InitKeys();
                 std::array<u8, 16> key_y_primary, key_y_secondary;
 
@@ -341,7 +434,7 @@ Loader::ResultStatus NCCHContainer::Load() {
                     .ProcessData(data, data, sizeof(exefs_header));
             }
 
-            exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_file = FileUtil::ROMFile(filepath);
             has_exefs = true;
         }
 
@@ -355,6 +448,20 @@ Loader::ResultStatus NCCHContainer::Load() {
     if (!(has_exefs || has_romfs || is_tainted))
         return Loader::ResultStatus::Error;
 
+    if (is_encrypted && !is_tainted && Settings::values.cache_decrypted_content) {
+        // The header, including its signature, identifies the content of this exact NCCH
+        std::array<u8, CryptoPP::SHA256::DIGESTSIZE> header_hash;
+        CryptoPP::SHA256().CalculateDigest(header_hash.data(),
+                                           reinterpret_cast<const u8*>(&ncch_header),
+                                           sizeof(ncch_header));
+        decrypted_cache_dir = fmt::format(
+            "{}decrypted_ncch/{:016X}_", FileUtil::GetUserPath(FileUtil::UserPath::CacheDir),
+            ncch_header.program_id);
+        for (std::size_t i = 0; i < 8; ++i)
+            decrypted_cache_dir += fmt::format("{:02X}", header_hash[i]);
+        decrypted_cache_dir += '/';
+    }
+
     is_loaded = true;
     return Loader::ResultStatus::Success;
 }
@@ -370,7 +477,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
     std::string exefs_override = filepath + ".exefs";
     std::string exefsdir_override = filepath + ".exefsdir/";
     if (FileUtil::Exists(exefs_override)) {
-        exefs_file = FileUtil::IOFile(exefs_override, "rb");
+        exefs_file = FileUtil::ROMFile(exefs_override);
 
         if (exefs_file.ReadBytes(&exefs_header, sizeof(ExeFs_Header)) == sizeof(ExeFs_Header)) {
             LOG_DEBUG(Service_FS, "Loading ExeFS section from {}", exefs_override);
@@ -378,7 +485,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
             is_tainted = true;
             has_exefs = true;
         } else {
-            exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_file = FileUtil::ROMFile(filepath);
         }
     } else if (FileUtil::Exists(exefsdir_override) && FileUtil::IsDirectory(exefsdir_override)) {
         is_tainted = true;
@@ -451,6 +558,10 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                                                               exefs_ctr.data());
             dec.Seek(section.offset + sizeof(ExeFs_Header));
 
+            // The hashes of the sections are stored in reverse order
+            const std::string cache_name = fmt::format("exefs_{}.bin", name);
+            const u8* section_hash = exefs_header.hashes[kMaxSections - 1 - section_number];
+
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
                 std::unique_ptr<u8[]> temp_buffer;
@@ -460,11 +571,15 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                     return Loader::ResultStatus::ErrorMemoryAllocationFailed;
                 }
 
-                if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
-                    return Loader::ResultStatus::Error;
+                if (!ReadDecryptedCache(cache_name, &temp_buffer[0], section.size)) {
+                    if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
+                        return Loader::ResultStatus::Error;
 
-                if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    if (is_encrypted) {
+                        dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                        WriteDecryptedCache(cache_name, &temp_buffer[0], section.size,
+                                            section_hash);
+                    }
                 }
 
                 // Decompress .code section...
@@ -475,10 +590,14 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
+                if (ReadDecryptedCache(cache_name, &buffer[0], section.size))
+                    return Loader::ResultStatus::Success;
+
                 if (exefs_file.ReadBytes(&buffer[0], section.size) != section.size)
                     return Loader::ResultStatus::Error;
                 if (is_encrypted) {
                     dec.ProcessData(&buffer[0], &buffer[0], section.size);
+                    WriteDecryptedCache(cache_name, &buffer[0], section.size, section_hash);
                 }
             }
             return Loader::ResultStatus::Success;
@@ -544,8 +663,27 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romf
     if (file.GetSize() < romfs_offset + romfs_size)
         return Loader::ResultStatus::Error;
 
+    if (is_encrypted && !decrypted_cache_dir.empty()) {
+        const std::string cache_path = decrypted_cache_dir + "romfs.bin";
+        FileUtil::IOFile cache_file(cache_path, "rb");
+        if (cache_file.IsOpen() && cache_file.GetSize() == romfs_size + 0x1000) {
+            LOG_DEBUG(Service_FS, "Using decrypted RomFS from {}", cache_path);
+            romfs_file = std::make_shared<RomFSReader>(std::move(cache_file), 0x1000, romfs_size);
+            return Loader::ResultStatus::Success;
+        }
+
+        if (cache_file.IsOpen()) {
+            LOG_WARNING(Service_FS, "Discarding {}, which has the wrong size", cache_path);
+            cache_file.Close();
+            FileUtil::Delete(cache_path);
+        }
+
+        // The RomFS is read encrypted until the next load, which uses the decrypted copy
+        StartDecryptedRomFSCache(cache_path);
+    }
+
     // We reopen the file, to allow its position to be independent from file's
-    FileUtil::IOFile romfs_file_inner(filepath, "rb");
+    FileUtil::ROMFile romfs_file_inner(filepath);
     if (!romfs_file_inner.IsOpen())
         return Loader::ResultStatus::Error;
 
@@ -560,6 +698,69 @@ Loader::ResultStatus NCCHContainer::ReadRomFS(std::shared_ptr<RomFSReader>& romf
     return Loader::ResultStatus::Success;
 }
 
+bool NCCHContainer::ReadDecryptedCache(const std::string& name, u8* data, std::size_t size) {
+    if (decrypted_cache_dir.empty())
+        return false;
+
+    FileUtil::IOFile cache_file(decrypted_cache_dir + name, "rb");
+    if (!cache_file.IsOpen() || cache_file.GetSize() != size)
+        return false;
+
+    return cache_file.ReadBytes(data, size) == size;
+}
+
+void NCCHContainer::WriteDecryptedCache(const std::string& name, const u8* data,
+                                        std::size_t size, const u8* expected_hash) {
+    if (decrypted_cache_dir.empty())
+        return;
+
+    std::array<u8, CryptoPP::SHA256::DIGESTSIZE> hash;
+    CryptoPP::SHA256().CalculateDigest(hash.data(), data, size);
+    if (std::memcmp(hash.data(), expected_hash, hash.size()) != 0) {
+        LOG_WARNING(Service_FS, "Hash mismatch in decrypted section {}, not caching it", name);
+        return;
+    }
+
+    // Write to a temporary file first, so that an interrupted write can't leave a partial file
+    const std::string path = decrypted_cache_dir + name;
+    if (!FileUtil::CreateFullPath(path))
+        return;
+    {
+        FileUtil::IOFile cache_file(path + ".tmp", "wb");
+        if (cache_file.WriteBytes(data, size) != size) {
+            LOG_ERROR(Service_FS, "Failed to write decrypted section to {}", path);
+            return;
+        }
+    }
+    FileUtil::Rename(path + ".tmp", path);
+}
+
+void NCCHContainer::StartDecryptedRomFSCache(const std::string& path) {
+    if (romfs_cache_task != nullptr)
+        return;
+
+    auto task = std::make_unique<RomFSCacheTask>();
+    task->source_path = filepath;
+    task->path = path;
+    task->section_offset = ncch_offset + static_cast<u64>(ncch_header.romfs_offset) * kBlockSize;
+    task->section_size = static_cast<u64>(ncch_header.romfs_size) * kBlockSize;
+    task->hash_region_size = static_cast<u64>(ncch_header.romfs_hash_region_size) * kBlockSize;
+    task->key = secondary_key;
+    task->ctr = romfs_ctr;
+    std::memcpy(task->expected_hash.data(), ncch_header.romfs_super_block_hash,
+                task->expected_hash.size());
+    if (task->hash_region_size == 0 || task->hash_region_size > task->section_size)
+        return;
+
+    LOG_INFO(Service_FS, "Writing decrypted RomFS to {} in the background", path);
+    task->thread = std::thread([task = task.get()] {
+        Common::SetCurrentThreadName("RomFSCache");
+        if (task->Run())
+            LOG_INFO(Service_FS, "Decrypted RomFS written to {}", task->path);
+    });
+    romfs_cache_task = std::move(task);
+}
+
 Loader::ResultStatus NCCHContainer::ReadOverrideRomFS(std::shared_ptr<RomFSReader>& romfs_file) {
     // Check for RomFS overrides
     std::string split_filepath = filepath + ".romfs";
@@ -10,6 +10,7 @@
 #include <vector>
 #include "common/bit_field.h"
 #include "common/common_types.h"
+#include "common/compressed_file.h"
 #include "common/file_util.h"
 #include "common/swap.h"
 #include "core/core.h"
@@ -205,7 +206,8 @@ namespace FileSys {
 class NCCHContainer {
 public:
     NCCHContainer(const std::string& filepath, u32 ncch_offset = 0);
-    NCCHContainer() {}
+    NCCHContainer();
+    ~NCCHContainer();
 
     Loader::ResultStatus OpenFile(const std::string& filepath, u32 ncch_offset = 0);
 
@@ -294,6 +296,35 @@ public:
     ExHeader_Header exheader_header;
 
 private:
+    /**
+     * Reads a decrypted section from the decrypted content cache.
+     * @param name Name of the section in the cache
+     * @param data Buffer to read the section into
+     * @param size Size of the section
+     * @return True if the section was in the cache and has been read
+     */
+    bool ReadDecryptedCache(const std::string& name, u8* data, std::size_t size);
+
+    /**
+     * Writes a decrypted section to the decrypted content cache, if its SHA-256 hash matches the
+     * one from the NCCH headers.
+     * @param name Name of the section in the cache
+     * @param data Decrypted section data
+     * @param size Size of the section
+     * @param expected_hash Expected SHA-256 hash of the section
+     */
+    void WriteDecryptedCache(const std::string& name, const u8* data, std::size_t size,
+                             const u8* expected_hash);
+
+    struct RomFSCacheTask;
+
+    /**
+     * Starts decrypting the whole RomFS section into the decrypted content cache on a thread of
+     * its own, so that the next loads can use it. Does nothing if it was already started.
+     * @param path Path of the cache file to create
+     */
+    void StartDecryptedRomFSCache(const std::string& path);
+
     bool has_header = false;
     bool has_exheader = false;
     bool has_exefs = false;
@@ -314,9 +345,14 @@ private:
     u32 ncch_offset = 0; // Offset to NCCH header, can be 0 for NCCHs or non-zero for CIAs/NCSDs
     u32 exefs_offset = 0;
 
+    /// Directory of the decrypted content cache for this NCCH, empty if the cache is not used
+    std::string decrypted_cache_dir;
+    /// Background decryption of the RomFS into the decrypted content cache, canceled on destruction
+    std::unique_ptr<RomFSCacheTask> romfs_cache_task;
+
     std::string filepath;
-    FileUtil::IOFile file;
-    FileUtil::IOFile exefs_file;
+    FileUtil::ROMFile file;
+    FileUtil::ROMFile exefs_file;
 };
 
 } // namespace FileSys
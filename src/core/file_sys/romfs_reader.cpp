@@ -1,22 +1,177 @@
 #include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
+#include "common/logging/log.h"
 #include "core/file_sys/romfs_reader.h"
+#include "core/settings.h"
 
 namespace FileSys {
 
+/// Holds the expanded AES key, so that it is computed once instead of for every read.
+struct RomFSReader::Decryptor {
+    Decryptor(const std::array<u8, 16>& key, const std::array<u8, 16>& ctr)
+        : aes(key.data(), key.size(), ctr.data()) {}
+
+    /// Decrypts data that starts at the specified offset of the encrypted stream.
+    void Decrypt(u8* out, const u8* in, std::size_t length, std::size_t stream_offset) {
+        std::lock_guard<std::mutex> lock(mutex);
+        const auto start = std::chrono::steady_clock::now();
+        aes.Seek(stream_offset);
+        aes.ProcessData(out, in, length);
+        decryption_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+        decrypted_bytes += length;
+    }
+
+    std::mutex mutex; ///< Protects the cipher state and the stats
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption aes;
+    u64 decrypted_bytes = 0;
+    u64 decryption_ns = 0;
+};
+
+/// Maps a file if it is not compressed, compressed files can not be read through a mapping.
+static FileUtil::MappedFile MapFile(const FileUtil::ROMFile& file) {
+    const FileUtil::IOFile* raw_file = file.GetRawFile();
+    return raw_file != nullptr ? FileUtil::MappedFile(*raw_file) : FileUtil::MappedFile();
+}
+
+RomFSReader::RomFSReader(FileUtil::ROMFile&& file, std::size_t file_offset, std::size_t data_size)
+    : file(std::move(file)), mapped_file(MapFile(this->file)), file_offset(file_offset),
+      data_size(data_size),
+      max_cached_blocks(mapped_file.IsOpen() || this->file.IsCompressed()
+                            ? 0 // The OS page cache or the compressed file already cache the data
+                            : static_cast<std::size_t>(Settings::values.romfs_cache_size) *
+                                  0x100000 / CACHE_BLOCK_SIZE) {}
+
+RomFSReader::RomFSReader(FileUtil::ROMFile&& file, std::size_t file_offset, std::size_t data_size,
+                         const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
+                         std::size_t crypto_offset)
+    : file(std::move(file)), mapped_file(MapFile(this->file)),
+      decryptor(std::make_unique<Decryptor>(key, ctr)), file_offset(file_offset),
+      crypto_offset(crypto_offset), data_size(data_size),
+      max_cached_blocks(static_cast<std::size_t>(Settings::values.romfs_cache_size) * 0x100000 /
+                        CACHE_BLOCK_SIZE) {}
+
+RomFSReader::~RomFSReader() {
+    const CacheStats stats = GetCacheStats();
+    const u64 accesses = stats.hits + stats.misses;
+    if (accesses == 0)
+        return;
+
+    const double seconds = stats.decryption_ns / 1e9;
+    LOG_DEBUG(Service_FS,
+              "RomFS cache: {} hits, {} misses ({:.1f}% hit rate), "
+              "{} KiB decrypted at {:.1f} MiB/s",
+              stats.hits, stats.misses, stats.hits * 100.0 / accesses,
+              stats.decrypted_bytes / 1024,
+              seconds > 0 ? stats.decrypted_bytes / seconds / 0x100000 : 0.0);
+}
+
 std::size_t RomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
-    if (length == 0)
-        return 0; // Crypto++ does not like zero size buffer
-    file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, data_size - offset);
-    read_length = file.ReadBytes(buffer, read_length);
-    if (is_encrypted) {
-        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-        d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
+    if (length == 0 || offset >= data_size)
+        return 0;
+    length = std::min(length, data_size - offset);
+
+    // Reads that would evict a large part of the cache are done straight from the file
+    if (length > max_cached_blocks * CACHE_BLOCK_SIZE / 4)
+        return ReadUncached(offset, length, buffer);
+
+    std::size_t read_length = 0;
+    while (read_length < length) {
+        const std::size_t position = offset + read_length;
+        const std::size_t copy_length =
+            ReadFromBlock(position / CACHE_BLOCK_SIZE, position % CACHE_BLOCK_SIZE,
+                          length - read_length, buffer + read_length);
+        if (copy_length == 0)
+            break; // The file is shorter than expected
+        read_length += copy_length;
+    }
+    return read_length;
+}
+
+RomFSReader::CacheStats RomFSReader::GetCacheStats() const {
+    CacheStats result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        result = stats;
+    }
+    if (decryptor != nullptr) {
+        std::lock_guard<std::mutex> lock(decryptor->mutex);
+        result.decrypted_bytes = decryptor->decrypted_bytes;
+        result.decryption_ns = decryptor->decryption_ns;
+    }
+    return result;
+}
+
+std::size_t RomFSReader::ReadUncached(std::size_t offset, std::size_t length, u8* buffer) {
+    // Mapped data is decrypted straight out of the mapping, without an intermediate copy
+    const u8* source = buffer;
+    std::size_t read_length;
+    if (mapped_file.IsOpen()) {
+        const std::size_t position = std::min(file_offset + offset, mapped_file.GetSize());
+        source = mapped_file.GetData() + position;
+        read_length = std::min(length, mapped_file.GetSize() - position);
+        if (decryptor == nullptr)
+            std::memcpy(buffer, source, read_length);
+    } else {
+        read_length = file.ReadBytesAt(buffer, length, file_offset + offset);
     }
+
+    if (decryptor != nullptr && read_length != 0)
+        decryptor->Decrypt(buffer, source, read_length, crypto_offset + offset);
     return read_length;
 }
 
+std::size_t RomFSReader::ReadFromBlock(std::size_t index, std::size_t block_offset,
+                                       std::size_t length, u8* buffer) {
+    const auto copy_from = [&](const std::vector<u8>& data) -> std::size_t {
+        if (block_offset >= data.size())
+            return 0;
+        const std::size_t copy_length = std::min(length, data.size() - block_offset);
+        std::memcpy(buffer, data.data() + block_offset, copy_length);
+        return copy_length;
+    };
+
+    std::unique_lock<std::mutex> lock(mutex);
+    auto itr = block_map.find(index);
+    if (itr != block_map.end()) {
+        stats.hits++;
+        cached_blocks.splice(cached_blocks.begin(), cached_blocks, itr->second);
+        return copy_from(cached_blocks.front().data);
+    }
+
+    stats.misses++;
+
+    // Reuse the buffer of the least recently used block if the cache is full
+    std::vector<u8> data;
+    if (cached_blocks.size() >= max_cached_blocks) {
+        data = std::move(cached_blocks.back().data);
+        block_map.erase(cached_blocks.back().index);
+        cached_blocks.pop_back();
+    }
+
+    // The block is read without holding the lock, so that reads of other blocks do not wait for
+    // the disk
+    lock.unlock();
+    const std::size_t block_start = index * CACHE_BLOCK_SIZE;
+    data.resize(std::min(CACHE_BLOCK_SIZE, data_size - block_start));
+    data.resize(ReadUncached(block_start, data.size(), data.data()));
+    const std::size_t copy_length = copy_from(data);
+    lock.lock();
+
+    // Another thread may have read the same block in the meantime
+    if (block_map.count(index) == 0) {
+        if (cached_blocks.size() >= max_cached_blocks) {
+            block_map.erase(cached_blocks.back().index);
+            cached_blocks.pop_back();
+        }
+        cached_blocks.push_front({index, std::move(data)});
+        block_map.emplace(index, cached_blocks.begin());
+    }
+    return copy_length;
+}
+
 } // namespace FileSys
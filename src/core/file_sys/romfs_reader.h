@@ -1,22 +1,47 @@
 #pragma once
 
 #include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "common/common_types.h"
+#include "common/compressed_file.h"
 #include "common/file_util.h"
 
 namespace FileSys {
 
+/**
+ * Reads the data of a RomFS from a file, decrypting it if needed. The file is memory-mapped when
+ * possible, so that only the parts a game actually reads are loaded from the disk. Unencrypted
+ * data is copied straight out of the mapping, or out of the block cache of compressed ROMs. For
+ * encrypted data, recently read blocks are kept decrypted in a LRU cache, whose size is set by
+ * Settings::values.romfs_cache_size, so that the many small reads games do hit the host file
+ * system and the decryptor as little as possible.
+ * Reading is thread-safe. The host file is read without holding any lock, only the lookups in the
+ * block cache and the decryption are serialized.
+ */
 class RomFSReader {
 public:
-    RomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+    /// Size of the blocks the RomFS data is cached in. This is a multiple of the AES block size.
+    static constexpr std::size_t CACHE_BLOCK_SIZE = 0x4000;
 
-    RomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
+    struct CacheStats {
+        u64 hits = 0;
+        u64 misses = 0;
+        /// Number of bytes decrypted, and host time spent doing so, in nanoseconds
+        u64 decrypted_bytes = 0;
+        u64 decryption_ns = 0;
+    };
+
+    RomFSReader(FileUtil::ROMFile&& file, std::size_t file_offset, std::size_t data_size);
+
+    RomFSReader(FileUtil::ROMFile&& file, std::size_t file_offset, std::size_t data_size,
                 const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
-                std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+                std::size_t crypto_offset);
+
+    ~RomFSReader();
 
     std::size_t GetSize() const {
         return data_size;
@@ -24,14 +49,41 @@ public:
 
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer);
 
+    CacheStats GetCacheStats() const;
+
 private:
-    bool is_encrypted;
-    FileUtil::IOFile file;
-    std::array<u8, 16> key;
-    std::array<u8, 16> ctr;
+    struct Decryptor;
+
+    struct CachedBlock {
+        std::size_t index;
+        std::vector<u8> data;
+    };
+
+    /// Reads and decrypts data straight from the file, bypassing the cache.
+    std::size_t ReadUncached(std::size_t offset, std::size_t length, u8* buffer);
+
+    /**
+     * Copies data out of a cached block, reading the block first if it is not cached.
+     * @returns The number of bytes copied, 0 if the block is shorter than block_offset
+     */
+    std::size_t ReadFromBlock(std::size_t index, std::size_t block_offset, std::size_t length,
+                              u8* buffer);
+
+    FileUtil::ROMFile file;
+    FileUtil::MappedFile mapped_file; ///< Mapping of file, if the file could be mapped
+    std::unique_ptr<Decryptor> decryptor; ///< nullptr if the data is not encrypted
     std::size_t file_offset;
-    std::size_t crypto_offset;
+    std::size_t crypto_offset = 0;
     std::size_t data_size;
+
+    std::size_t max_cached_blocks;
+
+    mutable std::mutex mutex; ///< Protects the block cache and the stats
+
+    /// Cached blocks, the most recently used first
+    std::list<CachedBlock> cached_blocks;
+    std::unordered_map<std::size_t, std::list<CachedBlock>::iterator> block_map;
+    CacheStats stats;
 };
 
 } // namespace FileSys
@@ -177,6 +177,10 @@ u64 TitleMetadata::GetContentSizeByIndex(u16 index) const {
     return tmd_chunks[index].size;
 }
 
+std::array<u8, 0x20> TitleMetadata::GetContentHashByIndex(u16 index) const {
+    return tmd_chunks[index].hash;
+}
+
 std::array<u8, 16> TitleMetadata::GetContentCTRByIndex(u16 index) const {
     std::array<u8, 16> ctr{};
     std::memcpy(ctr.data(), &tmd_chunks[index].index, sizeof(u16));
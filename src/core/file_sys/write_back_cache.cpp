@@ -0,0 +1,326 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/file_sys/write_back_cache.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// FileSys namespace
+
+namespace FileSys {
+
+namespace {
+
+/// Caches in use by host path. The caches are kept here until their last user is released, so
+/// that a file opened while the last user is being released still sees the pending contents.
+std::mutex caches_mutex;
+std::unordered_map<std::string, std::shared_ptr<WriteBackCache>> caches;
+WriteBackCache::CommitRunner commit_runner; ///< Guarded by the mutex of the caches
+
+std::string GetTemporaryPath(const std::string& path) {
+    return path + ".tmp";
+}
+
+/// Checks if a host path is the given file or directory, or is inside of that directory.
+bool IsWithin(const std::string& path, const std::string& directory) {
+    if (path.compare(0, directory.size(), directory) != 0)
+        return false;
+    return path.size() == directory.size() || directory.back() == '/' ||
+           path[directory.size()] == '/';
+}
+
+} // namespace
+
+std::shared_ptr<WriteBackCache> WriteBackCache::Open(const std::string& path,
+                                                     FileUtil::IOFile& file) {
+    std::lock_guard<std::mutex> lock(caches_mutex);
+
+    auto itr = caches.find(path);
+    if (itr == caches.end()) {
+        const u64 size = file.GetSize();
+        if (size > MAX_FILE_SIZE)
+            return nullptr;
+
+        std::vector<u8> data(static_cast<std::size_t>(size));
+        if (file.ReadBytesAt(data.data(), data.size(), 0) != data.size()) {
+            LOG_ERROR(Service_FS, "Could not read {}", path);
+            return nullptr;
+        }
+
+        // A temporary file left behind by an interrupted commit, the original file is intact
+        FileUtil::Delete(GetTemporaryPath(path));
+
+        std::shared_ptr<WriteBackCache> cache(new WriteBackCache(path, std::move(data)));
+        itr = caches.emplace(path, std::move(cache)).first;
+    }
+
+    std::shared_ptr<WriteBackCache> cache = itr->second;
+    cache->users++;
+    return std::shared_ptr<WriteBackCache>(cache.get(),
+                                           [cache](WriteBackCache*) { Release(cache); });
+}
+
+void WriteBackCache::Release(const std::shared_ptr<WriteBackCache>& cache) {
+    CommitRunner runner;
+    {
+        std::lock_guard<std::mutex> lock(caches_mutex);
+        if (--cache->users != 0)
+            return;
+        runner = commit_runner;
+    }
+
+    // The cache stays available to the files opened until it is committed
+    if (runner) {
+        runner([cache] { CommitReleased(cache); });
+    } else {
+        CommitReleased(cache);
+    }
+}
+
+void WriteBackCache::CommitReleased(const std::shared_ptr<WriteBackCache>& cache) {
+    cache->Commit();
+
+    std::lock_guard<std::mutex> lock(caches_mutex);
+    if (cache->users != 0)
+        return;
+
+    const auto itr = caches.find(cache->path);
+    if (itr != caches.end() && itr->second == cache)
+        caches.erase(itr);
+}
+
+void WriteBackCache::SetCommitRunner(CommitRunner runner) {
+    std::lock_guard<std::mutex> lock(caches_mutex);
+    commit_runner = std::move(runner);
+}
+
+bool WriteBackCache::Rename(const std::string& src_path, const std::string& dest_path) {
+    std::lock_guard<std::mutex> lock(caches_mutex);
+
+    // The pending contents are committed to the files before they are moved along with them. The
+    // caches stay locked until their path is updated, so that nothing is committed in between.
+    std::vector<std::shared_ptr<WriteBackCache>> moved;
+    std::vector<std::unique_lock<std::mutex>> moved_locks;
+    for (const auto& [path, cache] : caches) {
+        if (IsWithin(path, src_path)) {
+            moved_locks.emplace_back(cache->mutex);
+            cache->CommitLocked();
+            moved.push_back(cache);
+        }
+    }
+
+    if (!FileUtil::Rename(src_path, dest_path))
+        return false;
+
+    for (const auto& cache : moved) {
+        caches.erase(cache->path);
+    }
+    // Hosts replace an existing destination file
+    DetachLocked(dest_path);
+
+    for (const auto& cache : moved) {
+        cache->path = dest_path + cache->path.substr(src_path.size());
+        caches[cache->path] = cache;
+    }
+    return true;
+}
+
+void WriteBackCache::Invalidate(const std::string& path) {
+    std::lock_guard<std::mutex> lock(caches_mutex);
+    DetachLocked(path);
+}
+
+void WriteBackCache::DetachLocked(const std::string& path) {
+    for (auto itr = caches.begin(); itr != caches.end();) {
+        if (!IsWithin(itr->first, path)) {
+            ++itr;
+            continue;
+        }
+
+        WriteBackCache& cache = *itr->second;
+        std::lock_guard<std::mutex> cache_lock(cache.mutex);
+        cache.detached = true;
+        cache.dirty = false;
+        cache.flush_requested = false;
+        itr = caches.erase(itr);
+    }
+}
+
+void WriteBackCache::CommitExpired() {
+    // The caches are committed without holding the mutex of the caches, so that opening other
+    // files does not wait for the host storage
+    std::vector<std::shared_ptr<WriteBackCache>> expired;
+    {
+        std::lock_guard<std::mutex> lock(caches_mutex);
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto& [path, cache] : caches) {
+            std::lock_guard<std::mutex> cache_lock(cache->mutex);
+            if (!cache->dirty)
+                continue;
+            if (cache->flush_requested || now - cache->dirty_since >= COMMIT_INTERVAL)
+                expired.push_back(cache);
+        }
+    }
+
+    for (const auto& cache : expired) {
+        cache->Commit();
+    }
+}
+
+WriteBackCache::WriteBackCache(std::string path, std::vector<u8> data)
+    : path(std::move(path)), data(std::move(data)) {}
+
+WriteBackCache::~WriteBackCache() = default;
+
+std::size_t WriteBackCache::Read(u64 offset, std::size_t length, u8* buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (direct_file != nullptr) {
+        direct_file->Seek(offset, SEEK_SET);
+        return direct_file->ReadBytes(buffer, length);
+    }
+
+    if (offset >= data.size())
+        return 0;
+
+    length = static_cast<std::size_t>(std::min<u64>(length, data.size() - offset));
+    std::memcpy(buffer, data.data() + offset, length);
+    return length;
+}
+
+std::size_t WriteBackCache::Write(u64 offset, std::size_t length, bool flush, const u8* buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (offset > UINT64_MAX - length || !ReserveLocked(offset + length))
+        return 0;
+
+    if (direct_file != nullptr) {
+        direct_file->Seek(offset, SEEK_SET);
+        const std::size_t written = direct_file->WriteBytes(buffer, length);
+        if (flush)
+            direct_file->Flush();
+        return written;
+    }
+
+    if (offset + length > data.size())
+        data.resize(static_cast<std::size_t>(offset + length));
+
+    std::memcpy(data.data() + offset, buffer, length);
+    stats.guest_writes++;
+    MarkDirty();
+
+    // The flushes are coalesced until the next CommitExpired
+    if (flush)
+        flush_requested = true;
+    return length;
+}
+
+u64 WriteBackCache::GetSize() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (direct_file != nullptr)
+        return direct_file->GetSize();
+    return data.size();
+}
+
+void WriteBackCache::SetSize(u64 size) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!ReserveLocked(size))
+        return;
+
+    if (direct_file != nullptr) {
+        direct_file->Resize(size);
+        direct_file->Flush();
+        return;
+    }
+
+    data.resize(static_cast<std::size_t>(size));
+    MarkDirty();
+}
+
+void WriteBackCache::Flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (direct_file != nullptr) {
+        direct_file->Flush();
+        return;
+    }
+    flush_requested = dirty;
+}
+
+bool WriteBackCache::Commit() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return CommitLocked();
+}
+
+WriteBackCache::Stats WriteBackCache::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void WriteBackCache::MarkDirty() {
+    if (!dirty) {
+        dirty = true;
+        dirty_since = std::chrono::steady_clock::now();
+    }
+}
+
+bool WriteBackCache::CommitLocked() {
+    if (direct_file != nullptr)
+        return direct_file->Flush();
+
+    if (!dirty)
+        return true;
+
+    // Writing to a file that was deleted while opened does not bring it back
+    if (detached || !FileUtil::Exists(path)) {
+        LOG_WARNING(Service_FS, "{} was deleted, dropping its pending writes", path);
+        dirty = false;
+        flush_requested = false;
+        return false;
+    }
+
+    // The temporary file must be on the storage before it replaces the original, or a crash right
+    // after the replacement could leave an empty file behind
+    const std::string temp_path = GetTemporaryPath(path);
+    FileUtil::IOFile temp(temp_path, "wb");
+    const bool written = temp.IsOpen() &&
+                         temp.WriteBytes(data.data(), data.size()) == data.size() && temp.Sync() &&
+                         temp.Close();
+    if (!written || !FileUtil::Replace(temp_path, path)) {
+        LOG_ERROR(Service_FS, "Could not commit {}", path);
+        temp.Close();
+        FileUtil::Delete(temp_path);
+        return false;
+    }
+
+    dirty = false;
+    flush_requested = false;
+    stats.commits++;
+    return true;
+}
+
+bool WriteBackCache::ReserveLocked(u64 size) {
+    if (direct_file != nullptr || size <= MAX_FILE_SIZE)
+        return true;
+
+    // The host file must hold the current contents before it is accessed directly
+    if (detached || !CommitLocked())
+        return false;
+
+    auto file = std::make_unique<FileUtil::IOFile>(path, "r+b");
+    if (!file->IsOpen()) {
+        LOG_ERROR(Service_FS, "Could not reopen {}", path);
+        return false;
+    }
+
+    LOG_DEBUG(Service_FS, "{} grows past {} bytes, no longer caching it", path, MAX_FILE_SIZE);
+    direct_file = std::move(file);
+    data.clear();
+    data.shrink_to_fit();
+    return true;
+}
+
+} // namespace FileSys
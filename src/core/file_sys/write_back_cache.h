@@ -0,0 +1,137 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace FileUtil {
+class IOFile;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// FileSys namespace
+
+namespace FileSys {
+
+/**
+ * In-memory write-back cache of a host file backing a savedata or extdata file. Guest writes are
+ * coalesced in memory and committed to the host as a whole by writing a temporary file that then
+ * atomically replaces the original one, so that an interrupted commit never leaves a torn save.
+ *
+ * The contents are committed by CommitExpired once the guest requested a flush or once they have
+ * been dirty for COMMIT_INTERVAL, so that the flushes of a save are coalesced into a single commit.
+ * They are also committed when the last file using the cache is released, on the commit runner if
+ * there is one. All the files opened on the same host path share a single cache, so archives must
+ * let the caches know when they rename or delete their files. A cache whose file grows past
+ * MAX_FILE_SIZE falls back to accessing the host file directly.
+ */
+class WriteBackCache : NonCopyable {
+public:
+    struct Stats {
+        u64 guest_writes = 0; ///< Number of writes absorbed by the cache
+        u64 commits = 0;      ///< Number of times the contents were written to the host
+    };
+
+    /// Files larger than this are not cached and are accessed directly.
+    static constexpr u64 MAX_FILE_SIZE = 16 * 1024 * 1024;
+
+    /// Maximum time dirty contents stay in memory.
+    static constexpr std::chrono::seconds COMMIT_INTERVAL{5};
+
+    /// Function running a commit in the background.
+    using CommitRunner = std::function<void(std::function<void()>)>;
+
+    /**
+     * Gets the cache of a host file, loading its contents from the given opened file if no other
+     * file uses the cache yet. The cache is released when the returned pointer is destroyed.
+     * @param path Host path of the file
+     * @param file The file opened at that path
+     * @return The cache, or nullptr if the file is too large or could not be read
+     */
+    static std::shared_ptr<WriteBackCache> Open(const std::string& path, FileUtil::IOFile& file);
+
+    /**
+     * Renames a host file or directory, moving the caches of the files it contains along.
+     * @return true on success
+     */
+    static bool Rename(const std::string& src_path, const std::string& dest_path);
+
+    /**
+     * Detaches the caches of a host file or directory that was deleted, so that a file created
+     * again at the same path does not see the old contents. The files still using a detached cache
+     * keep their contents, which are never committed.
+     * @param path Host path of the file or directory
+     */
+    static void Invalidate(const std::string& path);
+
+    /// Commits the contents of all the caches flushed by the guest or dirty for COMMIT_INTERVAL.
+    static void CommitExpired();
+
+    /**
+     * Sets the function running the commits of the released caches, so that closing a file does
+     * not wait for the host storage. Without a runner they are committed on the releasing thread.
+     */
+    static void SetCommitRunner(CommitRunner runner);
+
+    std::size_t Read(u64 offset, std::size_t length, u8* buffer);
+    std::size_t Write(u64 offset, std::size_t length, bool flush, const u8* buffer);
+    u64 GetSize();
+    void SetSize(u64 size);
+
+    /// Requests the dirty contents to be committed by the next CommitExpired.
+    void Flush();
+
+    /**
+     * Writes the contents to the host if they changed since the last commit.
+     * @return true if the host file is up to date
+     */
+    bool Commit();
+
+    Stats GetStats();
+
+    ~WriteBackCache();
+
+private:
+    WriteBackCache(std::string path, std::vector<u8> data);
+
+    /// Releases a user of a cache, committing and destroying it if it was the last.
+    static void Release(const std::shared_ptr<WriteBackCache>& cache);
+
+    /// Detaches the caches of a file or directory, the mutex of the caches must be held.
+    static void DetachLocked(const std::string& path);
+
+    /// Commits a released cache, and forgets it if it was not opened again in the meantime.
+    static void CommitReleased(const std::shared_ptr<WriteBackCache>& cache);
+
+    void MarkDirty();
+    bool CommitLocked();
+
+    /**
+     * Makes sure the file can grow up to the given size, committing the contents and switching to
+     * the direct access of the host file if the size is above MAX_FILE_SIZE.
+     * @return false if the file can not grow that much
+     */
+    bool ReserveLocked(u64 size);
+
+    std::mutex mutex;
+    std::string path;
+    std::vector<u8> data;
+    std::unique_ptr<FileUtil::IOFile> direct_file; ///< Replaces `data` once the file is too large
+    std::size_t users = 0;                         ///< Guarded by the mutex of the caches
+    bool detached = false;
+    bool dirty = false;
+    bool flush_requested = false; ///< The guest flushed the dirty contents
+    std::chrono::steady_clock::time_point dirty_since;
+    Stats stats;
+};
+
+} // namespace FileSys
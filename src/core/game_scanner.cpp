@@ -0,0 +1,353 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <thread>
+#include "common/common_paths.h"
+#include "common/compression.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/game_scanner.h"
+#include "core/hle/service/am/am.h"
+#include "core/hle/service/fs/archive.h"
+
+namespace Core {
+
+namespace {
+
+/**
+ * The metadata cache is a header followed by one record per file:
+ *  - u32 path length, path
+ *  - u64 size, s64 modification time
+ *  - u64 program ID, u64 extdata ID, u32 file type
+ *  - u32 SMDH size, u32 stored SMDH size, stored SMDH
+ * The SMDH is LZ compressed unless that does not make it smaller, the titles are mostly padding.
+ */
+constexpr std::array<char, 4> CACHE_MAGIC{{'C', 'G', 'L', 'C'}};
+constexpr u32 CACHE_VERSION = 1;
+
+/// Serializes the writes of the cache files of all the scanners.
+std::mutex cache_file_mutex;
+
+class CacheWriter {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        WriteBytes(&value, sizeof(T));
+    }
+
+    void WriteBytes(const void* data, std::size_t size) {
+        const u8* bytes = static_cast<const u8*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    const std::vector<u8>& GetBuffer() const {
+        return buffer;
+    }
+
+private:
+    std::vector<u8> buffer;
+};
+
+class CacheReader {
+public:
+    explicit CacheReader(const std::vector<u8>& buffer) : buffer(buffer) {}
+
+    template <typename T>
+    bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+        return ReadBytes(&value, sizeof(T));
+    }
+
+    bool ReadBytes(void* data, std::size_t size) {
+        if (size > buffer.size() - position)
+            return false;
+        std::memcpy(data, buffer.data() + position, size);
+        position += size;
+        return true;
+    }
+
+    bool AtEnd() const {
+        return position == buffer.size();
+    }
+
+private:
+    const std::vector<u8>& buffer;
+    std::size_t position = 0;
+};
+
+bool IsUpdatableProgram(u64 program_id) {
+    return program_id >= 0x0004000000000000 && program_id <= 0x00040000FFFFFFFF;
+}
+
+} // namespace
+
+GameScanner::GameScanner(std::vector<std::string> extensions_, std::string cache_path_)
+    : extensions(std::move(extensions_)), cache_path(std::move(cache_path_)),
+      pool(std::thread::hardware_concurrency(), "GameScanner") {}
+
+GameScanner::~GameScanner() = default;
+
+void GameScanner::ScanDirectory(const std::string& directory, unsigned int recursion,
+                                const DirectoryCallback& directory_callback,
+                                const GameCallback& game_callback) {
+    if (!cache_loaded) {
+        LoadCache();
+        cache_loaded = true;
+    }
+
+    std::vector<std::string> files;
+    CollectFiles(directory, recursion, directory_callback, files);
+
+    // The metadata is read out of order by the workers, and reported in order from here
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<GameEntry> entries(files.size());
+    std::vector<bool> done(files.size(), false);
+
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        pool.Push([this, i, &files, &entries, &done, &mutex, &cv] {
+            GameEntry entry;
+            if (!stop_processing)
+                entry = ReadGameEntry(files[i]);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            entries[i] = std::move(entry);
+            done[i] = true;
+            cv.notify_all();
+        });
+    }
+
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        GameEntry entry;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&done, i] { return done[i]; });
+            entry = std::move(entries[i]);
+        }
+
+        if (!stop_processing && entry.file_type != Loader::FileType::Error &&
+            entry.file_type != Loader::FileType::Unknown) {
+            game_callback(entry);
+        }
+    }
+
+    pool.WaitForIdle();
+}
+
+void GameScanner::Cancel() {
+    stop_processing = true;
+}
+
+void GameScanner::CollectFiles(const std::string& directory, unsigned int recursion,
+                               const DirectoryCallback& directory_callback,
+                               std::vector<std::string>& files) {
+    const auto callback = [&](u64* num_entries_out, const std::string& parent,
+                              const std::string& virtual_name) -> bool {
+        if (stop_processing)
+            return false; // Breaks the callback loop.
+
+        const std::string physical_name = parent + DIR_SEP + virtual_name;
+        if (FileUtil::IsDirectory(physical_name)) {
+            if (recursion > 0) {
+                directory_callback(physical_name);
+                CollectFiles(physical_name, recursion - 1, directory_callback, files);
+            }
+            return true;
+        }
+
+        const std::size_t dot = virtual_name.rfind('.');
+        if (dot == std::string::npos)
+            return true;
+        std::string extension = virtual_name.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (std::find(extensions.begin(), extensions.end(), extension) != extensions.end())
+            files.push_back(physical_name);
+        return true;
+    };
+
+    FileUtil::ForeachDirectoryEntry(nullptr, directory, callback);
+}
+
+GameEntry GameScanner::GetMetadata(const std::string& path) {
+    const u64 size = FileUtil::GetSize(path);
+    const s64 modification_time = FileUtil::GetModificationTime(path);
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        const auto itr = cache.find(path);
+        if (itr != cache.end() && itr->second.size == size &&
+            itr->second.modification_time == modification_time) {
+            itr->second.used = true;
+            return itr->second.entry;
+        }
+    }
+
+    GameEntry entry;
+    entry.path = path;
+    entry.size = size;
+
+    std::unique_ptr<Loader::AppLoader> loader = Loader::GetLoader(path);
+    if (loader != nullptr) {
+        entry.file_type = loader->GetFileType();
+        loader->ReadProgramId(entry.program_id);
+        loader->ReadExtdataId(entry.extdata_id);
+        loader->ReadIcon(entry.smdh);
+    } else {
+        // Files that can not be loaded are cached too, so that they are not opened again
+        entry.file_type = Loader::FileType::Error;
+    }
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache[path] = CacheEntry{size, modification_time, entry, true};
+    cache_dirty = true;
+    return entry;
+}
+
+GameEntry GameScanner::ReadGameEntry(const std::string& path) {
+    GameEntry entry = GetMetadata(path);
+    if (entry.file_type == Loader::FileType::Error || !IsUpdatableProgram(entry.program_id))
+        return entry;
+
+    // Updates are installed separately from the game, check for one on every scan
+    const std::string update_path = Service::AM::GetTitleContentPath(
+        Service::FS::MediaType::SDMC, entry.program_id + 0x0000000E00000000);
+    if (!FileUtil::Exists(update_path))
+        return entry;
+
+    GameEntry update = GetMetadata(update_path);
+    if (update.file_type != Loader::FileType::Error)
+        entry.smdh = std::move(update.smdh);
+    return entry;
+}
+
+void GameScanner::LoadCache() {
+    if (cache_path.empty() || !FileUtil::Exists(cache_path))
+        return;
+
+    std::vector<u8> buffer;
+    {
+        std::lock_guard<std::mutex> lock(cache_file_mutex);
+        FileUtil::IOFile file(cache_path, "rb");
+        buffer.resize(file.GetSize());
+        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
+            LOG_WARNING(Frontend, "Could not read the game list cache {}", cache_path);
+            return;
+        }
+    }
+
+    CacheReader reader(buffer);
+    std::array<char, 4> magic;
+    u32 version;
+    if (!reader.Read(magic) || magic != CACHE_MAGIC || !reader.Read(version) ||
+        version != CACHE_VERSION) {
+        LOG_INFO(Frontend, "Ignoring outdated game list cache {}", cache_path);
+        return;
+    }
+
+    std::vector<u8> stored_smdh;
+    while (!reader.AtEnd()) {
+        CacheEntry cache_entry{};
+        GameEntry& entry = cache_entry.entry;
+        u32 path_size, file_type, smdh_size, stored_smdh_size;
+
+        bool valid = reader.Read(path_size);
+        if (valid) {
+            entry.path.resize(path_size);
+            valid = reader.ReadBytes(entry.path.data(), path_size);
+        }
+        valid = valid && reader.Read(cache_entry.size) &&
+                reader.Read(cache_entry.modification_time) && reader.Read(entry.program_id) &&
+                reader.Read(entry.extdata_id) && reader.Read(file_type) &&
+                reader.Read(smdh_size) && reader.Read(stored_smdh_size) &&
+                stored_smdh_size <= smdh_size;
+        if (valid) {
+            stored_smdh.resize(stored_smdh_size);
+            entry.smdh.resize(smdh_size);
+            valid = reader.ReadBytes(stored_smdh.data(), stored_smdh_size);
+            if (valid && stored_smdh_size == smdh_size) {
+                entry.smdh = stored_smdh;
+            } else if (valid) {
+                valid = Common::Compression::DecompressLZ(stored_smdh.data(), stored_smdh_size,
+                                                          entry.smdh.data(), smdh_size);
+            }
+        }
+
+        if (!valid) {
+            LOG_WARNING(Frontend, "Game list cache {} is corrupted", cache_path);
+            cache.clear();
+            return;
+        }
+
+        entry.size = cache_entry.size;
+        entry.file_type = static_cast<Loader::FileType>(file_type);
+        cache.emplace(entry.path, std::move(cache_entry));
+    }
+
+    LOG_DEBUG(Frontend, "Loaded {} entries from the game list cache", cache.size());
+}
+
+void GameScanner::SaveCache() {
+    // A cancelled scan did not mark all the files of the game list as used
+    if (cache_path.empty() || stop_processing)
+        return;
+
+    CacheWriter writer;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        // Forget the files that are no longer in the game list
+        for (auto itr = cache.begin(); itr != cache.end();) {
+            if (!itr->second.used) {
+                itr = cache.erase(itr);
+                cache_dirty = true;
+            } else {
+                ++itr;
+            }
+        }
+
+        if (!cache_dirty)
+            return;
+        cache_dirty = false;
+
+        writer.Write(CACHE_MAGIC);
+        writer.Write(CACHE_VERSION);
+        for (const auto& [path, cache_entry] : cache) {
+            const GameEntry& entry = cache_entry.entry;
+            writer.Write(static_cast<u32>(path.size()));
+            writer.WriteBytes(path.data(), path.size());
+            writer.Write(cache_entry.size);
+            writer.Write(cache_entry.modification_time);
+            writer.Write(entry.program_id);
+            writer.Write(entry.extdata_id);
+            writer.Write(static_cast<u32>(entry.file_type));
+
+            std::vector<u8> stored_smdh =
+                Common::Compression::CompressLZ(entry.smdh.data(), entry.smdh.size());
+            if (stored_smdh.size() >= entry.smdh.size())
+                stored_smdh = entry.smdh;
+            writer.Write(static_cast<u32>(entry.smdh.size()));
+            writer.Write(static_cast<u32>(stored_smdh.size()));
+            writer.WriteBytes(stored_smdh.data(), stored_smdh.size());
+        }
+    }
+
+    // Written to a temporary file first, so that an interrupted write does not lose the cache
+    std::lock_guard<std::mutex> lock(cache_file_mutex);
+    const std::string temp_path = cache_path + ".tmp";
+    const std::vector<u8>& buffer = writer.GetBuffer();
+    FileUtil::CreateFullPath(cache_path);
+    FileUtil::IOFile file(temp_path, "wb");
+    if (!file.IsOpen() || file.WriteBytes(buffer.data(), buffer.size()) != buffer.size() ||
+        !file.Close() || !FileUtil::Replace(temp_path, cache_path)) {
+        LOG_ERROR(Frontend, "Could not write the game list cache {}", cache_path);
+        file.Close();
+        FileUtil::Delete(temp_path);
+    }
+}
+
+} // namespace Core
@@ -0,0 +1,101 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "common/thread_pool.h"
+#include "core/loader/loader.h"
+
+namespace Core {
+
+/// Metadata of a game file, as displayed by the game lists of the frontends.
+struct GameEntry {
+    std::string path;
+    u64 size = 0;
+    u64 program_id = 0;
+    u64 extdata_id = 0;
+    Loader::FileType file_type = Loader::FileType::Unknown;
+    /// SMDH of the installed update of the game if there is one, of the game otherwise. Holds the
+    /// titles, icons and region. Empty if the game has none.
+    std::vector<u8> smdh;
+};
+
+/**
+ * Scans directories for games and reads their metadata on a pool of worker threads. The metadata
+ * is kept in a cache on disk keyed by the path, size and modification time of the files, so that
+ * unchanged files are not opened again on the next scans.
+ */
+class GameScanner {
+public:
+    using DirectoryCallback = std::function<void(const std::string& path)>;
+    using GameCallback = std::function<void(const GameEntry& entry)>;
+
+    /**
+     * @param extensions Lower case extensions, without the dot, of the files to scan
+     * @param cache_path Path of the metadata cache, an empty path disables the cache
+     */
+    GameScanner(std::vector<std::string> extensions, std::string cache_path);
+    ~GameScanner();
+
+    /**
+     * Scans a directory for games. The callbacks are run on the calling thread, and the games are
+     * reported in directory order.
+     * @param directory Directory to scan
+     * @param recursion Depth of the subdirectories to scan
+     * @param directory_callback Called for each scanned subdirectory
+     * @param game_callback Called for each game found
+     */
+    void ScanDirectory(const std::string& directory, unsigned int recursion,
+                       const DirectoryCallback& directory_callback,
+                       const GameCallback& game_callback);
+
+    /// Stops the scan in progress and the following ones. Thread-safe.
+    void Cancel();
+
+    /**
+     * Writes the metadata cache to disk. Only the files used by this scanner are kept, so this
+     * should be called after all the directories of the game list have been scanned.
+     */
+    void SaveCache();
+
+private:
+    struct CacheEntry {
+        u64 size;
+        s64 modification_time;
+        GameEntry entry; ///< Metadata read from the file itself, without the update SMDH
+        bool used;
+    };
+
+    void CollectFiles(const std::string& directory, unsigned int recursion,
+                      const DirectoryCallback& directory_callback,
+                      std::vector<std::string>& files);
+
+    /// Gets the metadata of a file from the cache, reading it from the file when it is outdated.
+    GameEntry GetMetadata(const std::string& path);
+
+    /// Reads the metadata of a game, including the SMDH of its update.
+    GameEntry ReadGameEntry(const std::string& path);
+
+    void LoadCache();
+
+    std::vector<std::string> extensions;
+    std::string cache_path;
+    std::atomic_bool stop_processing{false};
+
+    std::mutex cache_mutex;
+    std::unordered_map<std::string, CacheEntry> cache;
+    bool cache_loaded = false; ///< The cache is loaded by the first scan, on the scanning thread
+    bool cache_dirty = false;
+
+    Common::ThreadPool pool;
+};
+
+} // namespace Core
@@ -0,0 +1,149 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/hle/call_profiler.h"
+
+namespace HLE {
+
+/// Escapes the characters of a string that are not allowed inside a JSON string literal.
+static std::string EscapeJsonString(const std::string& str) {
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (const char c : str) {
+        if (c == '"' || c == '\\') {
+            escaped.push_back('\\');
+        }
+        if (static_cast<unsigned char>(c) >= 0x20) {
+            escaped.push_back(c);
+        }
+    }
+    return escaped;
+}
+
+static std::string CallStatsToJson(const CallProfiler::CallStats& stats) {
+    std::string histogram;
+    for (std::size_t i = 0; i < stats.histogram.size(); ++i) {
+        histogram += fmt::format("{}{}", i == 0 ? "" : ",", stats.histogram[i]);
+    }
+    return fmt::format("\"count\":{},\"total_ns\":{},\"max_ns\":{},\"p50_ns\":{},\"p99_ns\":{},"
+                       "\"histogram\":[{}]",
+                       stats.count, stats.total_ns, stats.max_ns,
+                       stats.EstimatePercentileNs(0.5), stats.EstimatePercentileNs(0.99),
+                       histogram);
+}
+
+u64 CallProfiler::CallStats::EstimatePercentileNs(double percentile) const {
+    const u64 target = static_cast<u64>(std::clamp(percentile, 0.0, 1.0) * count);
+    u64 seen = 0;
+    for (std::size_t i = 0; i < histogram.size(); ++i) {
+        seen += histogram[i];
+        if (seen > target || seen == count) {
+            return std::min(u64{1} << i, max_ns);
+        }
+    }
+    return max_ns;
+}
+
+void CallProfiler::Record(CallStats& stats, Clock::duration duration) {
+    const u64 ns = static_cast<u64>(
+        std::max<s64>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()));
+
+    std::size_t bucket = 0;
+    for (u64 value = ns; value != 0 && bucket < NUM_HISTOGRAM_BUCKETS - 1; value >>= 1) {
+        ++bucket;
+    }
+
+    stats.count++;
+    stats.total_ns += ns;
+    stats.max_ns = std::max(stats.max_ns, ns);
+    stats.histogram[bucket]++;
+}
+
+void CallProfiler::RecordServiceCall(const std::string& service_name, u32 command_id,
+                                     const char* function_name, Clock::duration duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto [itr, inserted] =
+        service_calls.try_emplace(std::make_tuple(service_name, command_id));
+    if (inserted) {
+        itr->second.service_name = service_name;
+        itr->second.command_id = command_id;
+        itr->second.function_name = function_name != nullptr ? function_name : "";
+    }
+    Record(itr->second.stats, duration);
+}
+
+void CallProfiler::RecordSVCCall(u32 svc_id, const char* svc_name, Clock::duration duration) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto [itr, inserted] = svc_calls.try_emplace(svc_id);
+    if (inserted) {
+        itr->second.svc_id = svc_id;
+        itr->second.svc_name = svc_name != nullptr ? svc_name : "";
+    }
+    Record(itr->second.stats, duration);
+}
+
+std::vector<CallProfiler::ServiceCallStats> CallProfiler::GetServiceCallStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<ServiceCallStats> result;
+    result.reserve(service_calls.size());
+    for (const auto& entry : service_calls) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+std::vector<CallProfiler::SVCCallStats> CallProfiler::GetSVCCallStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<SVCCallStats> result;
+    result.reserve(svc_calls.size());
+    for (const auto& entry : svc_calls) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+void CallProfiler::Reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    service_calls.clear();
+    svc_calls.clear();
+}
+
+bool CallProfiler::DumpToFile(const std::string& path) const {
+    std::string json = "{\"service_calls\":[";
+    bool first = true;
+    for (const auto& call : GetServiceCallStats()) {
+        json += fmt::format("{}\n{{\"service\":\"{}\",\"command_id\":{},\"function\":\"{}\",{}}}",
+                            first ? "" : ",", EscapeJsonString(call.service_name),
+                            call.command_id, EscapeJsonString(call.function_name),
+                            CallStatsToJson(call.stats));
+        first = false;
+    }
+    json += "],\"svc_calls\":[";
+    first = true;
+    for (const auto& call : GetSVCCallStats()) {
+        json += fmt::format("{}\n{{\"svc_id\":{},\"name\":\"{}\",{}}}", first ? "" : ",",
+                            call.svc_id, EscapeJsonString(call.svc_name),
+                            CallStatsToJson(call.stats));
+        first = false;
+    }
+    json += "]}\n";
+
+    FileUtil::IOFile file(path, "w");
+    if (!file.IsOpen() || file.WriteBytes(json.data(), json.size()) != json.size()) {
+        LOG_ERROR(Kernel, "Failed to write HLE call statistics to {}", path);
+        return false;
+    }
+    return true;
+}
+
+} // namespace HLE
@@ -0,0 +1,105 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "common/common_types.h"
+
+namespace HLE {
+
+/**
+ * Records how often HLE service commands and SVCs are called and how much host time they take.
+ * Recording is disabled by default; while disabled, the only cost on the call paths is a relaxed
+ * atomic load. All public functions of this class are thread-safe.
+ */
+class CallProfiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// Number of latency histogram buckets. Bucket i counts calls that took less than 2^i ns and
+    /// at least 2^(i-1) ns, the last bucket also counts every call longer than that.
+    static constexpr std::size_t NUM_HISTOGRAM_BUCKETS = 32;
+
+    struct CallStats {
+        /// Number of recorded calls
+        u64 count = 0;
+        /// Cumulative host time spent in the calls, in nanoseconds
+        u64 total_ns = 0;
+        /// Longest recorded call, in nanoseconds
+        u64 max_ns = 0;
+        /// Latency histogram, see NUM_HISTOGRAM_BUCKETS
+        std::array<u64, NUM_HISTOGRAM_BUCKETS> histogram{};
+
+        /**
+         * Estimates a latency percentile from the histogram.
+         * @param percentile Percentile to estimate, in the range [0, 1]
+         * @returns Upper bound of the histogram bucket the percentile falls in, in nanoseconds
+         */
+        u64 EstimatePercentileNs(double percentile) const;
+    };
+
+    struct ServiceCallStats {
+        std::string service_name;
+        /// Upper half of the command header, identifying the command
+        u32 command_id;
+        std::string function_name;
+        CallStats stats;
+    };
+
+    struct SVCCallStats {
+        u32 svc_id;
+        std::string svc_name;
+        CallStats stats;
+    };
+
+    bool IsEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    void SetEnabled(bool value) {
+        enabled.store(value, std::memory_order_relaxed);
+    }
+
+    /// Records a call to a HLE service command that took the specified amount of host time.
+    void RecordServiceCall(const std::string& service_name, u32 command_id,
+                           const char* function_name, Clock::duration duration);
+
+    /// Records a call to an SVC that took the specified amount of host time.
+    void RecordSVCCall(u32 svc_id, const char* svc_name, Clock::duration duration);
+
+    /// Returns a snapshot of the statistics of every service command called so far.
+    std::vector<ServiceCallStats> GetServiceCallStats() const;
+
+    /// Returns a snapshot of the statistics of every SVC called so far.
+    std::vector<SVCCallStats> GetSVCCallStats() const;
+
+    /// Discards all the recorded statistics.
+    void Reset();
+
+    /**
+     * Writes all the recorded statistics to a JSON file.
+     * @param path Path of the file to write on the host file system
+     * @returns Whether the file was written successfully
+     */
+    bool DumpToFile(const std::string& path) const;
+
+private:
+    static void Record(CallStats& stats, Clock::duration duration);
+
+    std::atomic<bool> enabled{false};
+
+    mutable std::mutex mutex;
+    std::map<std::tuple<std::string, u32>, ServiceCallStats> service_calls;
+    std::map<u32, SVCCallStats> svc_calls;
+};
+
+} // namespace HLE
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "common/common_types.h"
+#include "core/core.h"
 #include "core/hle/kernel/errors.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/thread.h"
 #include "core/memory.h"
 
@@ -24,8 +26,9 @@ static const int kCommandHeaderOffset = 0x80;
  * @return Pointer to command buffer
  */
 inline u32* GetCommandBuffer(const int offset = 0) {
-    return (u32*)Memory::GetPointer(GetCurrentThread()->GetTLSAddress() + kCommandHeaderOffset +
-                                    offset);
+    const Thread* thread =
+        Core::System::GetInstance().Kernel().GetThreadManager().GetCurrentThread();
+    return (u32*)Memory::GetPointer(thread->GetTLSAddress() + kCommandHeaderOffset + offset);
 }
 
 } // namespace Kernel
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <tuple>
 #include <type_traits>
@@ -93,8 +94,15 @@ public:
     template <typename... O>
     void PushMoveObjects(Kernel::SharedPtr<O>... pointers);
 
+    /// Pushes a copy of the buffer, in the static buffer of the context
     void PushStaticBuffer(const std::vector<u8>& buffer, u8 buffer_id);
 
+    /**
+     * Pushes a static buffer of `size` zeroed bytes, and returns its contents for the caller to
+     * write. The static buffer of the context is reused across requests, and only resized.
+     */
+    u8* PushStaticBuffer(std::size_t size, u8 buffer_id);
+
     /// Pushes an HLE MappedBuffer interface back to unmapped the buffer.
     void PushMappedBuffer(const Kernel::MappedBuffer& mapped_buffer);
 
@@ -182,11 +190,23 @@ inline void RequestBuilder::PushMoveObjects(Kernel::SharedPtr<O>... pointers) {
 inline void RequestBuilder::PushStaticBuffer(const std::vector<u8>& buffer, u8 buffer_id) {
     ASSERT_MSG(buffer_id < MAX_STATIC_BUFFERS, "Invalid static buffer id");
 
-    Push(StaticBufferDesc(buffer.size(), buffer_id));
+    // A handler returning the input static buffer of the same id has nothing to copy
+    if (&buffer == &context->GetStaticBuffer(buffer_id)) {
+        Push(StaticBufferDesc(buffer.size(), buffer_id));
+        Push<VAddr>(0xDEADC0DE);
+        return;
+    }
+    std::copy(buffer.begin(), buffer.end(), PushStaticBuffer(buffer.size(), buffer_id));
+}
+
+inline u8* RequestBuilder::PushStaticBuffer(std::size_t size, u8 buffer_id) {
+    ASSERT_MSG(buffer_id < MAX_STATIC_BUFFERS, "Invalid static buffer id");
+
+    Push(StaticBufferDesc(size, buffer_id));
     // This address will be replaced by the correct static buffer address during IPC translation.
     Push<VAddr>(0xDEADC0DE);
 
-    context->AddStaticBuffer(buffer_id, buffer);
+    return context->AddStaticBuffer(buffer_id, size);
 }
 
 inline void RequestBuilder::PushMappedBuffer(const Kernel::MappedBuffer& mapped_buffer) {
@@ -2,7 +2,6 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include <algorithm>
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "core/hle/kernel/address_arbiter.h"
@@ -18,55 +17,51 @@ namespace Kernel {
 
 void AddressArbiter::WaitThread(SharedPtr<Thread> thread, VAddr wait_address) {
     thread->wait_address = wait_address;
+    thread->waiting_arbiter = this;
     thread->status = ThreadStatus::WaitArb;
-    waiting_threads.emplace_back(std::move(thread));
+    const u32 priority = thread->current_priority;
+    waiting_threads.Push(wait_address, priority, std::move(thread));
 }
 
 void AddressArbiter::ResumeAllThreads(VAddr address) {
-    // Determine which threads are waiting on this address, those should be woken up.
-    auto itr = std::stable_partition(waiting_threads.begin(), waiting_threads.end(),
-                                     [address](const auto& thread) {
-                                         ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                                                    "Inconsistent AddressArbiter state");
-                                         return thread->wait_address != address;
-                                     });
-
-    // Wake up all the found threads
-    std::for_each(itr, waiting_threads.end(), [](auto& thread) { thread->ResumeFromWait(); });
-
-    // Remove the woken up threads from the wait list.
-    waiting_threads.erase(itr, waiting_threads.end());
+    // Wake up all the threads waiting on this address, in the order they started waiting.
+    for (auto& thread : waiting_threads.PopAll(address)) {
+        ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+        thread->waiting_arbiter = nullptr;
+        thread->ResumeFromWait();
+    }
 }
 
 SharedPtr<Thread> AddressArbiter::ResumeHighestPriorityThread(VAddr address) {
-    // Determine which threads are waiting on this address, those should be considered for wakeup.
-    auto matches_start = std::stable_partition(
-        waiting_threads.begin(), waiting_threads.end(), [address](const auto& thread) {
-            ASSERT_MSG(thread->status == ThreadStatus::WaitArb,
-                       "Inconsistent AddressArbiter state");
-            return thread->wait_address != address;
-        });
-
-    // Iterate through threads, find highest priority thread that is waiting to be arbitrated.
     // Note: The real kernel will pick the first thread in the list if more than one have the
-    // same highest priority value. Lower priority values mean higher priority.
-    auto itr = std::min_element(matches_start, waiting_threads.end(),
-                                [](const auto& lhs, const auto& rhs) {
-                                    return lhs->current_priority < rhs->current_priority;
-                                });
-
-    if (itr == waiting_threads.end())
+    // same highest priority value, the wait list keeps those in the order they started waiting.
+    auto thread = waiting_threads.PopHighestPriority(address);
+    if (thread == nullptr)
         return nullptr;
 
-    auto thread = *itr;
+    ASSERT_MSG(thread->status == ThreadStatus::WaitArb, "Inconsistent AddressArbiter state");
+    thread->waiting_arbiter = nullptr;
     thread->ResumeFromWait();
-
-    waiting_threads.erase(itr);
     return thread;
 }
 
+void AddressArbiter::RemoveWaitingThread(Thread* thread) {
+    waiting_threads.Remove(thread);
+    thread->waiting_arbiter = nullptr;
+}
+
+void AddressArbiter::UpdateThreadPriority(Thread* thread, u32 priority) {
+    waiting_threads.ChangePriority(thread, priority);
+}
+
 AddressArbiter::AddressArbiter(KernelSystem& kernel) : Object(kernel) {}
-AddressArbiter::~AddressArbiter() {}
+
+AddressArbiter::~AddressArbiter() {
+    // Threads still waiting on this arbiter can no longer be signaled through it.
+    for (auto& thread : waiting_threads.Clear()) {
+        thread->waiting_arbiter = nullptr;
+    }
+}
 
 SharedPtr<AddressArbiter> KernelSystem::CreateAddressArbiter(std::string name) {
     SharedPtr<AddressArbiter> address_arbiter(new AddressArbiter(*this));
@@ -83,8 +78,7 @@ ResultCode AddressArbiter::ArbitrateAddress(SharedPtr<Thread> thread, Arbitratio
                                    SharedPtr<WaitObject> object) {
         ASSERT(reason == ThreadWakeupReason::Timeout);
         // Remove the newly-awakened thread from the Arbiter's waiting list.
-        waiting_threads.erase(std::remove(waiting_threads.begin(), waiting_threads.end(), thread),
-                              waiting_threads.end());
+        RemoveWaitingThread(thread.get());
     };
 
     switch (type) {
@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <vector>
 #include "common/common_types.h"
+#include "core/hle/kernel/arbitration_queue.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/result.h"
 
@@ -62,10 +62,17 @@ private:
     /// the resumed thread.
     SharedPtr<Thread> ResumeHighestPriorityThread(VAddr address);
 
-    /// Threads waiting for the address arbiter to be signaled.
-    std::vector<SharedPtr<Thread>> waiting_threads;
+    /// Removes a thread from the wait list without resuming it.
+    void RemoveWaitingThread(Thread* thread);
+
+    /// Updates the position of a waiting thread in the wait list after its priority changed.
+    void UpdateThreadPriority(Thread* thread, u32 priority);
+
+    /// Threads waiting for the address arbiter to be signaled, indexed by arbitration address.
+    ArbitrationQueue<SharedPtr<Thread>> waiting_threads;
 
     friend class KernelSystem;
+    friend class Thread;
 };
 
 } // namespace Kernel
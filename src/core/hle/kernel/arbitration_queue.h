@@ -0,0 +1,173 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "common/assert.h"
+#include "common/common_types.h"
+
+namespace Kernel {
+
+/**
+ * Index of the waiters of an address arbiter. Waiters are grouped by arbitration address and kept
+ * ordered by priority within each address, so that waking up the best waiter of an address does
+ * not need to look at the waiters of any other address. Waiters with the same priority are woken
+ * up in the order they started waiting, which matches the behavior of the real kernel.
+ * Lower priority values mean higher priority.
+ *
+ * Insertion, removal and wakeup of a single waiter take O(log n) time, where n is the number of
+ * waiters on the same address.
+ *
+ * @tparam T Pointer-like type used to hold on to the waiters (e.g. SharedPtr<Thread>)
+ */
+template <typename T>
+class ArbitrationQueue {
+public:
+    /// Raw pointer type used to identify a waiter.
+    using Pointer = const std::remove_reference_t<decltype(*std::declval<T>())>*;
+
+    /// Returns the total number of waiters, across all addresses.
+    std::size_t Size() const {
+        return locations.size();
+    }
+
+    /// Returns the number of waiters waiting on the specified address.
+    std::size_t Count(VAddr address) const {
+        const auto itr = queues.find(address);
+        return itr == queues.end() ? 0 : itr->second.size();
+    }
+
+    /// Returns whether the specified waiter is in the queue.
+    bool Contains(Pointer waiter) const {
+        return locations.count(waiter) != 0;
+    }
+
+    /// Adds a waiter to the queue. The waiter must not already be in the queue.
+    void Push(VAddr address, u32 priority, T waiter) {
+        const Pointer key = std::addressof(*waiter);
+        const Location location{address, {priority, next_sequence++}};
+        const bool inserted = locations.emplace(key, location).second;
+        ASSERT_MSG(inserted, "Waiter is already waiting on an address");
+        queues[address].emplace(location.position, std::move(waiter));
+    }
+
+    /**
+     * Removes a waiter from the queue without waking it up.
+     * @returns Whether the waiter was in the queue
+     */
+    bool Remove(Pointer waiter) {
+        const auto location_itr = locations.find(waiter);
+        if (location_itr == locations.end())
+            return false;
+
+        const auto queue_itr = queues.find(location_itr->second.address);
+        queue_itr->second.erase(location_itr->second.position);
+        if (queue_itr->second.empty())
+            queues.erase(queue_itr);
+        locations.erase(location_itr);
+        return true;
+    }
+
+    /**
+     * Moves a waiter to its place for a new priority. The waiter keeps the place it got when it
+     * started waiting among the waiters with the new priority, like in the wait list of the real
+     * kernel. Nothing happens if the priority did not change.
+     */
+    void ChangePriority(Pointer waiter, u32 priority) {
+        const auto location_itr = locations.find(waiter);
+        if (location_itr == locations.end())
+            return;
+
+        Location& location = location_itr->second;
+        if (location.position.first == priority)
+            return;
+
+        auto& queue = queues.at(location.address);
+        auto node = queue.extract(location.position);
+        location.position.first = priority;
+        node.key() = location.position;
+        queue.insert(std::move(node));
+    }
+
+    /**
+     * Removes the highest priority waiter of an address from the queue.
+     * @returns The removed waiter, or a default-constructed T if nothing waits on the address
+     */
+    T PopHighestPriority(VAddr address) {
+        const auto queue_itr = queues.find(address);
+        if (queue_itr == queues.end())
+            return T{};
+
+        auto& queue = queue_itr->second;
+        T waiter = std::move(queue.begin()->second);
+        queue.erase(queue.begin());
+        if (queue.empty())
+            queues.erase(queue_itr);
+        locations.erase(std::addressof(*waiter));
+        return waiter;
+    }
+
+    /**
+     * Removes all the waiters of an address from the queue.
+     * @returns The removed waiters, in the order they started waiting
+     */
+    std::vector<T> PopAll(VAddr address) {
+        std::vector<T> waiters;
+        const auto queue_itr = queues.find(address);
+        if (queue_itr == queues.end())
+            return waiters;
+
+        std::vector<std::pair<u64, T>> entries;
+        entries.reserve(queue_itr->second.size());
+        for (auto& entry : queue_itr->second) {
+            locations.erase(std::addressof(*entry.second));
+            entries.emplace_back(entry.first.second, std::move(entry.second));
+        }
+        queues.erase(queue_itr);
+
+        std::sort(entries.begin(), entries.end(),
+                  [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+        waiters.reserve(entries.size());
+        for (auto& entry : entries) {
+            waiters.push_back(std::move(entry.second));
+        }
+        return waiters;
+    }
+
+    /// Removes all the waiters from the queue and returns them, in no particular order.
+    std::vector<T> Clear() {
+        std::vector<T> waiters;
+        waiters.reserve(Size());
+        for (auto& queue : queues) {
+            for (auto& entry : queue.second) {
+                waiters.push_back(std::move(entry.second));
+            }
+        }
+        queues.clear();
+        locations.clear();
+        return waiters;
+    }
+
+private:
+    /// Sort key of a waiter within its address: (priority, sequence number of its Push).
+    using Position = std::pair<u32, u64>;
+
+    struct Location {
+        VAddr address;
+        Position position;
+    };
+
+    std::unordered_map<VAddr, std::map<Position, T>> queues;
+    std::unordered_map<Pointer, Location> locations;
+    u64 next_sequence = 0;
+};
+
+} // namespace Kernel
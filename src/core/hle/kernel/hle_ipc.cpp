@@ -50,7 +50,8 @@ SharedPtr<Event> HLERequestContext::SleepClientThread(SharedPtr<Thread> thread,
         std::array<u32_le, IPC::COMMAND_BUFFER_LENGTH + 2 * IPC::MAX_STATIC_BUFFERS> cmd_buff;
         Memory::ReadBlock(*process, thread->GetCommandBufferAddress(), cmd_buff.data(),
                           cmd_buff.size() * sizeof(u32));
-        context.WriteToOutgoingCommandBuffer(cmd_buff.data(), *process, Kernel::g_handle_table);
+        context.WriteToOutgoingCommandBuffer(cmd_buff.data(), *process,
+                                             Core::System::GetInstance().Kernel().GetHandleTable());
         // Copy the translated command buffer back into the thread's command buffer area.
         Memory::WriteBlock(*process, thread->GetCommandBufferAddress(), cmd_buff.data(),
                            cmd_buff.size() * sizeof(u32));
@@ -75,6 +76,16 @@ HLERequestContext::HLERequestContext(SharedPtr<ServerSession> session)
 
 HLERequestContext::~HLERequestContext() = default;
 
+void HLERequestContext::Reset(SharedPtr<ServerSession> new_session) {
+    session = std::move(new_session);
+    cmd_buf[0] = 0;
+    request_handles.clear();
+    request_mapped_buffers.clear();
+    for (auto& buffer : static_buffers) {
+        buffer.clear();
+    }
+}
+
 SharedPtr<Object> HLERequestContext::GetIncomingHandle(u32 id_from_cmdbuf) const {
     ASSERT(id_from_cmdbuf < request_handles.size());
     return request_handles[id_from_cmdbuf];
@@ -97,6 +108,12 @@ void HLERequestContext::AddStaticBuffer(u8 buffer_id, std::vector<u8> data) {
     static_buffers[buffer_id] = std::move(data);
 }
 
+u8* HLERequestContext::AddStaticBuffer(u8 buffer_id, std::size_t size) {
+    auto& buffer = static_buffers[buffer_id];
+    buffer.assign(size, 0);
+    return buffer.data();
+}
+
 ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* src_cmdbuf,
                                                                 Process& src_process,
                                                                 HandleTable& src_table) {
@@ -141,11 +158,12 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(const u32_le* sr
             VAddr source_address = src_cmdbuf[i];
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
+            // Copy the input buffer into our own storage, reusing any memory that is left over
+            // from a previous request.
+            auto& data = static_buffers[buffer_info.buffer_id];
+            data.resize(buffer_info.size);
             Memory::ReadBlock(src_process, source_address, data.data(), data.size());
 
-            AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
         }
@@ -252,4 +270,12 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     Memory::WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+u8* MappedBuffer::GetContiguousPointer() const {
+    return Memory::GetContiguousPointer(*process, address, size);
+}
+
+std::shared_ptr<void> MappedBuffer::PinMemory() const {
+    return process->PinMemory();
+}
+
 } // namespace Kernel
@@ -100,6 +100,21 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+
+    /**
+     * Gets a pointer to the host memory backing the whole buffer, which can be used instead of
+     * Read/Write to access it without intermediate copies.
+     * @returns The host pointer, or nullptr if the buffer isn't backed by contiguous host memory,
+     * in which case Read/Write must be used.
+     */
+    u8* GetContiguousPointer() const;
+
+    /**
+     * Keeps the host memory returned by GetContiguousPointer valid until the returned object is
+     * destroyed, so that it can be accessed from another host thread while the guest runs.
+     */
+    std::shared_ptr<void> PinMemory() const;
+
     std::size_t GetSize() const {
         return size;
     }
@@ -157,6 +172,15 @@ public:
     HLERequestContext(SharedPtr<ServerSession> session);
     ~HLERequestContext();
 
+    /**
+     * Discards all the state of the previous request and binds the context to a new session. The
+     * storage of the static buffers is kept, so a context that is reused for many requests does
+     * not need to allocate memory for them again.
+     * @param session The session through which the next request is made, or nullptr to simply
+     * release the objects referenced by the previous request.
+     */
+    void Reset(SharedPtr<ServerSession> session);
+
     /// Returns a pointer to the IPC command buffer for this request.
     u32* CommandBuffer() {
         return cmd_buf.data();
@@ -219,6 +243,13 @@ public:
      */
     void AddStaticBuffer(u8 buffer_id, std::vector<u8> data);
 
+    /**
+     * Sets up a static buffer of `size` zeroed bytes that will be copied to the target process
+     * when the request is translated, and returns its contents to be written. The storage of each
+     * static buffer is kept across requests, so this only allocates when the buffer grows.
+     */
+    u8* AddStaticBuffer(u8 buffer_id, std::size_t size);
+
     /**
      * Gets a memory interface by the id from the request command buffer. See the "HLE mapped buffer
      * protocol" section in the class documentation for more details.
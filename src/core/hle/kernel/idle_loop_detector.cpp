@@ -0,0 +1,43 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "core/hle/kernel/idle_loop_detector.h"
+
+namespace Kernel {
+
+/// Returns whether the SVC may be part of a guest polling loop without making progress
+static bool IsPollingSVC(u32 immediate) {
+    switch (immediate) {
+    case 0x0A: // SleepThread
+    case 0x24: // WaitSynchronization1
+    case 0x25: // WaitSynchronizationN
+        return true;
+    default:
+        // GetSystemTick is not a poll, busy timing loops call it while working
+        return false;
+    }
+}
+
+void IdleLoopDetector::OnSVC(u32 immediate) {
+    if (!IsPollingSVC(immediate))
+        Reset();
+}
+
+void IdleLoopDetector::Reset() {
+    *this = {};
+}
+
+bool IdleLoopDetector::OnFruitlessPoll(const Thread* polling_thread, VAddr polling_pc,
+                                       u64 ticks) {
+    if (polling_thread != thread || polling_pc != pc || poll_count == 0 ||
+        ticks - last_poll_ticks > MAX_POLL_INTERVAL) {
+        thread = polling_thread;
+        pc = polling_pc;
+        poll_count = 0;
+    }
+    last_poll_ticks = ticks;
+    return ++poll_count >= POLL_THRESHOLD;
+}
+
+} // namespace Kernel
@@ -0,0 +1,52 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace Kernel {
+
+class Thread;
+
+/**
+ * Detects guest threads spinning in an idle loop: the same thread polling from the same place with
+ * SVCs that make no progress, such as a zero-timeout wait that times out, with nothing else in
+ * between.
+ */
+class IdleLoopDetector {
+public:
+    /// Number of consecutive fruitless polls after which a thread is considered to be idle-looping
+    static constexpr u32 POLL_THRESHOLD = 4;
+
+    /// Maximum number of ticks between two polls of an idle loop, a thread taking longer does work
+    static constexpr u64 MAX_POLL_INTERVAL = 1000;
+
+    /// Called on every SVC, forgets the idle loop in progress if the SVC is not a poll.
+    void OnSVC(u32 immediate);
+
+    /// Forgets the idle loop in progress, called whenever the guest makes progress.
+    void Reset();
+
+    /**
+     * Records a poll that made no progress.
+     * @param thread The thread that issued the poll
+     * @param pc Address the poll was issued from
+     * @param ticks Current CPU tick count
+     * @returns Whether the thread is spinning in an idle loop
+     */
+    bool OnFruitlessPoll(const Thread* thread, VAddr pc, u64 ticks);
+
+private:
+    /// Thread that issued the last fruitless poll
+    const Thread* thread = nullptr;
+    /// Address the last fruitless poll was issued from
+    VAddr pc = 0;
+    /// Tick count at the last fruitless poll
+    u64 last_poll_ticks = 0;
+    /// Number of consecutive fruitless polls issued by that thread from that address
+    u32 poll_count = 0;
+};
+
+} // namespace Kernel
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include "common/alignment.h"
+#include "core/core.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/ipc.h"
@@ -19,6 +20,7 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
 
     auto& src_process = src_thread->owner_process;
     auto& dst_process = dst_thread->owner_process;
+    HandleTable& handle_table = Core::System::GetInstance().Kernel().GetHandleTable();
 
     IPC::Header header;
     // TODO(Subv): Replace by Memory::Read32 when possible.
@@ -60,9 +62,9 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
                 } else if (handle == CurrentProcess) {
                     object = src_process;
                 } else if (handle != 0) {
-                    object = g_handle_table.GetGeneric(handle);
+                    object = handle_table.GetGeneric(handle);
                     if (descriptor == IPC::DescriptorType::MoveHandle) {
-                        g_handle_table.Close(handle);
+                        handle_table.Close(handle);
                     }
                 }
 
@@ -73,7 +75,7 @@ ResultCode TranslateCommandBuffer(SharedPtr<Thread> src_thread, SharedPtr<Thread
                     continue;
                 }
 
-                auto result = g_handle_table.Create(std::move(object));
+                auto result = handle_table.Create(std::move(object));
                 cmd_buf[i++] = result.ValueOr(0);
             }
             break;
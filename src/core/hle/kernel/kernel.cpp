@@ -18,25 +18,23 @@ namespace Kernel {
 KernelSystem::KernelSystem(u32 system_mode) {
     ConfigMem::Init();
 
-    Kernel::MemoryInit(system_mode);
+    MemoryInit(system_mode);
 
+    handle_table = std::make_unique<HandleTable>(*this);
     resource_limits = std::make_unique<ResourceLimitList>(*this);
-    Kernel::ThreadingInit();
-    Kernel::TimersInit();
-    // TODO(Subv): Start the process ids from 10 for now, as lower PIDs are
-    // reserved for low-level services
-    Process::next_process_id = 10;
+    thread_manager = std::make_unique<ThreadManager>(*this);
+    timer_manager = std::make_unique<TimerManager>(*this);
 }
 
 /// Shutdown the kernel
 KernelSystem::~KernelSystem() {
-    g_handle_table.Clear(); // Free all kernel objects
+    handle_table->Clear(); // Free all kernel objects
 
-    Kernel::ThreadingShutdown();
-    g_current_process = nullptr;
+    thread_manager.reset();
+    process_list.clear();
+    current_process = nullptr;
 
-    Kernel::TimersShutdown();
-    Kernel::MemoryShutdown();
+    timer_manager.reset();
 }
 
 ResourceLimitList& KernelSystem::ResourceLimit() {
@@ -51,4 +49,40 @@ u32 KernelSystem::GenerateObjectID() {
     return next_object_id++;
 }
 
+SharedPtr<Process> KernelSystem::GetCurrentProcess() const {
+    return current_process;
+}
+
+void KernelSystem::SetCurrentProcess(SharedPtr<Process> process) {
+    current_process = std::move(process);
+}
+
+ThreadManager& KernelSystem::GetThreadManager() {
+    return *thread_manager;
+}
+
+const ThreadManager& KernelSystem::GetThreadManager() const {
+    return *thread_manager;
+}
+
+TimerManager& KernelSystem::GetTimerManager() {
+    return *timer_manager;
+}
+
+const TimerManager& KernelSystem::GetTimerManager() const {
+    return *timer_manager;
+}
+
+IdleLoopDetector& KernelSystem::GetIdleLoopDetector() {
+    return idle_loop_detector;
+}
+
+HandleTable& KernelSystem::GetHandleTable() {
+    return *handle_table;
+}
+
+const HandleTable& KernelSystem::GetHandleTable() const {
+    return *handle_table;
+}
+
 } // namespace Kernel
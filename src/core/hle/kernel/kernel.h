@@ -4,17 +4,22 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 #include "common/common_types.h"
+#include "core/hle/kernel/idle_loop_detector.h"
+#include "core/hle/kernel/memory.h"
 #include "core/hle/result.h"
 
 namespace Kernel {
 
 class AddressArbiter;
 class Event;
+class HandleTable;
 class Mutex;
 class CodeSet;
 class Process;
@@ -27,6 +32,8 @@ class ClientSession;
 class ServerSession;
 class ResourceLimitList;
 class SharedMemory;
+class ThreadManager;
+class TimerManager;
 
 enum class ResetType {
     OneShot,
@@ -180,9 +187,52 @@ public:
 
     u32 GenerateObjectID();
 
+    /// Retrieves a process from the current list of processes.
+    SharedPtr<Process> GetProcessById(u32 process_id) const;
+
+    SharedPtr<Process> GetCurrentProcess() const;
+    void SetCurrentProcess(SharedPtr<Process> process);
+
+    ThreadManager& GetThreadManager();
+    const ThreadManager& GetThreadManager() const;
+
+    TimerManager& GetTimerManager();
+    const TimerManager& GetTimerManager() const;
+
+    IdleLoopDetector& GetIdleLoopDetector();
+
+    HandleTable& GetHandleTable();
+    const HandleTable& GetHandleTable() const;
+
+    /// Gets the information of one of the regions of the FCRAM.
+    MemoryRegionInfo* GetMemoryRegion(MemoryRegion region);
+
+    /// Gets the information of the APPLICATION, SYSTEM and BASE regions of the FCRAM.
+    const std::array<MemoryRegionInfo, 3>& GetMemoryRegions() const;
+
 private:
+    /// Lays out the memory regions of the FCRAM for a system memory configuration type.
+    void MemoryInit(u32 mem_type);
+
     std::unique_ptr<ResourceLimitList> resource_limits;
     std::atomic<u32> next_object_id{0};
+
+    // TODO(Subv): Start the process ids from 10 for now, as lower PIDs are
+    // reserved for low-level services
+    u32 next_process_id = 10;
+
+    // Lists all processes that exist in the current session.
+    std::vector<SharedPtr<Process>> process_list;
+
+    SharedPtr<Process> current_process;
+
+    std::unique_ptr<ThreadManager> thread_manager;
+    std::unique_ptr<TimerManager> timer_manager;
+
+    IdleLoopDetector idle_loop_detector;
+
+    std::unique_ptr<HandleTable> handle_table;
+    std::array<MemoryRegionInfo, 3> memory_regions;
 };
 
 } // namespace Kernel
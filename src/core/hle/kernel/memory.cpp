@@ -13,7 +13,9 @@
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/hle/config_mem.h"
+#include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/memory.h"
+#include "core/hle/kernel/process.h"
 #include "core/hle/kernel/vm_manager.h"
 #include "core/hle/result.h"
 #include "core/memory.h"
@@ -23,8 +25,6 @@
 
 namespace Kernel {
 
-MemoryRegionInfo memory_regions[3];
-
 /// Size of the APPLICATION, SYSTEM and BASE memory regions (respectively) for each system
 /// memory configuration type.
 static const u32 memory_region_sizes[8][3] = {
@@ -41,7 +41,7 @@ static const u32 memory_region_sizes[8][3] = {
     {0x0B200000, 0x02E00000, 0x02000000}, // 7
 };
 
-void MemoryInit(u32 mem_type) {
+void KernelSystem::MemoryInit(u32 mem_type) {
     // TODO(yuriks): On the n3DS, all o3DS configurations (<=5) are forced to 6 instead.
     ASSERT_MSG(mem_type <= 5, "New 3DS memory configuration aren't supported yet!");
     ASSERT(mem_type != 1);
@@ -73,16 +73,7 @@ void MemoryInit(u32 mem_type) {
     config_mem.base_mem_alloc = memory_regions[2].size;
 }
 
-void MemoryShutdown() {
-    for (auto& region : memory_regions) {
-        region.base = 0;
-        region.size = 0;
-        region.used = 0;
-        region.linear_heap_memory = nullptr;
-    }
-}
-
-MemoryRegionInfo* GetMemoryRegion(MemoryRegion region) {
+MemoryRegionInfo* KernelSystem::GetMemoryRegion(MemoryRegion region) {
     switch (region) {
     case MemoryRegion::APPLICATION:
         return &memory_regions[0];
@@ -95,6 +86,10 @@ MemoryRegionInfo* GetMemoryRegion(MemoryRegion region) {
     }
 }
 
+const std::array<MemoryRegionInfo, 3>& KernelSystem::GetMemoryRegions() const {
+    return memory_regions;
+}
+
 void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping) {
     using namespace Memory;
 
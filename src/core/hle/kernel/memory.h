@@ -5,12 +5,13 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 #include "common/common_types.h"
-#include "core/hle/kernel/process.h"
 
 namespace Kernel {
 
 class VMManager;
+struct AddressMapping;
 
 struct MemoryRegionInfo {
     u32 base; // Not an address, but offset from start of FCRAM
@@ -20,12 +21,7 @@ struct MemoryRegionInfo {
     std::shared_ptr<std::vector<u8>> linear_heap_memory;
 };
 
-void MemoryInit(u32 mem_type);
-void MemoryShutdown();
-MemoryRegionInfo* GetMemoryRegion(MemoryRegion region);
-
 void HandleSpecialMapping(VMManager& address_space, const AddressMapping& mapping);
 void MapSharedPages(VMManager& address_space);
 
-extern MemoryRegionInfo memory_regions[3];
 } // namespace Kernel
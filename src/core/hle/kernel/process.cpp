@@ -17,9 +17,6 @@
 
 namespace Kernel {
 
-// Lists all processes that exist in the current session.
-static std::vector<SharedPtr<Process>> process_list;
-
 SharedPtr<CodeSet> KernelSystem::CreateCodeSet(std::string name, u64 program_id) {
     SharedPtr<CodeSet> codeset(new CodeSet(*this));
 
@@ -32,8 +29,6 @@ SharedPtr<CodeSet> KernelSystem::CreateCodeSet(std::string name, u64 program_id)
 CodeSet::CodeSet(KernelSystem& kernel) : Object(kernel) {}
 CodeSet::~CodeSet() {}
 
-u32 Process::next_process_id;
-
 SharedPtr<Process> KernelSystem::CreateProcess(SharedPtr<CodeSet> code_set) {
     SharedPtr<Process> process(new Process(*this));
 
@@ -41,6 +36,7 @@ SharedPtr<Process> KernelSystem::CreateProcess(SharedPtr<CodeSet> code_set) {
     process->flags.raw = 0;
     process->flags.memory_region.Assign(MemoryRegion::APPLICATION);
     process->status = ProcessStatus::Created;
+    process->process_id = next_process_id++;
 
     process_list.push_back(process);
     return process;
@@ -119,7 +115,7 @@ void Process::ParseKernelCaps(const u32* kernel_caps, std::size_t len) {
 }
 
 void Process::Run(s32 main_thread_priority, u32 stack_size) {
-    memory_region = GetMemoryRegion(flags.memory_region);
+    memory_region = kernel.GetMemoryRegion(flags.memory_region);
 
     auto MapSegment = [&](CodeSet::Segment& segment, VMAPermission permissions,
                           MemoryState memory_state) {
@@ -184,7 +180,11 @@ ResultVal<VAddr> Process::HeapAllocate(VAddr target, u32 size, VMAPermission per
         heap_start = heap_end = target;
     }
 
-    // If necessary, expand backing vector to cover new heap extents.
+    // If necessary, expand backing vector to cover new heap extents. This may move it, so host
+    // threads that use pointers into it must be done first.
+    if (target < heap_start || target + size > heap_end) {
+        WaitForMemoryUnpinned();
+    }
     if (target < heap_start) {
         heap_memory->insert(begin(*heap_memory), heap_start - target, 0);
         heap_start = target;
@@ -304,14 +304,30 @@ ResultCode Process::LinearFree(VAddr target, u32 size) {
     return RESULT_SUCCESS;
 }
 
-Kernel::Process::Process(KernelSystem& kernel) : Object(kernel), kernel(kernel) {}
-Kernel::Process::~Process() {}
+std::shared_ptr<void> Process::PinMemory() const {
+    {
+        std::lock_guard<std::mutex> lock(memory_pins->mutex);
+        memory_pins->count++;
+    }
+    // The heap memory is kept alive too, in case the process exits while it is pinned
+    return std::shared_ptr<void>(nullptr, [pins = memory_pins, heap = heap_memory](void*) {
+        {
+            std::lock_guard<std::mutex> lock(pins->mutex);
+            pins->count--;
+        }
+        pins->released.notify_all();
+    });
+}
 
-void ClearProcessList() {
-    process_list.clear();
+void Process::WaitForMemoryUnpinned() const {
+    std::unique_lock<std::mutex> lock(memory_pins->mutex);
+    memory_pins->released.wait(lock, [this] { return memory_pins->count == 0; });
 }
 
-SharedPtr<Process> GetProcessById(u32 process_id) {
+Kernel::Process::Process(KernelSystem& kernel) : Object(kernel), kernel(kernel) {}
+Kernel::Process::~Process() {}
+
+SharedPtr<Process> KernelSystem::GetProcessById(u32 process_id) const {
     auto itr = std::find_if(
         process_list.begin(), process_list.end(),
         [&](const SharedPtr<Process>& process) { return process->process_id == process_id; });
@@ -321,6 +337,4 @@ SharedPtr<Process> GetProcessById(u32 process_id) {
 
     return *itr;
 }
-
-SharedPtr<Process> g_current_process;
 } // namespace Kernel
@@ -6,8 +6,10 @@
 
 #include <array>
 #include <bitset>
+#include <condition_variable>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <boost/container/static_vector.hpp>
@@ -123,8 +125,6 @@ public:
         return HANDLE_TYPE;
     }
 
-    static u32 next_process_id;
-
     SharedPtr<CodeSet> codeset;
     /// Resource limit descriptor for this process
     SharedPtr<ResourceLimit> resource_limit;
@@ -145,7 +145,7 @@ public:
     ProcessStatus status;
 
     /// The id of this process
-    u32 process_id = next_process_id++;
+    u32 process_id;
 
     /**
      * Parses a list of kernel capability descriptors (as found in the ExHeader) and applies them
@@ -192,18 +192,30 @@ public:
     ResultVal<VAddr> LinearAllocate(VAddr target, u32 size, VMAPermission perms);
     ResultCode LinearFree(VAddr target, u32 size);
 
+    /**
+     * Keeps the host memory backing the memory of this process in place until the returned object
+     * is destroyed, so that host pointers to it can be used from other host threads. Growing the
+     * heap, which may move its backing memory, waits until every pin has been released.
+     */
+    std::shared_ptr<void> PinMemory() const;
+
 private:
     explicit Process(Kernel::KernelSystem& kernel);
     ~Process() override;
 
+    /// Waits until no other host thread uses pointers to the memory of this process.
+    void WaitForMemoryUnpinned() const;
+
+    struct MemoryPins {
+        std::mutex mutex;
+        std::condition_variable released;
+        u32 count = 0;
+    };
+    /// Shared with the pins, which may outlive the process
+    std::shared_ptr<MemoryPins> memory_pins = std::make_shared<MemoryPins>();
+
     friend class KernelSystem;
     KernelSystem& kernel;
 };
 
-void ClearProcessList();
-
-/// Retrieves a process from the current list of processes.
-SharedPtr<Process> GetProcessById(u32 process_id);
-
-extern SharedPtr<Process> g_current_process;
 } // namespace Kernel
@@ -35,6 +35,7 @@
 #include "core/hle/lock.h"
 #include "core/hle/result.h"
 #include "core/hle/service/service.h"
+#include "core/settings.h"
 
 namespace Kernel {
 
@@ -83,7 +84,7 @@ static ResultCode ControlMemory(u32* out_addr, u32 operation, u32 addr0, u32 add
     }
     VMAPermission vma_permissions = (VMAPermission)permissions;
 
-    auto& process = *g_current_process;
+    auto& process = *Core::System::GetInstance().Kernel().GetCurrentProcess();
 
     switch (operation & MEMOP_OPERATION_MASK) {
     case MEMOP_FREE: {
@@ -145,19 +146,21 @@ static ResultCode ControlMemory(u32* out_addr, u32 operation, u32 addr0, u32 add
 }
 
 static void ExitProcess() {
-    LOG_INFO(Kernel_SVC, "Process {} exiting", g_current_process->process_id);
+    SharedPtr<Process> current_process = Core::System::GetInstance().Kernel().GetCurrentProcess();
+    LOG_INFO(Kernel_SVC, "Process {} exiting", current_process->process_id);
 
-    ASSERT_MSG(g_current_process->status == ProcessStatus::Running, "Process has already exited");
+    ASSERT_MSG(current_process->status == ProcessStatus::Running, "Process has already exited");
 
-    g_current_process->status = ProcessStatus::Exited;
+    current_process->status = ProcessStatus::Exited;
 
     // Stop all the process threads that are currently waiting for objects.
-    auto& thread_list = GetThreadList();
+    ThreadManager& thread_manager = Core::System::GetInstance().Kernel().GetThreadManager();
+    auto& thread_list = thread_manager.GetThreadList();
     for (auto& thread : thread_list) {
-        if (thread->owner_process != g_current_process)
+        if (thread->owner_process != current_process)
             continue;
 
-        if (thread == GetCurrentThread())
+        if (thread == thread_manager.GetCurrentThread())
             continue;
 
         // TODO(Subv): When are the other running/ready threads terminated?
@@ -169,19 +172,20 @@ static void ExitProcess() {
     }
 
     // Kill the current thread
-    GetCurrentThread()->Stop();
+    thread_manager.GetCurrentThread()->Stop();
 
     Core::System::GetInstance().PrepareReschedule();
 }
 
 /// Maps a memory block to specified address
 static ResultCode MapMemoryBlock(Handle handle, u32 addr, u32 permissions, u32 other_permissions) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC,
               "called memblock=0x{:08X}, addr=0x{:08X}, mypermissions=0x{:08X}, "
               "otherpermission={}",
               handle, addr, permissions, other_permissions);
 
-    SharedPtr<SharedMemory> shared_memory = g_handle_table.Get<SharedMemory>(handle);
+    SharedPtr<SharedMemory> shared_memory = kernel.GetHandleTable().Get<SharedMemory>(handle);
     if (shared_memory == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -195,7 +199,7 @@ static ResultCode MapMemoryBlock(Handle handle, u32 addr, u32 permissions, u32 o
     case MemoryPermission::WriteExecute:
     case MemoryPermission::ReadWriteExecute:
     case MemoryPermission::DontCare:
-        return shared_memory->Map(g_current_process.get(), addr, permissions_type,
+        return shared_memory->Map(kernel.GetCurrentProcess().get(), addr, permissions_type,
                                   static_cast<MemoryPermission>(other_permissions));
     default:
         LOG_ERROR(Kernel_SVC, "unknown permissions=0x{:08X}", permissions);
@@ -205,19 +209,21 @@ static ResultCode MapMemoryBlock(Handle handle, u32 addr, u32 permissions, u32 o
 }
 
 static ResultCode UnmapMemoryBlock(Handle handle, u32 addr) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called memblock=0x{:08X}, addr=0x{:08X}", handle, addr);
 
     // TODO(Subv): Return E0A01BF5 if the address is not in the application's heap
 
-    SharedPtr<SharedMemory> shared_memory = g_handle_table.Get<SharedMemory>(handle);
+    SharedPtr<SharedMemory> shared_memory = kernel.GetHandleTable().Get<SharedMemory>(handle);
     if (shared_memory == nullptr)
         return ERR_INVALID_HANDLE;
 
-    return shared_memory->Unmap(g_current_process.get(), addr);
+    return shared_memory->Unmap(kernel.GetCurrentProcess().get(), addr);
 }
 
 /// Connect to an OS service given the port name, returns the handle to the port to out
 static ResultCode ConnectToPort(Handle* out_handle, VAddr port_name_address) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     if (!Memory::IsValidVirtualAddress(port_name_address))
         return ERR_NOT_FOUND;
 
@@ -241,13 +247,14 @@ static ResultCode ConnectToPort(Handle* out_handle, VAddr port_name_address) {
     CASCADE_RESULT(client_session, client_port->Connect());
 
     // Return the client session
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(client_session));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(client_session));
     return RESULT_SUCCESS;
 }
 
 /// Makes a blocking IPC call to an OS service.
 static ResultCode SendSyncRequest(Handle handle) {
-    SharedPtr<ClientSession> session = g_handle_table.Get<ClientSession>(handle);
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<ClientSession> session = kernel.GetHandleTable().Get<ClientSession>(handle);
     if (session == nullptr) {
         return ERR_INVALID_HANDLE;
     }
@@ -256,19 +263,53 @@ static ResultCode SendSyncRequest(Handle handle) {
 
     Core::System::GetInstance().PrepareReschedule();
 
-    return session->SendSyncRequest(GetCurrentThread());
+    auto& thread_manager = kernel.GetThreadManager();
+    return session->SendSyncRequest(thread_manager.GetCurrentThread());
 }
 
 /// Close a handle
 static ResultCode CloseHandle(Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "Closing handle 0x{:08X}", handle);
-    return g_handle_table.Close(handle);
+    return kernel.GetHandleTable().Close(handle);
+}
+
+/// Forgets any idle loop in progress, called whenever the guest makes progress
+static void ResetIdleLoopDetection() {
+    Core::System::GetInstance().Kernel().GetIdleLoopDetector().Reset();
+}
+
+/**
+ * Records a poll that made no progress: a zero-timeout wait that timed out, or a zero-length sleep
+ * with no other thread to run. Once the same thread keeps doing this from the same place with
+ * nothing else in between it is spinning in an idle loop, and if enabled the rest of the timing
+ * slice is skipped so that emulation jumps straight to the next scheduled event instead of burning
+ * host cycles.
+ */
+static void OnFruitlessPoll() {
+    if (!Settings::values.skip_idle_loops)
+        return;
+
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    ThreadManager& thread_manager = kernel.GetThreadManager();
+    const bool idle_loop = kernel.GetIdleLoopDetector().OnFruitlessPoll(
+        thread_manager.GetCurrentThread(), Core::CPU().GetPC(), CoreTiming::GetTicks());
+    if (!idle_loop || thread_manager.HaveReadyThreads())
+        return;
+
+    const s64 skipped_cycles = CoreTiming::GetDowncount();
+    if (skipped_cycles <= 0)
+        return;
+
+    CoreTiming::Idle();
+    Core::System::GetInstance().perf_stats.AddIdleLoopSkip(static_cast<u64>(skipped_cycles));
 }
 
 /// Wait for a handle to synchronize, timeout after the specified nanoseconds
 static ResultCode WaitSynchronization1(Handle handle, s64 nano_seconds) {
-    auto object = g_handle_table.Get<WaitObject>(handle);
-    Thread* thread = GetCurrentThread();
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    auto object = kernel.GetHandleTable().Get<WaitObject>(handle);
+    Thread* thread = kernel.GetThreadManager().GetCurrentThread();
 
     if (object == nullptr)
         return ERR_INVALID_HANDLE;
@@ -278,9 +319,12 @@ static ResultCode WaitSynchronization1(Handle handle, s64 nano_seconds) {
 
     if (object->ShouldWait(thread)) {
 
-        if (nano_seconds == 0)
+        if (nano_seconds == 0) {
+            OnFruitlessPoll();
             return RESULT_TIMEOUT;
+        }
 
+        ResetIdleLoopDetection();
         thread->wait_objects = {object};
         object->AddWaitingThread(thread);
         thread->status = ThreadStatus::WaitSynchAny;
@@ -312,6 +356,7 @@ static ResultCode WaitSynchronization1(Handle handle, s64 nano_seconds) {
         return RESULT_TIMEOUT;
     }
 
+    ResetIdleLoopDetection();
     object->Acquire(thread);
 
     return RESULT_SUCCESS;
@@ -320,7 +365,8 @@ static ResultCode WaitSynchronization1(Handle handle, s64 nano_seconds) {
 /// Wait for the given handles to synchronize, timeout after the specified nanoseconds
 static ResultCode WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle_count,
                                        bool wait_all, s64 nano_seconds) {
-    Thread* thread = GetCurrentThread();
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    Thread* thread = kernel.GetThreadManager().GetCurrentThread();
 
     if (!Memory::IsValidVirtualAddress(handles_address))
         return ERR_INVALID_POINTER;
@@ -338,7 +384,7 @@ static ResultCode WaitSynchronizationN(s32* out, VAddr handles_address, s32 hand
 
     for (int i = 0; i < handle_count; ++i) {
         Handle handle = Memory::Read32(handles_address + i * sizeof(Handle));
-        auto object = g_handle_table.Get<WaitObject>(handle);
+        auto object = kernel.GetHandleTable().Get<WaitObject>(handle);
         if (object == nullptr)
             return ERR_INVALID_HANDLE;
         objects[i] = object;
@@ -349,6 +395,7 @@ static ResultCode WaitSynchronizationN(s32* out, VAddr handles_address, s32 hand
             std::all_of(objects.begin(), objects.end(),
                         [thread](const ObjectPtr& object) { return !object->ShouldWait(thread); });
         if (all_available) {
+            ResetIdleLoopDetection();
             // We can acquire all objects right now, do so.
             for (auto& object : objects)
                 object->Acquire(thread);
@@ -361,8 +408,12 @@ static ResultCode WaitSynchronizationN(s32* out, VAddr handles_address, s32 hand
 
         // If a timeout value of 0 was provided, just return the Timeout error code instead of
         // suspending the thread.
-        if (nano_seconds == 0)
+        if (nano_seconds == 0) {
+            OnFruitlessPoll();
             return RESULT_TIMEOUT;
+        }
+
+        ResetIdleLoopDetection();
 
         // Put the thread to sleep
         thread->status = ThreadStatus::WaitSynchAll;
@@ -406,6 +457,7 @@ static ResultCode WaitSynchronizationN(s32* out, VAddr handles_address, s32 hand
         });
 
         if (itr != objects.end()) {
+            ResetIdleLoopDetection();
             // We found a ready object, acquire it and set the result value
             WaitObject* object = itr->get();
             object->Acquire(thread);
@@ -417,8 +469,12 @@ static ResultCode WaitSynchronizationN(s32* out, VAddr handles_address, s32 hand
 
         // If a timeout value of 0 was provided, just return the Timeout error code instead of
         // suspending the thread.
-        if (nano_seconds == 0)
+        if (nano_seconds == 0) {
+            OnFruitlessPoll();
             return RESULT_TIMEOUT;
+        }
+
+        ResetIdleLoopDetection();
 
         // Put the thread to sleep
         thread->status = ThreadStatus::WaitSynchAny;
@@ -492,6 +548,7 @@ static ResultCode ReceiveIPCRequest(SharedPtr<ServerSession> server_session,
 /// In a single operation, sends a IPC reply and waits for a new request.
 static ResultCode ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_count,
                                   Handle reply_target) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     if (!Memory::IsValidVirtualAddress(handles_address))
         return ERR_INVALID_POINTER;
 
@@ -504,18 +561,20 @@ static ResultCode ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_
 
     for (int i = 0; i < handle_count; ++i) {
         Handle handle = Memory::Read32(handles_address + i * sizeof(Handle));
-        auto object = g_handle_table.Get<WaitObject>(handle);
+        auto object = kernel.GetHandleTable().Get<WaitObject>(handle);
         if (object == nullptr)
             return ERR_INVALID_HANDLE;
         objects[i] = object;
     }
 
+    auto thread = kernel.GetThreadManager().GetCurrentThread();
+
     // We are also sending a command reply.
     // Do not send a reply if the command id in the command buffer is 0xFFFF.
     u32* cmd_buff = GetCommandBuffer();
     IPC::Header header{cmd_buff[0]};
     if (reply_target != 0 && header.command_id != 0xFFFF) {
-        auto session = g_handle_table.Get<ServerSession>(reply_target);
+        auto session = kernel.GetHandleTable().Get<ServerSession>(reply_target);
         if (session == nullptr)
             return ERR_INVALID_HANDLE;
 
@@ -531,11 +590,11 @@ static ResultCode ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_
             return ERR_SESSION_CLOSED_BY_REMOTE;
         }
 
-        VAddr source_address = GetCurrentThread()->GetCommandBufferAddress();
+        VAddr source_address = thread->GetCommandBufferAddress();
         VAddr target_address = request_thread->GetCommandBufferAddress();
 
-        ResultCode translation_result = TranslateCommandBuffer(
-            Kernel::GetCurrentThread(), request_thread, source_address, target_address, true);
+        ResultCode translation_result =
+            TranslateCommandBuffer(thread, request_thread, source_address, target_address, true);
 
         // Note: The real kernel seems to always panic if the Server->Client buffer translation
         // fails for whatever reason.
@@ -555,8 +614,6 @@ static ResultCode ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_
         return RESULT_SUCCESS;
     }
 
-    auto thread = GetCurrentThread();
-
     // Find the first object that is acquirable in the provided list of objects
     auto itr = std::find_if(objects.begin(), objects.end(), [thread](const ObjectPtr& object) {
         return !object->ShouldWait(thread);
@@ -572,7 +629,7 @@ static ResultCode ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_
             return RESULT_SUCCESS;
 
         auto server_session = static_cast<ServerSession*>(object);
-        return ReceiveIPCRequest(server_session, GetCurrentThread());
+        return ReceiveIPCRequest(server_session, thread);
     }
 
     // No objects were ready to be acquired, prepare to suspend the thread.
@@ -615,8 +672,9 @@ static ResultCode ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_
 
 /// Create an address arbiter (to allocate access to shared resources)
 static ResultCode CreateAddressArbiter(Handle* out_handle) {
-    SharedPtr<AddressArbiter> arbiter = Core::System::GetInstance().Kernel().CreateAddressArbiter();
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(arbiter)));
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<AddressArbiter> arbiter = kernel.CreateAddressArbiter();
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(arbiter)));
     LOG_TRACE(Kernel_SVC, "returned handle=0x{:08X}", *out_handle);
     return RESULT_SUCCESS;
 }
@@ -624,15 +682,17 @@ static ResultCode CreateAddressArbiter(Handle* out_handle) {
 /// Arbitrate address
 static ResultCode ArbitrateAddress(Handle handle, u32 address, u32 type, u32 value,
                                    s64 nanoseconds) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called handle=0x{:08X}, address=0x{:08X}, type=0x{:08X}, value=0x{:08X}",
               handle, address, type, value);
 
-    SharedPtr<AddressArbiter> arbiter = g_handle_table.Get<AddressArbiter>(handle);
+    SharedPtr<AddressArbiter> arbiter = kernel.GetHandleTable().Get<AddressArbiter>(handle);
     if (arbiter == nullptr)
         return ERR_INVALID_HANDLE;
 
-    auto res = arbiter->ArbitrateAddress(GetCurrentThread(), static_cast<ArbitrationType>(type),
-                                         address, value, nanoseconds);
+    Thread* thread = kernel.GetThreadManager().GetCurrentThread();
+    auto res = arbiter->ArbitrateAddress(thread, static_cast<ArbitrationType>(type), address, value,
+                                         nanoseconds);
 
     // TODO(Subv): Identify in which specific cases this call should cause a reschedule.
     Core::System::GetInstance().PrepareReschedule();
@@ -673,13 +733,14 @@ static void OutputDebugString(VAddr address, int len) {
 
 /// Get resource limit
 static ResultCode GetResourceLimit(Handle* resource_limit, Handle process_handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called process=0x{:08X}", process_handle);
 
-    SharedPtr<Process> process = g_handle_table.Get<Process>(process_handle);
+    SharedPtr<Process> process = kernel.GetHandleTable().Get<Process>(process_handle);
     if (process == nullptr)
         return ERR_INVALID_HANDLE;
 
-    CASCADE_RESULT(*resource_limit, g_handle_table.Create(process->resource_limit));
+    CASCADE_RESULT(*resource_limit, kernel.GetHandleTable().Create(process->resource_limit));
 
     return RESULT_SUCCESS;
 }
@@ -687,11 +748,12 @@ static ResultCode GetResourceLimit(Handle* resource_limit, Handle process_handle
 /// Get resource limit current values
 static ResultCode GetResourceLimitCurrentValues(VAddr values, Handle resource_limit_handle,
                                                 VAddr names, u32 name_count) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called resource_limit={:08X}, names={:08X}, name_count={}",
               resource_limit_handle, names, name_count);
 
     SharedPtr<ResourceLimit> resource_limit =
-        g_handle_table.Get<ResourceLimit>(resource_limit_handle);
+        kernel.GetHandleTable().Get<ResourceLimit>(resource_limit_handle);
     if (resource_limit == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -707,11 +769,12 @@ static ResultCode GetResourceLimitCurrentValues(VAddr values, Handle resource_li
 /// Get resource limit max values
 static ResultCode GetResourceLimitLimitValues(VAddr values, Handle resource_limit_handle,
                                               VAddr names, u32 name_count) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called resource_limit={:08X}, names={:08X}, name_count={}",
               resource_limit_handle, names, name_count);
 
     SharedPtr<ResourceLimit> resource_limit =
-        g_handle_table.Get<ResourceLimit>(resource_limit_handle);
+        kernel.GetHandleTable().Get<ResourceLimit>(resource_limit_handle);
     if (resource_limit == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -727,20 +790,23 @@ static ResultCode GetResourceLimitLimitValues(VAddr values, Handle resource_limi
 /// Creates a new thread
 static ResultCode CreateThread(Handle* out_handle, u32 priority, u32 entry_point, u32 arg,
                                u32 stack_top, s32 processor_id) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     std::string name = fmt::format("thread-{:08X}", entry_point);
 
     if (priority > ThreadPrioLowest) {
         return ERR_OUT_OF_RANGE;
     }
 
-    SharedPtr<ResourceLimit>& resource_limit = g_current_process->resource_limit;
+    SharedPtr<Process> current_process = kernel.GetCurrentProcess();
+
+    SharedPtr<ResourceLimit>& resource_limit = current_process->resource_limit;
     if (resource_limit->GetMaxResourceValue(ResourceTypes::PRIORITY) > priority) {
         return ERR_NOT_AUTHORIZED;
     }
 
     if (processor_id == ThreadProcessorIdDefault) {
         // Set the target CPU to the one specified in the process' exheader.
-        processor_id = g_current_process->ideal_processor;
+        processor_id = current_process->ideal_processor;
         ASSERT(processor_id != ThreadProcessorIdDefault);
     }
 
@@ -761,14 +827,14 @@ static ResultCode CreateThread(Handle* out_handle, u32 priority, u32 entry_point
         break;
     }
 
-    CASCADE_RESULT(SharedPtr<Thread> thread, Core::System::GetInstance().Kernel().CreateThread(
-                                                 name, entry_point, priority, arg, processor_id,
-                                                 stack_top, g_current_process));
+    CASCADE_RESULT(SharedPtr<Thread> thread,
+                   kernel.CreateThread(name, entry_point, priority, arg, processor_id, stack_top,
+                                       current_process));
 
     thread->context->SetFpscr(FPSCR_DEFAULT_NAN | FPSCR_FLUSH_TO_ZERO |
                               FPSCR_ROUND_TOZERO); // 0x03C00000
 
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(thread)));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(thread)));
 
     Core::System::GetInstance().PrepareReschedule();
 
@@ -784,13 +850,14 @@ static ResultCode CreateThread(Handle* out_handle, u32 priority, u32 entry_point
 static void ExitThread() {
     LOG_TRACE(Kernel_SVC, "called, pc=0x{:08X}", Core::CPU().GetPC());
 
-    ExitCurrentThread();
+    Core::System::GetInstance().Kernel().GetThreadManager().ExitCurrentThread();
     Core::System::GetInstance().PrepareReschedule();
 }
 
 /// Gets the priority for the specified thread
 static ResultCode GetThreadPriority(u32* priority, Handle handle) {
-    const SharedPtr<Thread> thread = g_handle_table.Get<Thread>(handle);
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    const SharedPtr<Thread> thread = kernel.GetHandleTable().Get<Thread>(handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -800,17 +867,19 @@ static ResultCode GetThreadPriority(u32* priority, Handle handle) {
 
 /// Sets the priority for the specified thread
 static ResultCode SetThreadPriority(Handle handle, u32 priority) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     if (priority > ThreadPrioLowest) {
         return ERR_OUT_OF_RANGE;
     }
 
-    SharedPtr<Thread> thread = g_handle_table.Get<Thread>(handle);
+    SharedPtr<Thread> thread = kernel.GetHandleTable().Get<Thread>(handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
     // Note: The kernel uses the current process's resource limit instead of
     // the one from the thread owner's resource limit.
-    SharedPtr<ResourceLimit>& resource_limit = g_current_process->resource_limit;
+    SharedPtr<Process> current_process = kernel.GetCurrentProcess();
+    SharedPtr<ResourceLimit>& resource_limit = current_process->resource_limit;
     if (resource_limit->GetMaxResourceValue(ResourceTypes::PRIORITY) > priority) {
         return ERR_NOT_AUTHORIZED;
     }
@@ -828,9 +897,10 @@ static ResultCode SetThreadPriority(Handle handle, u32 priority) {
 
 /// Create a mutex
 static ResultCode CreateMutex(Handle* out_handle, u32 initial_locked) {
-    SharedPtr<Mutex> mutex = Core::System::GetInstance().Kernel().CreateMutex(initial_locked != 0);
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<Mutex> mutex = kernel.CreateMutex(initial_locked != 0);
     mutex->name = fmt::format("mutex-{:08x}", Core::CPU().GetReg(14));
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(mutex)));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(mutex)));
 
     LOG_TRACE(Kernel_SVC, "called initial_locked={} : created handle=0x{:08X}",
               initial_locked ? "true" : "false", *out_handle);
@@ -840,20 +910,22 @@ static ResultCode CreateMutex(Handle* out_handle, u32 initial_locked) {
 
 /// Release a mutex
 static ResultCode ReleaseMutex(Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called handle=0x{:08X}", handle);
 
-    SharedPtr<Mutex> mutex = g_handle_table.Get<Mutex>(handle);
+    SharedPtr<Mutex> mutex = kernel.GetHandleTable().Get<Mutex>(handle);
     if (mutex == nullptr)
         return ERR_INVALID_HANDLE;
 
-    return mutex->Release(GetCurrentThread());
+    return mutex->Release(kernel.GetThreadManager().GetCurrentThread());
 }
 
 /// Get the ID of the specified process
 static ResultCode GetProcessId(u32* process_id, Handle process_handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called process=0x{:08X}", process_handle);
 
-    const SharedPtr<Process> process = g_handle_table.Get<Process>(process_handle);
+    const SharedPtr<Process> process = kernel.GetHandleTable().Get<Process>(process_handle);
     if (process == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -863,9 +935,10 @@ static ResultCode GetProcessId(u32* process_id, Handle process_handle) {
 
 /// Get the ID of the process that owns the specified thread
 static ResultCode GetProcessIdOfThread(u32* process_id, Handle thread_handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called thread=0x{:08X}", thread_handle);
 
-    const SharedPtr<Thread> thread = g_handle_table.Get<Thread>(thread_handle);
+    const SharedPtr<Thread> thread = kernel.GetHandleTable().Get<Thread>(thread_handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -879,9 +952,10 @@ static ResultCode GetProcessIdOfThread(u32* process_id, Handle thread_handle) {
 
 /// Get the ID for the specified thread.
 static ResultCode GetThreadId(u32* thread_id, Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called thread=0x{:08X}", handle);
 
-    const SharedPtr<Thread> thread = g_handle_table.Get<Thread>(handle);
+    const SharedPtr<Thread> thread = kernel.GetHandleTable().Get<Thread>(handle);
     if (thread == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -891,10 +965,11 @@ static ResultCode GetThreadId(u32* thread_id, Handle handle) {
 
 /// Creates a semaphore
 static ResultCode CreateSemaphore(Handle* out_handle, s32 initial_count, s32 max_count) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     CASCADE_RESULT(SharedPtr<Semaphore> semaphore,
-                   Core::System::GetInstance().Kernel().CreateSemaphore(initial_count, max_count));
+                   kernel.CreateSemaphore(initial_count, max_count));
     semaphore->name = fmt::format("semaphore-{:08x}", Core::CPU().GetReg(14));
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(semaphore)));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(semaphore)));
 
     LOG_TRACE(Kernel_SVC, "called initial_count={}, max_count={}, created handle=0x{:08X}",
               initial_count, max_count, *out_handle);
@@ -903,9 +978,10 @@ static ResultCode CreateSemaphore(Handle* out_handle, s32 initial_count, s32 max
 
 /// Releases a certain number of slots in a semaphore
 static ResultCode ReleaseSemaphore(s32* count, Handle handle, s32 release_count) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called release_count={}, handle=0x{:08X}", release_count, handle);
 
-    SharedPtr<Semaphore> semaphore = g_handle_table.Get<Semaphore>(handle);
+    SharedPtr<Semaphore> semaphore = kernel.GetHandleTable().Get<Semaphore>(handle);
     if (semaphore == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -917,13 +993,14 @@ static ResultCode ReleaseSemaphore(s32* count, Handle handle, s32 release_count)
 /// Query process memory
 static ResultCode QueryProcessMemory(MemoryInfo* memory_info, PageInfo* page_info,
                                      Handle process_handle, u32 addr) {
-    SharedPtr<Process> process = g_handle_table.Get<Process>(process_handle);
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<Process> process = kernel.GetHandleTable().Get<Process>(process_handle);
     if (process == nullptr)
         return ERR_INVALID_HANDLE;
 
     auto vma = process->vm_manager.FindVMA(addr);
 
-    if (vma == g_current_process->vm_manager.vma_map.end())
+    if (vma == process->vm_manager.vma_map.end())
         return ERR_INVALID_ADDRESS;
 
     memory_info->base_address = vma->second.base;
@@ -943,9 +1020,10 @@ static ResultCode QueryMemory(MemoryInfo* memory_info, PageInfo* page_info, u32
 
 /// Create an event
 static ResultCode CreateEvent(Handle* out_handle, u32 reset_type) {
-    SharedPtr<Event> evt = Core::System::GetInstance().Kernel().CreateEvent(
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<Event> evt = kernel.CreateEvent(
         static_cast<ResetType>(reset_type), fmt::format("event-{:08x}", Core::CPU().GetReg(14)));
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(evt)));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(evt)));
 
     LOG_TRACE(Kernel_SVC, "called reset_type=0x{:08X} : created handle=0x{:08X}", reset_type,
               *out_handle);
@@ -954,16 +1032,18 @@ static ResultCode CreateEvent(Handle* out_handle, u32 reset_type) {
 
 /// Duplicates a kernel handle
 static ResultCode DuplicateHandle(Handle* out, Handle handle) {
-    CASCADE_RESULT(*out, g_handle_table.Duplicate(handle));
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    CASCADE_RESULT(*out, kernel.GetHandleTable().Duplicate(handle));
     LOG_TRACE(Kernel_SVC, "duplicated 0x{:08X} to 0x{:08X}", handle, *out);
     return RESULT_SUCCESS;
 }
 
 /// Signals an event
 static ResultCode SignalEvent(Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called event=0x{:08X}", handle);
 
-    SharedPtr<Event> evt = g_handle_table.Get<Event>(handle);
+    SharedPtr<Event> evt = kernel.GetHandleTable().Get<Event>(handle);
     if (evt == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -974,9 +1054,10 @@ static ResultCode SignalEvent(Handle handle) {
 
 /// Clears an event
 static ResultCode ClearEvent(Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called event=0x{:08X}", handle);
 
-    SharedPtr<Event> evt = g_handle_table.Get<Event>(handle);
+    SharedPtr<Event> evt = kernel.GetHandleTable().Get<Event>(handle);
     if (evt == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -986,9 +1067,10 @@ static ResultCode ClearEvent(Handle handle) {
 
 /// Creates a timer
 static ResultCode CreateTimer(Handle* out_handle, u32 reset_type) {
-    SharedPtr<Timer> timer = Core::System::GetInstance().Kernel().CreateTimer(
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<Timer> timer = kernel.CreateTimer(
         static_cast<ResetType>(reset_type), fmt ::format("timer-{:08x}", Core::CPU().GetReg(14)));
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(timer)));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(timer)));
 
     LOG_TRACE(Kernel_SVC, "called reset_type=0x{:08X} : created handle=0x{:08X}", reset_type,
               *out_handle);
@@ -997,9 +1079,10 @@ static ResultCode CreateTimer(Handle* out_handle, u32 reset_type) {
 
 /// Clears a timer
 static ResultCode ClearTimer(Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
-    SharedPtr<Timer> timer = g_handle_table.Get<Timer>(handle);
+    SharedPtr<Timer> timer = kernel.GetHandleTable().Get<Timer>(handle);
     if (timer == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1009,13 +1092,14 @@ static ResultCode ClearTimer(Handle handle) {
 
 /// Starts a timer
 static ResultCode SetTimer(Handle handle, s64 initial, s64 interval) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
     if (initial < 0 || interval < 0) {
         return ERR_OUT_OF_RANGE_KERNEL;
     }
 
-    SharedPtr<Timer> timer = g_handle_table.Get<Timer>(handle);
+    SharedPtr<Timer> timer = kernel.GetHandleTable().Get<Timer>(handle);
     if (timer == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1026,9 +1110,10 @@ static ResultCode SetTimer(Handle handle, s64 initial, s64 interval) {
 
 /// Cancels a timer
 static ResultCode CancelTimer(Handle handle) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called timer=0x{:08X}", handle);
 
-    SharedPtr<Timer> timer = g_handle_table.Get<Timer>(handle);
+    SharedPtr<Timer> timer = kernel.GetHandleTable().Get<Timer>(handle);
     if (timer == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1041,16 +1126,22 @@ static ResultCode CancelTimer(Handle handle) {
 static void SleepThread(s64 nanoseconds) {
     LOG_TRACE(Kernel_SVC, "called nanoseconds={}", nanoseconds);
 
+    ThreadManager& thread_manager = Core::System::GetInstance().Kernel().GetThreadManager();
+
     // Don't attempt to yield execution if there are no available threads to run,
     // this way we avoid a useless reschedule to the idle thread.
-    if (nanoseconds == 0 && !HaveReadyThreads())
+    if (nanoseconds == 0 && !thread_manager.HaveReadyThreads()) {
+        OnFruitlessPoll();
         return;
+    }
+
+    ResetIdleLoopDetection();
 
     // Sleep current thread and check for next thread to schedule
-    WaitCurrentThread_Sleep();
+    thread_manager.WaitCurrentThread_Sleep();
 
     // Create an event to wake the thread up after the specified nanosecond delay has passed
-    GetCurrentThread()->WakeAfterDelay(nanoseconds);
+    thread_manager.GetCurrentThread()->WakeAfterDelay(nanoseconds);
 
     Core::System::GetInstance().PrepareReschedule();
 }
@@ -1066,6 +1157,7 @@ static s64 GetSystemTick() {
 /// Creates a memory block at the specified address with the specified permissions and size
 static ResultCode CreateMemoryBlock(Handle* out_handle, u32 addr, u32 size, u32 my_permission,
                                     u32 other_permission) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     if (size % Memory::PAGE_SIZE != 0)
         return ERR_MISALIGNED_SIZE;
 
@@ -1102,13 +1194,14 @@ static ResultCode CreateMemoryBlock(Handle* out_handle, u32 addr, u32 size, u32
     // then we have to allocate from the same region as the caller process instead of the BASE
     // region.
     MemoryRegion region = MemoryRegion::BASE;
-    if (addr == 0 && g_current_process->flags.shared_device_mem)
-        region = g_current_process->flags.memory_region;
+    SharedPtr<Process> current_process = kernel.GetCurrentProcess();
+    if (addr == 0 && current_process->flags.shared_device_mem)
+        region = current_process->flags.memory_region;
 
-    shared_memory = Core::System::GetInstance().Kernel().CreateSharedMemory(
-        g_current_process, size, static_cast<MemoryPermission>(my_permission),
+    shared_memory = kernel.CreateSharedMemory(
+        current_process, size, static_cast<MemoryPermission>(my_permission),
         static_cast<MemoryPermission>(other_permission), addr, region);
-    CASCADE_RESULT(*out_handle, g_handle_table.Create(std::move(shared_memory)));
+    CASCADE_RESULT(*out_handle, kernel.GetHandleTable().Create(std::move(shared_memory)));
 
     LOG_WARNING(Kernel_SVC, "called addr=0x{:08X}", addr);
     return RESULT_SUCCESS;
@@ -1116,73 +1209,79 @@ static ResultCode CreateMemoryBlock(Handle* out_handle, u32 addr, u32 size, u32
 
 static ResultCode CreatePort(Handle* server_port, Handle* client_port, VAddr name_address,
                              u32 max_sessions) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     // TODO(Subv): Implement named ports.
     ASSERT_MSG(name_address == 0, "Named ports are currently unimplemented");
 
-    auto ports = Core::System::GetInstance().Kernel().CreatePortPair(max_sessions);
+    auto ports = kernel.CreatePortPair(max_sessions);
+    HandleTable& handle_table = kernel.GetHandleTable();
     CASCADE_RESULT(*client_port,
-                   g_handle_table.Create(std::move(std::get<SharedPtr<ClientPort>>(ports))));
+                   handle_table.Create(std::move(std::get<SharedPtr<ClientPort>>(ports))));
     // Note: The 3DS kernel also leaks the client port handle if the server port handle fails to be
     // created.
     CASCADE_RESULT(*server_port,
-                   g_handle_table.Create(std::move(std::get<SharedPtr<ServerPort>>(ports))));
+                   handle_table.Create(std::move(std::get<SharedPtr<ServerPort>>(ports))));
 
     LOG_TRACE(Kernel_SVC, "called max_sessions={}", max_sessions);
     return RESULT_SUCCESS;
 }
 
 static ResultCode CreateSessionToPort(Handle* out_client_session, Handle client_port_handle) {
-    SharedPtr<ClientPort> client_port = g_handle_table.Get<ClientPort>(client_port_handle);
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<ClientPort> client_port = kernel.GetHandleTable().Get<ClientPort>(client_port_handle);
     if (client_port == nullptr)
         return ERR_INVALID_HANDLE;
 
     CASCADE_RESULT(auto session, client_port->Connect());
-    CASCADE_RESULT(*out_client_session, g_handle_table.Create(std::move(session)));
+    CASCADE_RESULT(*out_client_session, kernel.GetHandleTable().Create(std::move(session)));
     return RESULT_SUCCESS;
 }
 
 static ResultCode CreateSession(Handle* server_session, Handle* client_session) {
-    auto sessions = Core::System::GetInstance().Kernel().CreateSessionPair();
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    auto sessions = kernel.CreateSessionPair();
 
     auto& server = std::get<SharedPtr<ServerSession>>(sessions);
-    CASCADE_RESULT(*server_session, g_handle_table.Create(std::move(server)));
+    CASCADE_RESULT(*server_session, kernel.GetHandleTable().Create(std::move(server)));
 
     auto& client = std::get<SharedPtr<ClientSession>>(sessions);
-    CASCADE_RESULT(*client_session, g_handle_table.Create(std::move(client)));
+    CASCADE_RESULT(*client_session, kernel.GetHandleTable().Create(std::move(client)));
 
     LOG_TRACE(Kernel_SVC, "called");
     return RESULT_SUCCESS;
 }
 
 static ResultCode AcceptSession(Handle* out_server_session, Handle server_port_handle) {
-    SharedPtr<ServerPort> server_port = g_handle_table.Get<ServerPort>(server_port_handle);
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    SharedPtr<ServerPort> server_port = kernel.GetHandleTable().Get<ServerPort>(server_port_handle);
     if (server_port == nullptr)
         return ERR_INVALID_HANDLE;
 
     CASCADE_RESULT(auto session, server_port->Accept());
-    CASCADE_RESULT(*out_server_session, g_handle_table.Create(std::move(session)));
+    CASCADE_RESULT(*out_server_session, kernel.GetHandleTable().Create(std::move(session)));
     return RESULT_SUCCESS;
 }
 
 static ResultCode GetSystemInfo(s64* out, u32 type, s32 param) {
     LOG_TRACE(Kernel_SVC, "called type={} param={}", type, param);
 
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     switch ((SystemInfoType)type) {
     case SystemInfoType::REGION_MEMORY_USAGE:
         switch ((SystemInfoMemUsageRegion)param) {
         case SystemInfoMemUsageRegion::ALL:
-            *out = GetMemoryRegion(MemoryRegion::APPLICATION)->used +
-                   GetMemoryRegion(MemoryRegion::SYSTEM)->used +
-                   GetMemoryRegion(MemoryRegion::BASE)->used;
+            *out = kernel.GetMemoryRegion(MemoryRegion::APPLICATION)->used +
+                   kernel.GetMemoryRegion(MemoryRegion::SYSTEM)->used +
+                   kernel.GetMemoryRegion(MemoryRegion::BASE)->used;
             break;
         case SystemInfoMemUsageRegion::APPLICATION:
-            *out = GetMemoryRegion(MemoryRegion::APPLICATION)->used;
+            *out = kernel.GetMemoryRegion(MemoryRegion::APPLICATION)->used;
             break;
         case SystemInfoMemUsageRegion::SYSTEM:
-            *out = GetMemoryRegion(MemoryRegion::SYSTEM)->used;
+            *out = kernel.GetMemoryRegion(MemoryRegion::SYSTEM)->used;
             break;
         case SystemInfoMemUsageRegion::BASE:
-            *out = GetMemoryRegion(MemoryRegion::BASE)->used;
+            *out = kernel.GetMemoryRegion(MemoryRegion::BASE)->used;
             break;
         default:
             LOG_ERROR(Kernel_SVC, "unknown GetSystemInfo type=0 region: param={}", param);
@@ -1208,9 +1307,10 @@ static ResultCode GetSystemInfo(s64* out, u32 type, s32 param) {
 }
 
 static ResultCode GetProcessInfo(s64* out, Handle process_handle, u32 type) {
+    KernelSystem& kernel = Core::System::GetInstance().Kernel();
     LOG_TRACE(Kernel_SVC, "called process=0x{:08X} type={}", process_handle, type);
 
-    SharedPtr<Process> process = g_handle_table.Get<Process>(process_handle);
+    SharedPtr<Process> process = kernel.GetHandleTable().Get<Process>(process_handle);
     if (process == nullptr)
         return ERR_INVALID_HANDLE;
 
@@ -1407,13 +1507,24 @@ void CallSVC(u32 immediate) {
     // Lock the global kernel mutex when we enter the kernel HLE.
     std::lock_guard<std::recursive_mutex> lock(HLE::g_hle_lock);
 
-    ASSERT_MSG(g_current_process->status == ProcessStatus::Running,
+    ASSERT_MSG(Core::System::GetInstance().Kernel().GetCurrentProcess()->status ==
+                   ProcessStatus::Running,
                "Running threads from exiting processes is unimplemented");
 
+    Core::System::GetInstance().Kernel().GetIdleLoopDetector().OnSVC(immediate);
+
     const FunctionDef* info = GetSVCInfo(immediate);
     if (info) {
         if (info->func) {
-            info->func();
+            auto& call_profiler = Core::System::GetInstance().call_profiler;
+            if (call_profiler.IsEnabled()) {
+                const auto start = HLE::CallProfiler::Clock::now();
+                info->func();
+                call_profiler.RecordSVCCall(immediate, info->name,
+                                            HLE::CallProfiler::Clock::now() - start);
+            } else {
+                info->func();
+            }
         } else {
             LOG_ERROR(Kernel_SVC, "unimplemented SVC function {}(..)", info->name);
         }
@@ -14,6 +14,7 @@
 #include "core/arm/skyeye_common/armstate.h"
 #include "core/core.h"
 #include "core/core_timing.h"
+#include "core/hle/kernel/address_arbiter.h"
 #include "core/hle/kernel/errors.h"
 #include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/kernel.h"
@@ -26,9 +27,6 @@
 
 namespace Kernel {
 
-/// Event type for the thread wake up event
-static CoreTiming::EventType* ThreadWakeupEventType = nullptr;
-
 bool Thread::ShouldWait(Thread* thread) const {
     return status != ThreadStatus::Dead;
 }
@@ -37,46 +35,34 @@ void Thread::Acquire(Thread* thread) {
     ASSERT_MSG(!ShouldWait(thread), "object unavailable!");
 }
 
-// TODO(yuriks): This can be removed if Thread objects are explicitly pooled in the future, allowing
-//               us to simply use a pool index or similar.
-static Kernel::HandleTable wakeup_callback_handle_table;
-
-// Lists all thread ids that aren't deleted/etc.
-static std::vector<SharedPtr<Thread>> thread_list;
-
-// Lists only ready thread ids.
-static Common::ThreadQueueList<Thread*, ThreadPrioLowest + 1> ready_queue;
-
-static SharedPtr<Thread> current_thread;
-
-// The first available thread id at startup
-static u32 next_thread_id;
-
-/**
- * Creates a new thread ID
- * @return The new thread ID
- */
-inline static u32 const NewThreadId() {
+u32 ThreadManager::NewThreadId() {
     return next_thread_id++;
 }
 
-Thread::Thread(KernelSystem& kernel) : WaitObject(kernel), context(Core::CPU().NewContext()) {}
+Thread::Thread(KernelSystem& kernel)
+    : WaitObject(kernel), context(kernel.GetThreadManager().cpu->NewContext()),
+      thread_manager(kernel.GetThreadManager()) {}
 Thread::~Thread() {}
 
-Thread* GetCurrentThread() {
+Thread* ThreadManager::GetCurrentThread() const {
     return current_thread.get();
 }
 
 void Thread::Stop() {
     // Cancel any outstanding wakeup events for this thread
-    CoreTiming::UnscheduleEvent(ThreadWakeupEventType, callback_handle);
-    wakeup_callback_handle_table.Close(callback_handle);
+    CoreTiming::UnscheduleEvent(thread_manager.ThreadWakeupEventType, callback_handle);
+    thread_manager.wakeup_callback_handle_table.Close(callback_handle);
     callback_handle = 0;
 
     // Clean up thread from ready queue
     // This is only needed when the thread is termintated forcefully (SVC TerminateProcess)
     if (status == ThreadStatus::Ready) {
-        ready_queue.remove(current_priority, this);
+        thread_manager.ready_queue.remove(current_priority, this);
+    }
+
+    // Clean up thread from the wait list of the address arbiter it is waiting on, if any
+    if (waiting_arbiter != nullptr) {
+        waiting_arbiter->RemoveWaitingThread(this);
     }
 
     status = ThreadStatus::Dead;
@@ -96,20 +82,16 @@ void Thread::Stop() {
     u32 tls_page = (tls_address - Memory::TLS_AREA_VADDR) / Memory::PAGE_SIZE;
     u32 tls_slot =
         ((tls_address - Memory::TLS_AREA_VADDR) % Memory::PAGE_SIZE) / Memory::TLS_ENTRY_SIZE;
-    Kernel::g_current_process->tls_slots[tls_page].reset(tls_slot);
+    owner_process->tls_slots[tls_page].reset(tls_slot);
 }
 
-/**
- * Switches the CPU's active thread context to that of the specified thread
- * @param new_thread The thread to switch to
- */
-static void SwitchContext(Thread* new_thread) {
+void ThreadManager::SwitchContext(Thread* new_thread) {
     Thread* previous_thread = GetCurrentThread();
 
     // Save context for previous thread
     if (previous_thread) {
         previous_thread->last_running_ticks = CoreTiming::GetTicks();
-        Core::CPU().SaveContext(previous_thread->context);
+        cpu->SaveContext(previous_thread->context);
 
         if (previous_thread->status == ThreadStatus::Running) {
             // This is only the case when a reschedule is triggered without the current thread
@@ -127,7 +109,7 @@ static void SwitchContext(Thread* new_thread) {
         // Cancel any outstanding wakeup events for this thread
         CoreTiming::UnscheduleEvent(ThreadWakeupEventType, new_thread->callback_handle);
 
-        auto previous_process = Kernel::g_current_process;
+        auto previous_process = kernel.GetCurrentProcess();
 
         current_thread = new_thread;
 
@@ -135,12 +117,12 @@ static void SwitchContext(Thread* new_thread) {
         new_thread->status = ThreadStatus::Running;
 
         if (previous_process != current_thread->owner_process) {
-            Kernel::g_current_process = current_thread->owner_process;
-            SetCurrentPageTable(&Kernel::g_current_process->vm_manager.page_table);
+            kernel.SetCurrentProcess(current_thread->owner_process);
+            SetCurrentPageTable(&current_thread->owner_process->vm_manager.page_table);
         }
 
-        Core::CPU().LoadContext(new_thread->context);
-        Core::CPU().SetCP15Register(CP15_THREAD_URO, new_thread->GetTLSAddress());
+        cpu->LoadContext(new_thread->context);
+        cpu->SetCP15Register(CP15_THREAD_URO, new_thread->GetTLSAddress());
     } else {
         current_thread = nullptr;
         // Note: We do not reset the current process and current page table when idling because
@@ -148,11 +130,7 @@ static void SwitchContext(Thread* new_thread) {
     }
 }
 
-/**
- * Pops and returns the next thread from the thread queue
- * @return A pointer to the next ready thread
- */
-static Thread* PopNextReadyThread() {
+Thread* ThreadManager::PopNextReadyThread() {
     Thread* next;
     Thread* thread = GetCurrentThread();
 
@@ -171,24 +149,19 @@ static Thread* PopNextReadyThread() {
     return next;
 }
 
-void WaitCurrentThread_Sleep() {
+void ThreadManager::WaitCurrentThread_Sleep() {
     Thread* thread = GetCurrentThread();
     thread->status = ThreadStatus::WaitSleep;
 }
 
-void ExitCurrentThread() {
+void ThreadManager::ExitCurrentThread() {
     Thread* thread = GetCurrentThread();
     thread->Stop();
     thread_list.erase(std::remove(thread_list.begin(), thread_list.end(), thread),
                       thread_list.end());
 }
 
-/**
- * Callback that will wake up the thread it was scheduled for
- * @param thread_handle The handle of the thread that's been awoken
- * @param cycles_late The number of CPU cycles that have passed since the desired wakeup time
- */
-static void ThreadWakeupCallback(u64 thread_handle, s64 cycles_late) {
+void ThreadManager::ThreadWakeupCallback(u64 thread_handle, s64 cycles_late) {
     SharedPtr<Thread> thread = wakeup_callback_handle_table.Get<Thread>((Handle)thread_handle);
     if (thread == nullptr) {
         LOG_CRITICAL(Kernel, "Callback fired for invalid thread {:08X}", (Handle)thread_handle);
@@ -217,7 +190,8 @@ void Thread::WakeAfterDelay(s64 nanoseconds) {
     if (nanoseconds == -1)
         return;
 
-    CoreTiming::ScheduleEvent(nsToCycles(nanoseconds), ThreadWakeupEventType, callback_handle);
+    CoreTiming::ScheduleEvent(nsToCycles(nanoseconds), thread_manager.ThreadWakeupEventType,
+                              callback_handle);
 }
 
 void Thread::ResumeFromWait() {
@@ -253,15 +227,12 @@ void Thread::ResumeFromWait() {
 
     wakeup_callback = nullptr;
 
-    ready_queue.push_back(current_priority, this);
+    thread_manager.ready_queue.push_back(current_priority, this);
     status = ThreadStatus::Ready;
     Core::System::GetInstance().PrepareReschedule();
 }
 
-/**
- * Prints the thread queue for debugging purposes
- */
-static void DebugThreadQueue() {
+void ThreadManager::DebugThreadQueue() {
     Thread* thread = GetCurrentThread();
     if (!thread) {
         LOG_DEBUG(Kernel, "Current: NO CURRENT THREAD");
@@ -346,10 +317,10 @@ ResultVal<SharedPtr<Thread>> KernelSystem::CreateThread(std::string name, VAddr
 
     SharedPtr<Thread> thread(new Thread(*this));
 
-    thread_list.push_back(thread);
-    ready_queue.prepare(priority);
+    thread_manager->thread_list.push_back(thread);
+    thread_manager->ready_queue.prepare(priority);
 
-    thread->thread_id = NewThreadId();
+    thread->thread_id = thread_manager->NewThreadId();
     thread->status = ThreadStatus::Dormant;
     thread->entry_point = entry_point;
     thread->stack_top = stack_top;
@@ -359,7 +330,7 @@ ResultVal<SharedPtr<Thread>> KernelSystem::CreateThread(std::string name, VAddr
     thread->wait_objects.clear();
     thread->wait_address = 0;
     thread->name = std::move(name);
-    thread->callback_handle = wakeup_callback_handle_table.Create(thread).Unwrap();
+    thread->callback_handle = thread_manager->wakeup_callback_handle_table.Create(thread).Unwrap();
     thread->owner_process = owner_process;
 
     // Find the next available TLS index, and mark it as used
@@ -408,7 +379,7 @@ ResultVal<SharedPtr<Thread>> KernelSystem::CreateThread(std::string name, VAddr
     // to initialize the context
     ResetThreadContext(thread->context, stack_top, entry_point, arg);
 
-    ready_queue.push_back(thread->current_priority, thread.get());
+    thread_manager->ready_queue.push_back(thread->current_priority, thread.get());
     thread->status = ThreadStatus::Ready;
 
     return MakeResult<SharedPtr<Thread>>(std::move(thread));
@@ -419,9 +390,13 @@ void Thread::SetPriority(u32 priority) {
                "Invalid priority value.");
     // If thread was ready, adjust queues
     if (status == ThreadStatus::Ready)
-        ready_queue.move(this, current_priority, priority);
+        thread_manager.ready_queue.move(this, current_priority, priority);
     else
-        ready_queue.prepare(priority);
+        thread_manager.ready_queue.prepare(priority);
+
+    // If thread is waiting on an address arbiter, keep its wait list ordered
+    if (waiting_arbiter != nullptr)
+        waiting_arbiter->UpdateThreadPriority(this, priority);
 
     nominal_priority = current_priority = priority;
 }
@@ -438,9 +413,14 @@ void Thread::UpdatePriority() {
 void Thread::BoostPriority(u32 priority) {
     // If thread was ready, adjust queues
     if (status == ThreadStatus::Ready)
-        ready_queue.move(this, current_priority, priority);
+        thread_manager.ready_queue.move(this, current_priority, priority);
     else
-        ready_queue.prepare(priority);
+        thread_manager.ready_queue.prepare(priority);
+
+    // If thread is waiting on an address arbiter, keep its wait list ordered
+    if (waiting_arbiter != nullptr)
+        waiting_arbiter->UpdateThreadPriority(this, priority);
+
     current_priority = priority;
 }
 
@@ -460,11 +440,11 @@ SharedPtr<Thread> SetupMainThread(KernelSystem& kernel, u32 entry_point, u32 pri
     return thread;
 }
 
-bool HaveReadyThreads() {
+bool ThreadManager::HaveReadyThreads() {
     return ready_queue.get_first() != nullptr;
 }
 
-void Reschedule() {
+void ThreadManager::Reschedule() {
     Thread* cur = GetCurrentThread();
     Thread* next = PopNextReadyThread();
 
@@ -501,25 +481,27 @@ VAddr Thread::GetCommandBufferAddress() const {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void ThreadingInit() {
-    ThreadWakeupEventType = CoreTiming::RegisterEvent("ThreadWakeupCallback", ThreadWakeupCallback);
+ThreadManager::ThreadManager(KernelSystem& kernel)
+    : kernel(kernel), wakeup_callback_handle_table(kernel) {
+    ThreadWakeupEventType =
+        CoreTiming::RegisterEvent("ThreadWakeupCallback", [this](u64 thread_handle, s64 late) {
+            ThreadWakeupCallback(thread_handle, late);
+        });
+}
 
-    current_thread = nullptr;
-    next_thread_id = 1;
+void ThreadManager::SetCPU(ARM_Interface& cpu) {
+    this->cpu = &cpu;
 }
 
-void ThreadingShutdown() {
+ThreadManager::~ThreadManager() {
     current_thread = nullptr;
 
     for (auto& t : thread_list) {
         t->Stop();
     }
-    thread_list.clear();
-    ready_queue.clear();
-    ClearProcessList();
 }
 
-const std::vector<SharedPtr<Thread>>& GetThreadList() {
+const std::vector<SharedPtr<Thread>>& ThreadManager::GetThreadList() {
     return thread_list;
 }
 
@@ -10,13 +10,20 @@
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
 #include "common/common_types.h"
+#include "common/thread_queue_list.h"
 #include "core/arm/arm_interface.h"
+#include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/wait_object.h"
 #include "core/hle/result.h"
 
+namespace CoreTiming {
+struct EventType;
+}
+
 namespace Kernel {
 
+class AddressArbiter;
 class Mutex;
 class Process;
 
@@ -53,6 +60,98 @@ enum class ThreadWakeupReason {
     Timeout // The thread was woken up due to a wait timeout.
 };
 
+class ThreadManager {
+public:
+    explicit ThreadManager(KernelSystem& kernel);
+    ~ThreadManager();
+
+    /**
+     * Sets the CPU core that runs the threads, whose contexts are created for it
+     * @param cpu The CPU core
+     */
+    void SetCPU(ARM_Interface& cpu);
+
+    /**
+     * Creates a new thread ID
+     * @return The new thread ID
+     */
+    u32 NewThreadId();
+
+    /**
+     * Gets the current thread
+     */
+    Thread* GetCurrentThread() const;
+
+    /**
+     * Reschedules to the next available thread (call after current thread is suspended)
+     */
+    void Reschedule();
+
+    /**
+     * Returns whether there are any threads that are ready to run.
+     */
+    bool HaveReadyThreads();
+
+    /**
+     * Waits the current thread on a sleep
+     */
+    void WaitCurrentThread_Sleep();
+
+    /**
+     * Stops the current thread and removes it from the thread_list
+     */
+    void ExitCurrentThread();
+
+    /**
+     * Get a const reference to the thread list for debug use
+     */
+    const std::vector<SharedPtr<Thread>>& GetThreadList();
+
+private:
+    /**
+     * Switches the CPU's active thread context to that of the specified thread
+     * @param new_thread The thread to switch to
+     */
+    void SwitchContext(Thread* new_thread);
+
+    /**
+     * Pops and returns the next thread from the thread queue
+     * @return A pointer to the next ready thread
+     */
+    Thread* PopNextReadyThread();
+
+    /**
+     * Callback that will wake up the thread it was scheduled for
+     * @param thread_handle The handle of the thread that's been awoken
+     * @param cycles_late The number of CPU cycles that have passed since the desired wakeup time
+     */
+    void ThreadWakeupCallback(u64 thread_handle, s64 cycles_late);
+
+    /**
+     * Prints the thread queue for debugging purposes
+     */
+    void DebugThreadQueue();
+
+    KernelSystem& kernel;
+    ARM_Interface* cpu = nullptr;
+
+    /// The first available thread id at startup
+    u32 next_thread_id = 1;
+    SharedPtr<Thread> current_thread;
+    /// Lists only ready thread ids.
+    Common::ThreadQueueList<Thread*, ThreadPrioLowest + 1> ready_queue;
+    /// Event type for the thread wake up event
+    CoreTiming::EventType* ThreadWakeupEventType = nullptr;
+    // TODO(yuriks): This can be removed if Thread objects are explicitly pooled in the future,
+    //               allowing us to simply use a pool index or similar.
+    HandleTable wakeup_callback_handle_table;
+    /// Lists all thread ids that aren't deleted/etc.
+    std::vector<SharedPtr<Thread>> thread_list;
+
+    friend class Thread;
+    friend class KernelSystem;
+};
+
 class Thread final : public WaitObject {
 public:
     std::string GetName() const override {
@@ -196,6 +295,8 @@ public:
     std::vector<SharedPtr<WaitObject>> wait_objects;
 
     VAddr wait_address; ///< If waiting on an AddressArbiter, this is the arbitration address
+    /// If waiting on an AddressArbiter, this is the arbiter. It is cleared before the arbiter dies.
+    AddressArbiter* waiting_arbiter = nullptr;
 
     std::string name;
 
@@ -213,6 +314,8 @@ private:
     explicit Thread(KernelSystem&);
     ~Thread() override;
 
+    ThreadManager& thread_manager;
+
     friend class KernelSystem;
 };
 
@@ -227,56 +330,4 @@ private:
 SharedPtr<Thread> SetupMainThread(KernelSystem& kernel, u32 entry_point, u32 priority,
                                   SharedPtr<Process> owner_process);
 
-/**
- * Returns whether there are any threads that are ready to run.
- */
-bool HaveReadyThreads();
-
-/**
- * Reschedules to the next available thread (call after current thread is suspended)
- */
-void Reschedule();
-
-/**
- * Arbitrate the highest priority thread that is waiting
- * @param address The address for which waiting threads should be arbitrated
- */
-Thread* ArbitrateHighestPriorityThread(u32 address);
-
-/**
- * Arbitrate all threads currently waiting.
- * @param address The address for which waiting threads should be arbitrated
- */
-void ArbitrateAllThreads(u32 address);
-
-/**
- * Gets the current thread
- */
-Thread* GetCurrentThread();
-
-/**
- * Waits the current thread on a sleep
- */
-void WaitCurrentThread_Sleep();
-
-/**
- * Stops the current thread and removes it from the thread_list
- */
-void ExitCurrentThread();
-
-/**
- * Initialize threading
- */
-void ThreadingInit();
-
-/**
- * Shutdown threading
- */
-void ThreadingShutdown();
-
-/**
- * Get a const reference to the thread list for debug use
- */
-const std::vector<SharedPtr<Thread>>& GetThreadList();
-
 } // namespace Kernel
@@ -13,13 +13,7 @@
 
 namespace Kernel {
 
-/// The event type of the generic timer callback event
-static CoreTiming::EventType* timer_callback_event_type = nullptr;
-// TODO(yuriks): This can be removed if Timer objects are explicitly pooled in the future, allowing
-//               us to simply use a pool index or similar.
-static Kernel::HandleTable timer_callback_handle_table;
-
-Timer::Timer(KernelSystem& kernel) : WaitObject(kernel) {}
+Timer::Timer(KernelSystem& kernel) : WaitObject(kernel), timer_manager(kernel.GetTimerManager()) {}
 Timer::~Timer() {}
 
 SharedPtr<Timer> KernelSystem::CreateTimer(ResetType reset_type, std::string name) {
@@ -30,7 +24,7 @@ SharedPtr<Timer> KernelSystem::CreateTimer(ResetType reset_type, std::string nam
     timer->name = std::move(name);
     timer->initial_delay = 0;
     timer->interval_delay = 0;
-    timer->callback_handle = timer_callback_handle_table.Create(timer).Unwrap();
+    timer->callback_handle = timer_manager->timer_callback_handle_table.Create(timer).Unwrap();
 
     return timer;
 }
@@ -57,12 +51,13 @@ void Timer::Set(s64 initial, s64 interval) {
         // Immediately invoke the callback
         Signal(0);
     } else {
-        CoreTiming::ScheduleEvent(nsToCycles(initial), timer_callback_event_type, callback_handle);
+        CoreTiming::ScheduleEvent(nsToCycles(initial), timer_manager.timer_callback_event_type,
+                                  callback_handle);
     }
 }
 
 void Timer::Cancel() {
-    CoreTiming::UnscheduleEvent(timer_callback_event_type, callback_handle);
+    CoreTiming::UnscheduleEvent(timer_manager.timer_callback_event_type, callback_handle);
 }
 
 void Timer::Clear() {
@@ -87,12 +82,11 @@ void Timer::Signal(s64 cycles_late) {
     if (interval_delay != 0) {
         // Reschedule the timer with the interval delay
         CoreTiming::ScheduleEvent(nsToCycles(interval_delay) - cycles_late,
-                                  timer_callback_event_type, callback_handle);
+                                  timer_manager.timer_callback_event_type, callback_handle);
     }
 }
 
-/// The timer callback event, called when a timer is fired
-static void TimerCallback(u64 timer_handle, s64 cycles_late) {
+void TimerManager::TimerCallback(u64 timer_handle, s64 cycles_late) {
     SharedPtr<Timer> timer =
         timer_callback_handle_table.Get<Timer>(static_cast<Handle>(timer_handle));
 
@@ -104,11 +98,11 @@ static void TimerCallback(u64 timer_handle, s64 cycles_late) {
     timer->Signal(cycles_late);
 }
 
-void TimersInit() {
-    timer_callback_handle_table.Clear();
-    timer_callback_event_type = CoreTiming::RegisterEvent("TimerCallback", TimerCallback);
+TimerManager::TimerManager(KernelSystem& kernel) : timer_callback_handle_table(kernel) {
+    timer_callback_event_type =
+        CoreTiming::RegisterEvent("TimerCallback", [this](u64 timer_handle, s64 cycles_late) {
+            TimerCallback(timer_handle, cycles_late);
+        });
 }
 
-void TimersShutdown() {}
-
 } // namespace Kernel
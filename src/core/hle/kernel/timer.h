@@ -5,11 +5,34 @@
 #pragma once
 
 #include "common/common_types.h"
+#include "core/hle/kernel/handle_table.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/wait_object.h"
 
+namespace CoreTiming {
+struct EventType;
+}
+
 namespace Kernel {
 
+class TimerManager {
+public:
+    explicit TimerManager(KernelSystem& kernel);
+
+private:
+    /// The timer callback event, called when a timer is fired
+    void TimerCallback(u64 timer_handle, s64 cycles_late);
+
+    /// The event type of the generic timer callback event
+    CoreTiming::EventType* timer_callback_event_type = nullptr;
+    // TODO(yuriks): This can be removed if Timer objects are explicitly pooled in the future,
+    //               allowing us to simply use a pool index or similar.
+    HandleTable timer_callback_handle_table;
+
+    friend class Timer;
+    friend class KernelSystem;
+};
+
 class Timer final : public WaitObject {
 public:
     std::string GetTypeName() const override {
@@ -74,12 +97,9 @@ private:
     /// Handle used as userdata to reference this object when inserting into the CoreTiming queue.
     Handle callback_handle;
 
+    TimerManager& timer_manager;
+
     friend class KernelSystem;
 };
 
-/// Initializes the required variables for timers
-void TimersInit();
-/// Tears down the timer variables
-void TimersShutdown();
-
 } // namespace Kernel
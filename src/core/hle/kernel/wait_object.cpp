@@ -32,34 +32,36 @@ void WaitObject::RemoveWaitingThread(Thread* thread) {
         waiting_threads.erase(itr);
 }
 
+bool WaitObject::IsReadyToRun(Thread* thread) const {
+    // The list of waiting threads must not contain threads that are not waiting to be awakened.
+    ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
+                   thread->status == ThreadStatus::WaitSynchAll ||
+                   thread->status == ThreadStatus::WaitHleEvent,
+               "Inconsistent thread statuses in waiting_threads");
+
+    if (ShouldWait(thread))
+        return false;
+
+    // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
+    // in ThreadStatus::WaitSynchAll and the rest of the objects it is waiting on are ready.
+    if (thread->status != ThreadStatus::WaitSynchAll)
+        return true;
+
+    return std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                        [this, thread](const SharedPtr<WaitObject>& object) {
+                            return object != this && object->ShouldWait(thread);
+                        });
+}
+
 SharedPtr<Thread> WaitObject::GetHighestPriorityReadyThread() {
     Thread* candidate = nullptr;
     u32 candidate_priority = ThreadPrioLowest + 1;
 
     for (const auto& thread : waiting_threads) {
-        // The list of waiting threads must not contain threads that are not waiting to be awakened.
-        ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
-                       thread->status == ThreadStatus::WaitSynchAll ||
-                       thread->status == ThreadStatus::WaitHleEvent,
-                   "Inconsistent thread statuses in waiting_threads");
-
         if (thread->current_priority >= candidate_priority)
             continue;
 
-        if (ShouldWait(thread.get()))
-            continue;
-
-        // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
-        // in ThreadStatus::WaitSynchAll and the rest of the objects it is waiting on are ready.
-        bool ready_to_run = true;
-        if (thread->status == ThreadStatus::WaitSynchAll) {
-            ready_to_run = std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
-                                        [&thread](const SharedPtr<WaitObject>& object) {
-                                            return object->ShouldWait(thread.get());
-                                        });
-        }
-
-        if (ready_to_run) {
+        if (IsReadyToRun(thread.get())) {
             candidate = thread.get();
             candidate_priority = thread->current_priority;
         }
@@ -69,27 +71,61 @@ SharedPtr<Thread> WaitObject::GetHighestPriorityReadyThread() {
 }
 
 void WaitObject::WakeupAllWaitingThreads() {
-    while (auto thread = GetHighestPriorityReadyThread()) {
-        if (!thread->IsSleepingOnWaitAll()) {
-            Acquire(thread.get());
-        } else {
-            for (auto& object : thread->wait_objects) {
-                object->Acquire(thread.get());
-            }
-        }
+    if (waiting_threads.empty())
+        return;
+
+    // Most objects only have one waiter, which needs no ordering
+    if (waiting_threads.size() == 1) {
+        // WakeupThread removes the thread from waiting_threads, this keeps it alive meanwhile
+        const SharedPtr<Thread> thread = waiting_threads.front();
+        if (IsReadyToRun(thread.get()))
+            WakeupThread(thread);
+        return;
+    }
 
-        // Invoke the wakeup callback before clearing the wait objects
-        if (thread->wakeup_callback)
-            thread->wakeup_callback(ThreadWakeupReason::Signal, thread, this);
+    // Waking up a thread only ever acquires objects, so a waiter that is not ready to run now
+    // cannot become ready while the others are woken up. This allows going through the waiters
+    // once, in priority order, instead of searching the whole list again after every wakeup.
+    // Note: The real kernel picks the first waiter if more than one have the same priority, the
+    // stable sort keeps those in the order they started waiting.
+    std::vector<SharedPtr<Thread>> candidates = waiting_threads;
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->current_priority < rhs->current_priority;
+    });
+
+    for (auto& thread : candidates) {
+        // A wakeup callback may have resumed this thread through another object already.
+        if (std::find(thread->wait_objects.begin(), thread->wait_objects.end(), this) ==
+            thread->wait_objects.end())
+            continue;
 
-        for (auto& object : thread->wait_objects)
-            object->RemoveWaitingThread(thread.get());
-        thread->wait_objects.clear();
+        if (!IsReadyToRun(thread.get()))
+            continue;
 
-        thread->ResumeFromWait();
+        WakeupThread(thread);
     }
 }
 
+void WaitObject::WakeupThread(const SharedPtr<Thread>& thread) {
+    if (!thread->IsSleepingOnWaitAll()) {
+        Acquire(thread.get());
+    } else {
+        for (auto& object : thread->wait_objects) {
+            object->Acquire(thread.get());
+        }
+    }
+
+    // Invoke the wakeup callback before clearing the wait objects
+    if (thread->wakeup_callback)
+        thread->wakeup_callback(ThreadWakeupReason::Signal, thread, this);
+
+    for (auto& object : thread->wait_objects)
+        object->RemoveWaitingThread(thread.get());
+    thread->wait_objects.clear();
+
+    thread->ResumeFromWait();
+}
+
 const std::vector<SharedPtr<Thread>>& WaitObject::GetWaitingThreads() const {
     return waiting_threads;
 }
@@ -53,6 +53,15 @@ public:
     const std::vector<SharedPtr<Thread>>& GetWaitingThreads() const;
 
 private:
+    /**
+     * Checks whether a thread waiting on this object can be woken up, i.e. this object is
+     * available to it and, if it waits on all its objects, so are the other objects.
+     */
+    bool IsReadyToRun(Thread* thread) const;
+
+    /// Acquires the objects a ready waiting thread waits on and resumes it.
+    void WakeupThread(const SharedPtr<Thread>& thread);
+
     /// Threads waiting for this object to become available
     std::vector<SharedPtr<Thread>> waiting_threads;
 };
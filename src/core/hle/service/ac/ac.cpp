@@ -20,12 +20,9 @@ namespace Service::AC {
 void Module::Interface::CreateDefaultConfig(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x1, 0, 0);
 
-    std::vector<u8> buffer(sizeof(ACConfig));
-    std::memcpy(buffer.data(), &ac->default_config, buffer.size());
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(std::move(buffer), 0);
+    std::memcpy(rb.PushStaticBuffer(sizeof(ACConfig), 0), &ac->default_config, sizeof(ACConfig));
 
     LOG_WARNING(Service_AC, "(STUBBED) called");
 }
@@ -123,7 +120,7 @@ void Module::Interface::SetRequestEulaVersion(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(std::move(ac_config), 0);
+    rb.PushStaticBuffer(ac_config, 0);
 
     LOG_WARNING(Service_AC, "(STUBBED) called, major={}, minor={}", major, minor);
 }
@@ -4,10 +4,14 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <condition_variable>
 #include <cstddef>
 #include <cstring>
-#include <cryptopp/aes.h>
-#include <cryptopp/modes.h>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <cryptopp/sha.h>
 #include <fmt/format.h>
 #include "common/file_util.h"
 #include "common/logging/log.h"
@@ -29,6 +33,7 @@
 #include "core/hle/service/am/am_net.h"
 #include "core/hle/service/am/am_sys.h"
 #include "core/hle/service/am/am_u.h"
+#include "core/hle/service/am/content_decryptor.h"
 #include "core/hle/service/fs/archive.h"
 #include "core/loader/loader.h"
 #include "core/loader/smdh.h"
@@ -76,13 +81,142 @@ struct TicketInfo {
 
 static_assert(sizeof(TicketInfo) == 0x18, "Ticket info structure size is wrong");
 
-class CIAFile::DecryptionState {
+/**
+ * Writes decrypted content data to the content files of a title on a worker thread, so that disk
+ * writes overlap with reading and decrypting the following data. The SHA-256 hash of each content
+ * is computed along the way and verified against the TMD once the content is complete. Push
+ * blocks while too much data is waiting to be written, which bounds the memory usage.
+ */
+class CIAFile::ContentWriter {
 public:
-    std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
+    ContentWriter(std::vector<std::string> paths, std::vector<u64> sizes,
+                  std::vector<std::array<u8, 0x20>> hashes)
+        : contents(paths.size()) {
+        for (std::size_t i = 0; i < contents.size(); ++i) {
+            contents[i].path = std::move(paths[i]);
+            contents[i].remaining = sizes[i];
+            contents[i].expected_hash = hashes[i];
+        }
+        worker = std::thread([this] { WorkerLoop(); });
+    }
+
+    ~ContentWriter() {
+        Finish();
+    }
+
+    /// Queues data to be written to a content. Fails if writing previous data failed.
+    ResultCode Push(std::size_t content_index, std::vector<u8> data) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return write_failed || pending_bytes < MAX_PENDING_BYTES; });
+        if (write_failed)
+            return FileSys::ERROR_INSUFFICIENT_SPACE;
+
+        pending_bytes += data.size();
+        queue.push_back({content_index, std::move(data)});
+        cv.notify_all();
+        return RESULT_SUCCESS;
+    }
+
+    /**
+     * Waits until all the queued data has been written.
+     * @returns Whether all the data was written and all the complete contents match their hash
+     */
+    bool Finish() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable())
+            worker.join();
+        return !write_failed && !hash_mismatch;
+    }
+
+private:
+    /// Maximum amount of data waiting to be written
+    static constexpr std::size_t MAX_PENDING_BYTES = 0x800000;
+
+    struct Chunk {
+        std::size_t content_index;
+        std::vector<u8> data;
+    };
+
+    struct Content {
+        std::string path;
+        u64 remaining;
+        std::array<u8, 0x20> expected_hash;
+        FileUtil::IOFile file;
+        CryptoPP::SHA256 sha;
+    };
+
+    void WorkerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty())
+                return;
+
+            Chunk chunk = std::move(queue.front());
+            queue.pop_front();
+
+            // Once a write failed the install is aborted, the remaining data is just dropped
+            const bool skip = write_failed;
+            lock.unlock();
+            const bool success = skip || WriteChunk(chunk);
+            lock.lock();
+
+            pending_bytes -= chunk.data.size();
+            write_failed = write_failed || !success;
+            cv.notify_all();
+        }
+    }
+
+    bool WriteChunk(const Chunk& chunk) {
+        Content& content = contents[chunk.content_index];
+        if (!content.file.IsOpen()) {
+            content.file = FileUtil::IOFile(content.path, "wb");
+            if (!content.file.IsOpen()) {
+                LOG_ERROR(Service_AM, "Could not open {}", content.path);
+                return false;
+            }
+        }
+
+        if (content.file.WriteBytes(chunk.data.data(), chunk.data.size()) != chunk.data.size()) {
+            LOG_ERROR(Service_AM, "Could not write to {}", content.path);
+            return false;
+        }
+
+        content.sha.Update(chunk.data.data(), chunk.data.size());
+        content.remaining -= std::min<u64>(content.remaining, chunk.data.size());
+        if (content.remaining == 0) {
+            content.file.Close();
+
+            std::array<u8, CryptoPP::SHA256::DIGESTSIZE> hash;
+            content.sha.Final(hash.data());
+            if (hash != content.expected_hash) {
+                LOG_ERROR(Service_AM, "Content {} does not match its hash in the TMD",
+                          chunk.content_index);
+                hash_mismatch = true;
+            }
+        }
+        return true;
+    }
+
+    std::vector<Content> contents;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Chunk> queue;
+    std::size_t pending_bytes = 0;
+    bool stopping = false;
+    bool write_failed = false;
+    bool hash_mismatch = false; ///< Only accessed by the worker thread until it is joined
+
+    std::thread worker;
 };
 
 CIAFile::CIAFile(Service::FS::MediaType media_type)
-    : media_type(media_type), decryption_state(std::make_unique<DecryptionState>()) {}
+    : media_type(media_type), decryptor(std::make_unique<ContentDecryptor>()) {}
 
 CIAFile::~CIAFile() {
     Close();
@@ -132,13 +266,23 @@ ResultCode CIAFile::WriteTitleMetadata() {
     auto content_count = container.GetTitleMetadata().GetContentCount();
     content_written.resize(content_count);
 
+    std::vector<std::string> content_paths(content_count);
+    std::vector<u64> content_sizes(content_count);
+    std::vector<std::array<u8, 0x20>> content_hashes(content_count);
+    for (std::size_t i = 0; i < content_count; ++i) {
+        content_paths[i] = GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update);
+        content_sizes[i] = container.GetContentSize(static_cast<u16>(i));
+        content_hashes[i] = tmd.GetContentHashByIndex(static_cast<u16>(i));
+    }
+    content_writer = std::make_unique<ContentWriter>(
+        std::move(content_paths), std::move(content_sizes), std::move(content_hashes));
+
     if (auto title_key = container.GetTicket().GetTitleKey()) {
-        decryption_state->content.resize(content_count);
+        std::vector<std::array<u8, 16>> content_ivs(content_count);
         for (std::size_t i = 0; i < content_count; ++i) {
-            auto ctr = tmd.GetContentCTRByIndex(i);
-            decryption_state->content[i].SetKeyWithIV(title_key->data(), title_key->size(),
-                                                      ctr.data());
+            content_ivs[i] = tmd.GetContentCTRByIndex(i);
         }
+        decryptor->SetKeys(*title_key, std::move(content_ivs));
     }
 
     install_state = CIAInstallState::TMDLoaded;
@@ -166,24 +310,19 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
             // Figure out how much of this content ID we have just recieved/can write out
             u64 available_to_write = std::min(offset_max, range_max) - range_min;
 
-            // Since the incoming TMD has already been written, we can use GetTitleContentPath
-            // to get the content paths to write to.
-            FileSys::TitleMetadata tmd = container.GetTitleMetadata();
-            FileUtil::IOFile file(GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
-                                  content_written[i] ? "ab" : "wb");
-
-            if (!file.IsOpen())
-                return FileSys::ERROR_INSUFFICIENT_SPACE;
-
             std::vector<u8> temp(buffer + (range_min - offset),
                                  buffer + (range_min - offset) + available_to_write);
 
-            if (tmd.GetContentTypeByIndex(static_cast<u16>(i)) &
+            if (container.GetTitleMetadata().GetContentTypeByIndex(static_cast<u16>(i)) &
                 FileSys::TMDContentTypeFlag::Encrypted) {
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
+                decryptor->Decrypt(i, temp.data(), temp.size());
             }
 
-            file.WriteBytes(temp.data(), temp.size());
+            // The data is written out by the content writer, into the content paths of the
+            // incoming TMD.
+            auto result = content_writer->Push(i, std::move(temp));
+            if (result.IsError())
+                return result;
 
             // Keep tabs on how much of this content ID has been written so new range_min
             // values can be calculated.
@@ -276,6 +415,9 @@ bool CIAFile::SetSize(u64 size) const {
 }
 
 bool CIAFile::Close() const {
+    // Wait for the content data that is still being written out
+    const bool contents_valid = content_writer == nullptr || content_writer->Finish();
+
     bool complete = true;
     for (std::size_t i = 0; i < container.GetTitleMetadata().GetContentCount(); i++) {
         if (content_written[i] < container.GetContentSize(static_cast<u16>(i)))
@@ -283,8 +425,10 @@ bool CIAFile::Close() const {
     }
 
     // Install aborted
-    if (!complete) {
-        LOG_ERROR(Service_AM, "CIAFile closed prematurely, aborting install...");
+    if (!complete || !contents_valid) {
+        LOG_ERROR(Service_AM, "{}, aborting install...",
+                  complete ? "CIA contents could not be written or verified"
+                           : "CIAFile closed prematurely");
         FileUtil::DeleteDir(GetTitlePath(media_type, container.GetTitleMetadata().GetTitleID()));
         return true;
     }
@@ -320,6 +464,7 @@ bool CIAFile::Close() const {
 
         FileUtil::Delete(old_tmd_path);
     }
+    install_complete = true;
     return true;
 }
 
@@ -354,15 +499,41 @@ InstallStatus InstallCIA(const std::string& path,
         if (!file.IsOpen())
             return InstallStatus::ErrorFailedToOpenFile;
 
-        std::array<u8, 0x10000> buffer;
+        // The next chunk is read on another thread while the current one is decrypted, and the
+        // CIAFile writes the decrypted data out on its own thread.
+        static constexpr std::size_t CHUNK_SIZE = 0x100000;
+        const std::size_t file_size = file.GetSize();
+        std::array<std::vector<u8>, 2> buffers{std::vector<u8>(CHUNK_SIZE),
+                                               std::vector<u8>(CHUNK_SIZE)};
+        const auto read_chunk = [&file, file_size](std::vector<u8>& buffer, std::size_t offset) {
+            return file.ReadBytesAt(buffer.data(), std::min(CHUNK_SIZE, file_size - offset),
+                                    offset);
+        };
+
         std::size_t total_bytes_read = 0;
-        while (total_bytes_read != file.GetSize()) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
+        std::size_t current_buffer = 0;
+        auto next_read =
+            std::async(std::launch::async, read_chunk, std::ref(buffers[0]), std::size_t{0});
+        while (total_bytes_read != file_size) {
+            const std::size_t bytes_read = next_read.get();
+            if (bytes_read == 0 || bytes_read > CHUNK_SIZE) {
+                LOG_ERROR(Service_AM, "Could not read {}", path);
+                return InstallStatus::ErrorAborted;
+            }
+
+            const std::vector<u8>& buffer = buffers[current_buffer];
+            current_buffer ^= 1;
+            if (total_bytes_read + bytes_read != file_size) {
+                next_read = std::async(std::launch::async, read_chunk,
+                                       std::ref(buffers[current_buffer]),
+                                       total_bytes_read + bytes_read);
+            }
+
             auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            static_cast<u8*>(buffer.data()));
+                                            buffer.data());
 
             if (update_callback)
-                update_callback(total_bytes_read, file.GetSize());
+                update_callback(total_bytes_read, file_size);
             if (result.Failed()) {
                 LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
                           result.Code().raw);
@@ -370,7 +541,12 @@ InstallStatus InstallCIA(const std::string& path,
             }
             total_bytes_read += bytes_read;
         }
+
         installFile.Close();
+        if (!installFile.IsInstallComplete())
+            return InstallStatus::ErrorAborted;
+        if (update_callback)
+            update_callback(file_size, file_size);
 
         LOG_INFO(Service_AM, "Installed {} successfully.", path);
         return InstallStatus::Success;
@@ -1275,12 +1451,10 @@ void Module::Interface::GetDependencyListFromCia(Kernel::HLERequestContext& ctx)
         return;
     }
 
-    std::vector<u8> buffer(FileSys::CIA_DEPENDENCY_SIZE);
-    std::memcpy(buffer.data(), container.GetDependencies().data(), buffer.size());
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(buffer, 0);
+    std::memcpy(rb.PushStaticBuffer(FileSys::CIA_DEPENDENCY_SIZE, 0),
+                container.GetDependencies().data(), FileSys::CIA_DEPENDENCY_SIZE);
 }
 
 void Module::Interface::GetTransferSizeFromCia(Kernel::HLERequestContext& ctx) {
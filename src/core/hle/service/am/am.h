@@ -61,6 +61,8 @@ constexpr std::size_t TITLE_ID_VALID_LENGTH = 16;
 // Progress callback for InstallCIA, receives bytes written and total bytes
 using ProgressCallback = void(std::size_t, std::size_t);
 
+class ContentDecryptor;
+
 // A file handled returned for CIAs to be written into and subsequently installed.
 class CIAFile final : public FileSys::FileBackend {
 public:
@@ -78,6 +80,14 @@ public:
     bool Close() const override;
     void Flush() const override;
 
+    /**
+     * Returns whether Close installed the title. Closing always succeeds, an install aborted
+     * because contents are missing or fail verification is only reported here.
+     */
+    bool IsInstallComplete() const {
+        return install_complete;
+    }
+
 private:
     // Whether it's installing an update, and what step of installation it is at
     bool is_update = false;
@@ -92,12 +102,18 @@ private:
     std::vector<u64> content_written;
     Service::FS::MediaType media_type;
 
-    class DecryptionState;
-    std::unique_ptr<DecryptionState> decryption_state;
+    std::unique_ptr<ContentDecryptor> decryptor;
+
+    class ContentWriter;
+    std::unique_ptr<ContentWriter> content_writer;
+
+    mutable bool install_complete = false; ///< Set by Close
+
 };
 
 /**
- * Installs a CIA file from a specified file path.
+ * Installs a CIA file from a specified file path. The file is read, decrypted and written out in
+ * a pipeline, with each stage running on its own thread.
  * @param path file path of the CIA file to install
  * @param update_callback callback function called during filesystem write
  * @returns bool whether the install was successful
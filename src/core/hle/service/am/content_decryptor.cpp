@@ -0,0 +1,65 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <thread>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/thread_pool.h"
+#include "core/hle/service/am/content_decryptor.h"
+
+namespace Service::AM {
+
+ContentDecryptor::ContentDecryptor(std::size_t num_threads)
+    : num_threads(num_threads != 0
+                      ? num_threads
+                      : std::max<std::size_t>(std::thread::hardware_concurrency(), 1)) {}
+
+ContentDecryptor::~ContentDecryptor() = default;
+
+void ContentDecryptor::SetKeys(const std::array<u8, 16>& title_key,
+                               std::vector<std::array<u8, 16>> content_ivs) {
+    key = title_key;
+    ivs = std::move(content_ivs);
+    if (pool == nullptr) {
+        pool = std::make_unique<Common::ThreadPool>(num_threads, "CIADecryption");
+    }
+}
+
+void ContentDecryptor::Decrypt(std::size_t content_index, u8* data, std::size_t size) {
+    constexpr std::size_t block_size = CryptoPP::AES::BLOCKSIZE;
+    const std::size_t num_blocks = size / block_size;
+    if (num_blocks == 0)
+        return;
+
+    const std::size_t num_parts = std::clamp<std::size_t>(size / MIN_PART_SIZE, 1, num_threads);
+    const std::size_t part_blocks = (num_blocks + num_parts - 1) / num_parts;
+
+    // The IV of each part is the last ciphertext block of the part before it, which has to be
+    // saved before that part is decrypted in place.
+    std::array<u8, 16>& iv = ivs[content_index];
+    std::vector<std::array<u8, 16>> part_ivs{iv};
+    for (std::size_t block = part_blocks; block < num_blocks; block += part_blocks) {
+        const u8* const previous = data + (block - 1) * block_size;
+        part_ivs.emplace_back();
+        std::copy(previous, previous + block_size, part_ivs.back().begin());
+    }
+    std::copy(data + (num_blocks - 1) * block_size, data + num_blocks * block_size, iv.begin());
+
+    const auto decrypt_part = [this, data, num_blocks, part_blocks, &part_ivs](std::size_t part) {
+        const std::size_t first = part * part_blocks;
+        const std::size_t length = std::min(part_blocks, num_blocks - first) * block_size;
+        u8* const part_data = data + first * block_size;
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption(key.data(), key.size(),
+                                                      part_ivs[part].data())
+            .ProcessData(part_data, part_data, length);
+    };
+    for (std::size_t part = 1; part < part_ivs.size(); ++part) {
+        pool->Push([&decrypt_part, part] { decrypt_part(part); });
+    }
+    decrypt_part(0);
+    pool->WaitForIdle();
+}
+
+} // namespace Service::AM
@@ -0,0 +1,45 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common {
+class ThreadPool;
+}
+
+namespace Service::AM {
+
+/**
+ * Decrypts the contents of a CIA with their title key. In CBC mode each block only depends on the
+ * ciphertext block before it, so large buffers are split into parts decrypted in parallel.
+ */
+class ContentDecryptor {
+public:
+    /// Minimum amount of data decrypted by a thread, smaller buffers are not split
+    static constexpr std::size_t MIN_PART_SIZE = 0x40000;
+
+    /// @param num_threads Number of threads decrypting a buffer, 0 for one per host core
+    explicit ContentDecryptor(std::size_t num_threads = 0);
+    ~ContentDecryptor();
+
+    /// Sets the title key, and the IV each content starts with.
+    void SetKeys(const std::array<u8, 16>& title_key, std::vector<std::array<u8, 16>> content_ivs);
+
+    /// Decrypts in place the next data of a content, which must be a multiple of the block size.
+    void Decrypt(std::size_t content_index, u8* data, std::size_t size);
+
+private:
+    std::size_t num_threads;
+    std::array<u8, 16> key{};
+    std::vector<std::array<u8, 16>> ivs; ///< IV of the next data of each content
+    std::unique_ptr<Common::ThreadPool> pool;
+};
+
+} // namespace Service::AM
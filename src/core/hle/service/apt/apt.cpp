@@ -655,7 +655,8 @@ void Module::Interface::ReceiveCaptureBufferInfo(Kernel::HLERequestContext& ctx)
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
     rb.Push(RESULT_SUCCESS);
     rb.Push(static_cast<u32>(apt->screen_capture_buffer.size()));
-    rb.PushStaticBuffer(std::move(apt->screen_capture_buffer), 0);
+    rb.PushStaticBuffer(apt->screen_capture_buffer, 0);
+    apt->screen_capture_buffer.clear();
 }
 
 void Module::Interface::SetScreenCapPostPermission(Kernel::HLERequestContext& ctx) {
@@ -715,15 +716,13 @@ void Module::Interface::GetStartupArgument(Kernel::HLERequestContext& ctx) {
         parameter_size = max_parameter_size;
     }
 
-    std::vector<u8> parameter(parameter_size, 0);
-
     LOG_WARNING(Service_APT, "(STUBBED) called, startup_argument_type={}, parameter_size={:#010X}",
                 static_cast<u32>(startup_argument_type), parameter_size);
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
     rb.Push(RESULT_SUCCESS);
     rb.Push<u32>(0);
-    rb.PushStaticBuffer(parameter, 0);
+    rb.PushStaticBuffer(parameter_size, 0);
 }
 
 void Module::Interface::Wrap(Kernel::HLERequestContext& ctx) {
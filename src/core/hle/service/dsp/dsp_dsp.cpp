@@ -111,7 +111,7 @@ void DSP_DSP::WriteProcessPipe(Kernel::HLERequestContext& ctx) {
         break;
     }
 
-    Core::DSP().PipeWrite(pipe, buffer);
+    Core::DSP().PipeWrite(pipe, buffer.data(), buffer.size());
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -129,15 +129,18 @@ void DSP_DSP::ReadPipe(Kernel::HLERequestContext& ctx) {
     const DspPipe pipe = static_cast<DspPipe>(channel);
     const u16 pipe_readable_size = static_cast<u16>(Core::DSP().GetPipeReadableSize(pipe));
 
-    std::vector<u8> pipe_buffer;
-    if (pipe_readable_size >= size)
-        pipe_buffer = Core::DSP().PipeRead(pipe, size);
-    else
+    const bool can_read = pipe_readable_size >= size;
+    if (!can_read) {
         UNREACHABLE(); // No more data is in pipe. Hardware hangs in this case; Should never happen.
+    }
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(std::move(pipe_buffer), 0);
+    // The data is read directly into the static buffer of the reply
+    u8* const pipe_buffer = rb.PushStaticBuffer(can_read ? size : 0, 0);
+    if (can_read) {
+        Core::DSP().PipeRead(pipe, pipe_buffer, size);
+    }
 
     LOG_DEBUG(Service_DSP, "channel={}, peer={}, size=0x{:04X}, pipe_readable_size=0x{:04X}",
               channel, peer, size, pipe_readable_size);
@@ -168,14 +171,16 @@ void DSP_DSP::ReadPipeIfPossible(Kernel::HLERequestContext& ctx) {
     const DspPipe pipe = static_cast<DspPipe>(channel);
     const u16 pipe_readable_size = static_cast<u16>(Core::DSP().GetPipeReadableSize(pipe));
 
-    std::vector<u8> pipe_buffer;
-    if (pipe_readable_size >= size)
-        pipe_buffer = Core::DSP().PipeRead(pipe, size);
+    const bool can_read = pipe_readable_size >= size;
 
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
     rb.Push(RESULT_SUCCESS);
     rb.Push<u16>(pipe_readable_size);
-    rb.PushStaticBuffer(pipe_buffer, 0);
+    // The data is read directly into the static buffer of the reply
+    u8* const pipe_buffer = rb.PushStaticBuffer(can_read ? size : 0, 0);
+    if (can_read) {
+        Core::DSP().PipeRead(pipe, pipe_buffer, size);
+    }
 
     LOG_DEBUG(Service_DSP, "channel={}, peer={}, size=0x{:04X}, pipe_readable_size=0x{:04X}",
               channel, peer, size, pipe_readable_size);
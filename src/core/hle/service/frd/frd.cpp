@@ -24,12 +24,9 @@ Module::Interface::~Interface() = default;
 void Module::Interface::GetMyPresence(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x08, 0, 0);
 
-    std::vector<u8> buffer(sizeof(MyPresence));
-    std::memcpy(buffer.data(), &frd->my_presence, buffer.size());
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(buffer, 0);
+    std::memcpy(rb.PushStaticBuffer(sizeof(MyPresence), 0), &frd->my_presence, sizeof(MyPresence));
 
     LOG_WARNING(Service_FRD, "(STUBBED) called");
 }
@@ -39,12 +36,10 @@ void Module::Interface::GetFriendKeyList(Kernel::HLERequestContext& ctx) {
     u32 unknown = rp.Pop<u32>();
     u32 frd_count = rp.Pop<u32>();
 
-    std::vector<u8> buffer(sizeof(FriendKey) * frd_count, 0);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
     rb.Push(RESULT_SUCCESS);
     rb.Push<u32>(0); // 0 friends
-    rb.PushStaticBuffer(buffer, 0);
+    rb.PushStaticBuffer(sizeof(FriendKey) * frd_count, 0);
 
     LOG_WARNING(Service_FRD, "(STUBBED) called, unknown={}, frd_count={}", unknown, frd_count);
 }
@@ -55,11 +50,9 @@ void Module::Interface::GetFriendProfile(Kernel::HLERequestContext& ctx) {
     std::vector<u8> frd_keys = rp.PopStaticBuffer();
     ASSERT(frd_keys.size() == count * sizeof(FriendKey));
 
-    std::vector<u8> buffer(sizeof(Profile) * count, 0);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(buffer, 0);
+    rb.PushStaticBuffer(sizeof(Profile) * count, 0);
 
     LOG_WARNING(Service_FRD, "(STUBBED) called, count={}", count);
 }
@@ -71,10 +64,9 @@ void Module::Interface::GetFriendAttributeFlags(Kernel::HLERequestContext& ctx)
     ASSERT(frd_keys.size() == count * sizeof(FriendKey));
 
     // TODO:(mailwl) figure out AttributeFlag size and zero all buffer. Assume 1 byte
-    std::vector<u8> buffer(1 * count, 0);
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(buffer, 0);
+    rb.PushStaticBuffer(1 * count, 0);
 
     LOG_WARNING(Service_FRD, "(STUBBED) called, count={}", count);
 }
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <system_error>
 #include <type_traits>
@@ -13,6 +14,7 @@
 #include "common/common_types.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "core/core_timing.h"
 #include "core/file_sys/archive_backend.h"
 #include "core/file_sys/archive_extsavedata.h"
 #include "core/file_sys/archive_ncch.h"
@@ -25,11 +27,15 @@
 #include "core/file_sys/directory_backend.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/file_backend.h"
+#include "core/file_sys/write_back_cache.h"
 #include "core/hle/result.h"
 #include "core/hle/service/fs/archive.h"
 
 namespace Service::FS {
 
+/// Emulated time between two checks for write-back caches to commit.
+constexpr int WRITE_BACK_CHECK_INTERVAL_MS = 1000;
+
 ArchiveBackend* ArchiveManager::GetArchive(ArchiveHandle handle) {
     auto itr = handle_map.find(handle);
     return (itr == handle_map.end()) ? nullptr : itr->second.get();
@@ -257,6 +263,7 @@ ResultCode ArchiveManager::DeleteExtSaveData(MediaType media_type, u32 high, u32
     std::string extsavedata_path = FileSys::GetExtSaveDataPath(base_path, path);
     if (FileUtil::Exists(extsavedata_path) && !FileUtil::DeleteDirRecursively(extsavedata_path))
         return ResultCode(-1); // TODO(Subv): Find the right error code
+    FileSys::WriteBackCache::Invalidate(extsavedata_path);
     return RESULT_SUCCESS;
 }
 
@@ -269,6 +276,7 @@ ResultCode ArchiveManager::DeleteSystemSaveData(u32 high, u32 low) {
     std::string systemsavedata_path = FileSys::GetSystemSaveDataPath(base_path, path);
     if (!FileUtil::DeleteDirRecursively(systemsavedata_path))
         return ResultCode(-1); // TODO(Subv): Find the right error code
+    FileSys::WriteBackCache::Invalidate(systemsavedata_path);
     return RESULT_SUCCESS;
 }
 
@@ -348,8 +356,28 @@ void ArchiveManager::RegisterSelfNCCH(Loader::AppLoader& app_loader) {
     factory->Register(app_loader);
 }
 
+void ArchiveManager::CommitWriteBackCaches(int cycles_late) {
+    async_io.RunInBackground([] { FileSys::WriteBackCache::CommitExpired(); });
+    CoreTiming::ScheduleEvent(msToCycles(WRITE_BACK_CHECK_INTERVAL_MS) - cycles_late,
+                              write_back_event);
+}
+
 ArchiveManager::ArchiveManager(Core::System& system) : system(system) {
     RegisterArchiveTypes();
+    FileSys::WriteBackCache::SetCommitRunner(
+        [this](std::function<void()> commit) { async_io.RunInBackground(std::move(commit)); });
+
+    write_back_event = CoreTiming::RegisterEvent(
+        "FS::ArchiveManager::WriteBack",
+        [this](u64, int cycles_late) { CommitWriteBackCaches(cycles_late); });
+    CoreTiming::ScheduleEvent(msToCycles(WRITE_BACK_CHECK_INTERVAL_MS), write_back_event);
+}
+
+ArchiveManager::~ArchiveManager() {
+    CoreTiming::UnscheduleEvent(write_back_event, 0);
+    // The commits already queued are run before the I/O threads are stopped, the files released
+    // later are committed right away
+    FileSys::WriteBackCache::SetCommitRunner(nullptr);
 }
 
 } // namespace Service::FS
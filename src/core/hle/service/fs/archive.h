@@ -12,6 +12,7 @@
 #include "common/common_types.h"
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/result.h"
+#include "core/hle/service/fs/async_io.h"
 #include "core/hle/service/fs/directory.h"
 #include "core/hle/service/fs/file.h"
 
@@ -28,6 +29,10 @@ namespace Core {
 class System;
 }
 
+namespace CoreTiming {
+struct EventType;
+}
+
 namespace Service::FS {
 
 /// Supported archive types
@@ -55,6 +60,7 @@ using FileSys::ArchiveFactory;
 class ArchiveManager {
 public:
     explicit ArchiveManager(Core::System& system);
+    ~ArchiveManager();
 
     /**
      * Opens an archive
@@ -228,6 +234,11 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /// Returns the runner of the host file I/O of FS requests
+    AsyncIO& GetAsyncIO() {
+        return async_io;
+    }
+
 private:
     Core::System& system;
 
@@ -244,6 +255,12 @@ private:
 
     ArchiveBackend* GetArchive(ArchiveHandle handle);
 
+    /**
+     * CoreTiming callback, commits the write-back caches of the files that were flushed or stayed
+     * dirty too long on an I/O thread.
+     */
+    void CommitWriteBackCaches(int cycles_late);
+
     /**
      * Map of registered archives, identified by id code. Once an archive is registered here, it is
      * never removed until UnregisterArchiveTypes is called.
@@ -255,6 +272,9 @@ private:
      */
     std::unordered_map<ArchiveHandle, std::unique_ptr<ArchiveBackend>> handle_map;
     ArchiveHandle next_handle = 1;
+
+    AsyncIO async_io;
+    CoreTiming::EventType* write_back_event;
 };
 
 } // namespace Service::FS
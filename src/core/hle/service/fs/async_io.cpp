@@ -0,0 +1,78 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include "common/assert.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/thread.h"
+#include "core/hle/service/fs/async_io.h"
+
+namespace Service::FS {
+
+/// Number of host I/O worker threads. Requests of the same file are serialized by the file.
+constexpr std::size_t NUM_IO_THREADS = 2;
+
+/// Emulated time between two checks for the completion of host I/O that outlasts its delay.
+constexpr u64 COMPLETION_POLL_INTERVAL_US = 100;
+
+AsyncIO::AsyncIO() : pool(NUM_IO_THREADS, "FS IO") {
+    completion_event =
+        CoreTiming::RegisterEvent("FS::AsyncIO::Completion", [this](u64 operation_id, int late) {
+            CheckCompletion(operation_id, late);
+        });
+}
+
+AsyncIO::~AsyncIO() {
+    // The operations reference the files and the kernel objects of the requests, so they must be
+    // finished before the kernel is shut down. Their clients are never woken up.
+    pool.WaitForIdle();
+    for (const auto& [operation_id, operation] : pending_operations) {
+        CoreTiming::UnscheduleEvent(completion_event, operation_id);
+    }
+}
+
+void AsyncIO::Run(Kernel::HLERequestContext& ctx, const std::string& reason, u64 delay_ns,
+                  Operation operation, CompletionCallback callback) {
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    pool.Push([operation = std::move(operation), done] {
+        operation();
+        done->store(true, std::memory_order_release);
+    });
+
+    // The client thread is woken up by signaling the event, there is no timeout
+    auto event = ctx.SleepClientThread(
+        Core::System::GetInstance().Kernel().GetThreadManager().GetCurrentThread(), reason,
+        std::chrono::nanoseconds(0),
+        [callback = std::move(callback)](Kernel::SharedPtr<Kernel::Thread> thread,
+                                         Kernel::HLERequestContext& ctx,
+                                         Kernel::ThreadWakeupReason reason) { callback(ctx); });
+
+    const u64 operation_id = next_operation_id++;
+    pending_operations.emplace(operation_id, PendingOperation{std::move(event), std::move(done)});
+    CoreTiming::ScheduleEvent(nsToCycles(delay_ns), completion_event, operation_id);
+}
+
+void AsyncIO::RunInBackground(Operation operation) {
+    pool.Push(std::move(operation));
+}
+
+void AsyncIO::CheckCompletion(u64 operation_id, int cycles_late) {
+    const auto itr = pending_operations.find(operation_id);
+    ASSERT(itr != pending_operations.end());
+
+    if (!itr->second.done->load(std::memory_order_acquire)) {
+        // The host is slower than the emulated delay, let emulation continue in the meantime
+        CoreTiming::ScheduleEvent(usToCycles(COMPLETION_POLL_INTERVAL_US), completion_event,
+                                  operation_id);
+        return;
+    }
+
+    const Kernel::SharedPtr<Kernel::Event> event = std::move(itr->second.event);
+    pending_operations.erase(itr);
+    event->Signal();
+}
+
+} // namespace Service::FS
@@ -0,0 +1,71 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "common/thread_pool.h"
+#include "core/hle/kernel/event.h"
+
+namespace CoreTiming {
+struct EventType;
+}
+
+namespace Kernel {
+class HLERequestContext;
+}
+
+namespace Service::FS {
+
+/**
+ * Runs the host file I/O of FS requests on a pool of worker threads, so that slow host storage
+ * does not stall emulation. The client thread of a request sleeps until both the emulated delay
+ * of the operation has elapsed and the host I/O has completed. Completion is only ever checked
+ * and reported on the emulation thread.
+ */
+class AsyncIO {
+public:
+    using Operation = std::function<void()>;
+    using CompletionCallback = std::function<void(Kernel::HLERequestContext& ctx)>;
+
+    AsyncIO();
+    /// Waits for the operations in progress, and cancels their completion.
+    ~AsyncIO();
+
+    /**
+     * Runs an operation on a worker thread and puts the client thread of a request to sleep.
+     * @param ctx The request being handled. The response must not have been written yet.
+     * @param reason Reason for the sleep, for debugging
+     * @param delay_ns Emulated duration of the operation, in nanoseconds
+     * @param operation Function doing the host I/O, run on a worker thread
+     * @param callback Function run on the emulation thread once the operation is complete and the
+     * delay has elapsed, which writes the response to the request
+     */
+    void Run(Kernel::HLERequestContext& ctx, const std::string& reason, u64 delay_ns,
+             Operation operation, CompletionCallback callback);
+
+    /// Runs host I/O that no request waits for on a worker thread.
+    void RunInBackground(Operation operation);
+
+private:
+    struct PendingOperation {
+        Kernel::SharedPtr<Kernel::Event> event;
+        std::shared_ptr<std::atomic<bool>> done;
+    };
+
+    /// CoreTiming callback, wakes up the client thread of a request if its I/O is complete.
+    void CheckCompletion(u64 operation_id, int cycles_late);
+
+    Common::ThreadPool pool;
+    CoreTiming::EventType* completion_event;
+    std::unordered_map<u64, PendingOperation> pending_operations;
+    u64 next_operation_id = 0;
+};
+
+} // namespace Service::FS
@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <memory>
 #include "common/logging/log.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
@@ -11,10 +12,18 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/fs/archive.h"
 #include "core/hle/service/fs/file.h"
 
 namespace Service::FS {
 
+/**
+ * Reads and writes up to this length are done right away on the emulation thread, longer ones on
+ * the I/O worker threads. Small transfers take little host time, and completing them right away
+ * keeps writes synchronous and reads as fast as they have always been.
+ */
+constexpr u32 MAX_SYNC_IO_LENGTH = 0x10000;
+
 File::File(Core::System& system, std::unique_ptr<FileSys::FileBackend>&& backend,
            const FileSys::Path& path)
     : ServiceFramework("", 1), path(path), backend(std::move(backend)), system(system) {
@@ -50,32 +59,76 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     // This file session might have a specific offset from where to start reading, apply it.
     offset += file->offset;
 
-    if (offset + length > backend->GetSize()) {
-        LOG_ERROR(Service_FS,
-                  "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
-                  offset, length, backend->GetSize());
-    }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+    const u64 delay_ns = backend->GetReadDelayNs(length);
+
+    // Read straight into the guest memory when it is contiguous on the host, otherwise go through
+    // an intermediate buffer.
+    u8* const guest_data = length <= buffer.GetSize() ? buffer.GetContiguousPointer() : nullptr;
+
+    if (length <= MAX_SYNC_IO_LENGTH && !HasQueuedOperations()) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+
+        std::vector<u8> data;
+        if (guest_data == nullptr) {
+            data.resize(length);
+        }
+
+        ResultVal<std::size_t> read = ReadBackend(
+            offset, length, guest_data != nullptr ? guest_data : data.data());
+        if (read.Failed()) {
+            rb.Push(read.Code());
+            rb.Push<u32>(0);
+        } else {
+            if (guest_data == nullptr) {
+                buffer.Write(data.data(), 0, *read);
+            }
+            rb.Push(RESULT_SUCCESS);
+            rb.Push<u32>(static_cast<u32>(*read));
+        }
+        rb.PushMappedBuffer(buffer);
 
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*read));
+        ctx.SleepClientThread(
+            Core::System::GetInstance().Kernel().GetThreadManager().GetCurrentThread(),
+            "file::read", std::chrono::nanoseconds(delay_ns),
+            [](Kernel::SharedPtr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+               Kernel::ThreadWakeupReason reason) {
+                // Nothing to do here
+            });
+        return;
     }
-    rb.PushMappedBuffer(buffer);
-
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
-    ctx.SleepClientThread(Kernel::GetCurrentThread(), "file::read", read_timeout_ns,
-                          [](Kernel::SharedPtr<Kernel::Thread> thread,
-                             Kernel::HLERequestContext& ctx, Kernel::ThreadWakeupReason reason) {
-                              // Nothing to do here
-                          });
+
+    // The worker thread reads straight into the guest memory too, which is pinned until the read
+    // completes as other guest threads keep running in the meantime. Only buffers that are not
+    // contiguous on the host are read into a buffer of its own, copied on the emulation thread.
+    std::shared_ptr<void> pin = guest_data != nullptr ? buffer.PinMemory() : nullptr;
+    auto data = std::make_shared<std::vector<u8>>(guest_data != nullptr ? 0 : length);
+    u8* const destination = guest_data != nullptr ? guest_data : data->data();
+    auto read = std::make_shared<ResultVal<std::size_t>>();
+
+    QueueOperation(
+        ctx, "file::read", delay_ns,
+        [this, offset, length, destination, read, pin]() mutable {
+            *read = ReadBackend(offset, length, destination);
+            pin.reset();
+        },
+        [data, read](Kernel::HLERequestContext& ctx) {
+            IPC::RequestParser rp(ctx, 0x0802, 3, 2);
+            rp.Skip(3, false);
+            auto& buffer = rp.PopMappedBuffer();
+
+            IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+            if (read->Failed()) {
+                rb.Push(read->Code());
+                rb.Push<u32>(0);
+            } else {
+                if (!data->empty()) {
+                    buffer.Write(data->data(), 0, **read);
+                }
+                rb.Push(RESULT_SUCCESS);
+                rb.Push<u32>(static_cast<u32>(**read));
+            }
+            rb.PushMappedBuffer(buffer);
+        });
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
@@ -87,29 +140,121 @@ void File::Write(Kernel::HLERequestContext& ctx) {
     LOG_TRACE(Service_FS, "Write {}: offset=0x{:x} length={}, flush=0x{:x}", GetName(), offset,
               length, flush);
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-
     const FileSessionSlot* file = GetSessionData(ctx.Session());
 
     // Subfiles can not be written to
     if (file->subfile) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
         rb.Push(FileSys::ERROR_UNSUPPORTED_OPEN_FLAGS);
         rb.Push<u32>(0);
         rb.PushMappedBuffer(buffer);
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
-    if (written.Failed()) {
-        rb.Push(written.Code());
-        rb.Push<u32>(0);
-    } else {
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*written));
+    // Write straight from the guest memory when it is contiguous on the host, otherwise go through
+    // an intermediate buffer. Writes done on the worker threads pin the guest memory until they
+    // complete.
+    const u8* const guest_data =
+        length <= buffer.GetSize() ? buffer.GetContiguousPointer() : nullptr;
+    auto data = std::make_shared<std::vector<u8>>();
+    if (guest_data == nullptr) {
+        data->resize(length);
+        buffer.Read(data->data(), 0, data->size());
+    }
+    const u8* const source = guest_data != nullptr ? guest_data : data->data();
+
+    if (length <= MAX_SYNC_IO_LENGTH && !HasQueuedOperations()) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+        ResultVal<std::size_t> written = WriteBackend(offset, length, flush != 0, source);
+        if (written.Failed()) {
+            rb.Push(written.Code());
+            rb.Push<u32>(0);
+        } else {
+            rb.Push(RESULT_SUCCESS);
+            rb.Push<u32>(static_cast<u32>(*written));
+        }
+        rb.PushMappedBuffer(buffer);
+        return;
+    }
+
+    std::shared_ptr<void> pin = guest_data != nullptr ? buffer.PinMemory() : nullptr;
+    auto written = std::make_shared<ResultVal<std::size_t>>();
+
+    // Writes have no emulated delay, the client thread only waits for the host
+    QueueOperation(
+        ctx, "file::write", 0,
+        [this, offset, length, flush, source, data, written, pin]() mutable {
+            *written = WriteBackend(offset, length, flush != 0, source);
+            pin.reset();
+        },
+        [written](Kernel::HLERequestContext& ctx) {
+            IPC::RequestParser rp(ctx, 0x0803, 4, 2);
+            rp.Skip(4, false);
+            auto& buffer = rp.PopMappedBuffer();
+
+            IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
+            if (written->Failed()) {
+                rb.Push(written->Code());
+                rb.Push<u32>(0);
+            } else {
+                rb.Push(RESULT_SUCCESS);
+                rb.Push<u32>(static_cast<u32>(**written));
+            }
+            rb.PushMappedBuffer(buffer);
+        });
+}
+
+ResultVal<std::size_t> File::ReadBackend(u64 offset, std::size_t length, u8* buffer) {
+    if (offset + length > backend->GetSize()) {
+        LOG_ERROR(Service_FS,
+                  "Reading from out of bounds offset=0x{:x} length=0x{:08X} file_size=0x{:x}",
+                  offset, length, backend->GetSize());
+    }
+    return backend->Read(offset, length, buffer);
+}
+
+ResultVal<std::size_t> File::WriteBackend(u64 offset, std::size_t length, bool flush,
+                                          const u8* buffer) {
+    return backend->Write(offset, length, flush, buffer);
+}
+
+void File::QueueOperation(Kernel::HLERequestContext& ctx, const std::string& reason,
+                          u64 delay_ns, std::function<void()> operation,
+                          std::function<void(Kernel::HLERequestContext& ctx)> callback) {
+    const u64 position = next_queue_position++;
+    queued_operations.fetch_add(1, std::memory_order_relaxed);
+
+    // The worker threads take the operations in order, but one may start before the previous one,
+    // taken by another worker, has finished.
+    auto self = std::static_pointer_cast<File>(shared_from_this());
+    system.ArchiveManager().GetAsyncIO().Run(
+        ctx, reason, delay_ns,
+        [self, position, operation = std::move(operation)] {
+            {
+                std::unique_lock<std::mutex> lock(self->queue_mutex);
+                self->queue_advanced.wait(
+                    lock, [&] { return self->completed_queue_position == position; });
+            }
+            operation();
+            {
+                std::lock_guard<std::mutex> lock(self->queue_mutex);
+                self->completed_queue_position++;
+            }
+            self->queued_operations.fetch_sub(1, std::memory_order_release);
+            self->queue_advanced.notify_all();
+        },
+        std::move(callback));
+}
+
+void File::RunInOrder(Kernel::HLERequestContext& ctx, const std::string& reason,
+                      std::function<void()> operation,
+                      std::function<void(Kernel::HLERequestContext& ctx)> callback) {
+    if (HasQueuedOperations()) {
+        QueueOperation(ctx, reason, 0, std::move(operation), std::move(callback));
+        return;
     }
-    rb.PushMappedBuffer(buffer);
+    operation();
+    callback(ctx);
 }
 
 void File::GetSize(Kernel::HLERequestContext& ctx) {
@@ -128,17 +273,20 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
 
     FileSessionSlot* file = GetSessionData(ctx.Session());
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-
     // SetSize can not be called on subfiles.
     if (file->subfile) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
         rb.Push(FileSys::ERROR_UNSUPPORTED_OPEN_FLAGS);
         return;
     }
 
     file->size = size;
-    backend->SetSize(size);
-    rb.Push(RESULT_SUCCESS);
+    RunInOrder(
+        ctx, "file::set_size", [this, size] { backend->SetSize(size); },
+        [](Kernel::HLERequestContext& ctx) {
+            IPC::RequestBuilder rb(ctx, 0x0805, 1, 0);
+            rb.Push(RESULT_SUCCESS);
+        });
 }
 
 void File::Close(Kernel::HLERequestContext& ctx) {
@@ -149,26 +297,32 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
 
-    backend->Close();
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-    rb.Push(RESULT_SUCCESS);
+    RunInOrder(
+        ctx, "file::close", [this] { backend->Close(); },
+        [](Kernel::HLERequestContext& ctx) {
+            IPC::RequestBuilder rb(ctx, 0x0808, 1, 0);
+            rb.Push(RESULT_SUCCESS);
+        });
 }
 
 void File::Flush(Kernel::HLERequestContext& ctx) {
     IPC::RequestParser rp(ctx, 0x0809, 0, 0);
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
-
     const FileSessionSlot* file = GetSessionData(ctx.Session());
 
     // Subfiles can not be flushed.
     if (file->subfile) {
+        IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
         rb.Push(FileSys::ERROR_UNSUPPORTED_OPEN_FLAGS);
         return;
     }
 
-    backend->Flush();
-    rb.Push(RESULT_SUCCESS);
+    RunInOrder(
+        ctx, "file::flush", [this] { backend->Flush(); },
+        [](Kernel::HLERequestContext& ctx) {
+            IPC::RequestBuilder rb(ctx, 0x0809, 1, 0);
+            rb.Push(RESULT_SUCCESS);
+        });
 }
 
 void File::SetPriority(Kernel::HLERequestContext& ctx) {
@@ -195,22 +349,30 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
     using Kernel::ClientSession;
     using Kernel::ServerSession;
     using Kernel::SharedPtr;
-    IPC::RequestParser rp(ctx, 0x080C, 0, 0);
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
-    auto sessions = system.Kernel().CreateSessionPair(GetName());
-    auto server = std::get<SharedPtr<ServerSession>>(sessions);
-    ClientConnected(server);
 
-    FileSessionSlot* slot = GetSessionData(server);
-    const FileSessionSlot* original_file = GetSessionData(ctx.Session());
-
-    slot->priority = original_file->priority;
-    slot->offset = 0;
-    slot->size = backend->GetSize();
-    slot->subfile = false;
-
-    rb.Push(RESULT_SUCCESS);
-    rb.PushMoveObjects(std::get<SharedPtr<ClientSession>>(sessions));
+    // The size is read after the writes queued before this request
+    auto size = std::make_shared<u64>();
+    auto self = std::static_pointer_cast<File>(shared_from_this());
+    RunInOrder(
+        ctx, "file::open_link_file", [this, size] { *size = backend->GetSize(); },
+        [self, size](Kernel::HLERequestContext& ctx) {
+            IPC::RequestParser rp(ctx, 0x080C, 0, 0);
+            IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+            auto sessions = self->system.Kernel().CreateSessionPair(self->GetName());
+            auto server = std::get<SharedPtr<ServerSession>>(sessions);
+            self->ClientConnected(server);
+
+            FileSessionSlot* slot = self->GetSessionData(server);
+            const FileSessionSlot* original_file = self->GetSessionData(ctx.Session());
+
+            slot->priority = original_file->priority;
+            slot->offset = 0;
+            slot->size = *size;
+            slot->subfile = false;
+
+            rb.Push(RESULT_SUCCESS);
+            rb.PushMoveObjects(std::get<SharedPtr<ClientSession>>(sessions));
+        });
 }
 
 void File::OpenSubFile(Kernel::HLERequestContext& ctx) {
@@ -267,6 +429,7 @@ Kernel::SharedPtr<Kernel::ClientSession> File::Connect() {
     FileSessionSlot* slot = GetSessionData(server);
     slot->priority = 0;
     slot->offset = 0;
+    // Only called on files that were just opened, nothing can be queued yet
     slot->size = backend->GetSize();
     slot->subfile = false;
 
@@ -4,6 +4,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/service/service.h"
@@ -59,6 +64,43 @@ private:
     void OpenLinkFile(Kernel::HLERequestContext& ctx);
     void OpenSubFile(Kernel::HLERequestContext& ctx);
 
+    /// Reads from the backend, from the emulation thread or an I/O worker thread
+    ResultVal<std::size_t> ReadBackend(u64 offset, std::size_t length, u8* buffer);
+    /// Writes to the backend, from the emulation thread or an I/O worker thread
+    ResultVal<std::size_t> WriteBackend(u64 offset, std::size_t length, bool flush,
+                                        const u8* buffer);
+
+    /// Returns whether operations on the backend are queued on the I/O worker threads. Until they
+    /// complete, the emulation thread must not access the backend and queues its operations too.
+    bool HasQueuedOperations() const {
+        return queued_operations.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * Runs an operation on the backend on an I/O worker thread, once the operations queued before
+     * it have completed, and puts the client thread of the request to sleep until then.
+     * @param callback Function run on the emulation thread once the operation is complete, which
+     * writes the response to the request
+     */
+    void QueueOperation(Kernel::HLERequestContext& ctx, const std::string& reason, u64 delay_ns,
+                        std::function<void()> operation,
+                        std::function<void(Kernel::HLERequestContext& ctx)> callback);
+
+    /// Runs an operation right away if no operation is queued, otherwise queues it after them.
+    void RunInOrder(Kernel::HLERequestContext& ctx, const std::string& reason,
+                    std::function<void()> operation,
+                    std::function<void(Kernel::HLERequestContext& ctx)> callback);
+
+    /// Number of operations queued on the I/O worker threads, the backend is only accessed by them
+    /// while it is not zero
+    std::atomic<u32> queued_operations{0};
+    /// Position of the next queued operation, only used on the emulation thread
+    u64 next_queue_position = 0;
+    /// Number of queued operations that completed, the next one to run has this position
+    u64 completed_queue_position = 0;
+    std::mutex queue_mutex;
+    std::condition_variable queue_advanced;
+
     Core::System& system;
 };
 
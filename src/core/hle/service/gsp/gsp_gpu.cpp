@@ -245,14 +245,12 @@ void GSP_GPU::ReadHWRegs(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    std::vector<u8> buffer(size);
+    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
+    rb.Push(RESULT_SUCCESS);
+    u8* const buffer = rb.PushStaticBuffer(size, 0);
     for (u32 offset = 0; offset < size; ++offset) {
         HW::Read<u8>(buffer[offset], REGS_BEGIN + reg_addr + offset);
     }
-
-    IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
-    rb.Push(RESULT_SUCCESS);
-    rb.PushStaticBuffer(std::move(buffer), 0);
 }
 
 ResultCode SetBufferSwap(u32 screen_id, const FrameBufferInfo& info) {
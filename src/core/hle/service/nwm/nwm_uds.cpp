@@ -1159,12 +1159,11 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
     }
 
     if (channel->second.received_packets.empty()) {
-        std::vector<u8> output_buffer(buff_size, 0);
         IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
         rb.Push(RESULT_SUCCESS);
         rb.Push<u32>(0);
         rb.Push<u16>(0);
-        rb.PushStaticBuffer(output_buffer, 0);
+        rb.PushStaticBuffer(buff_size, 0);
         return;
     }
 
@@ -1181,16 +1180,13 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
     }
 
     IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
-
-    std::vector<u8> output_buffer(buff_size, 0);
-    // Write the actual data.
-    std::memcpy(output_buffer.data(),
-                next_packet.data() + sizeof(LLCHeader) + sizeof(SecureDataHeader), data_size);
-
     rb.Push(RESULT_SUCCESS);
     rb.Push<u32>(data_size);
     rb.Push<u16>(secure_data.src_node_id);
-    rb.PushStaticBuffer(output_buffer, 0);
+    u8* const output_buffer = rb.PushStaticBuffer(buff_size, 0);
+    // Write the actual data.
+    std::memcpy(output_buffer, next_packet.data() + sizeof(LLCHeader) + sizeof(SecureDataHeader),
+                data_size);
 
     channel->second.received_packets.pop_front();
 }
@@ -1231,7 +1227,8 @@ void NWM_UDS::ConnectToNetwork(Kernel::HLERequestContext& ctx) {
     static constexpr std::chrono::nanoseconds UDSConnectionTimeout{300000000};
 
     connection_event = ctx.SleepClientThread(
-        Kernel::GetCurrentThread(), "uds::ConnectToNetwork", UDSConnectionTimeout,
+        Core::System::GetInstance().Kernel().GetThreadManager().GetCurrentThread(),
+        "uds::ConnectToNetwork", UDSConnectionTimeout,
         [](Kernel::SharedPtr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
            Kernel::ThreadWakeupReason reason) {
             // TODO(B3N30): Add error handling for host full and timeout
@@ -1327,10 +1324,8 @@ void NWM_UDS::DecryptBeaconData(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
-
-    std::vector<u8> output_buffer(sizeof(NodeInfo) * UDSMaxNodes, 0);
-    std::memcpy(output_buffer.data(), nodes.data(), sizeof(NodeInfo) * nodes.size());
-    rb.PushStaticBuffer(output_buffer, 0);
+    u8* const output_buffer = rb.PushStaticBuffer(sizeof(NodeInfo) * UDSMaxNodes, 0);
+    std::memcpy(output_buffer, nodes.data(), sizeof(NodeInfo) * nodes.size());
 }
 
 // Sends a 802.11 beacon frame with information about the current network.
@@ -6,6 +6,7 @@
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/scope_exit.h"
 #include "core/core.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
@@ -188,24 +189,39 @@ void ServiceFrameworkBase::HandleSyncRequest(SharedPtr<ServerSession> server_ses
         return ReportUnimplementedFunction(cmd_buf, info);
     }
 
+    // The same context is reused for every request handled on this thread, so that its buffers
+    // don't have to be reallocated each time. The references it holds to kernel objects are
+    // dropped as soon as the request has been handled.
+    static thread_local Kernel::HLERequestContext context(nullptr);
+    context.Reset(std::move(server_session));
+    SCOPE_EXIT({ context.Reset(nullptr); });
+
     // TODO(yuriks): The kernel should be the one handling this as part of translation after
     // everything else is migrated
-    Kernel::HLERequestContext context(std::move(server_session));
-    context.PopulateFromIncomingCommandBuffer(cmd_buf, *Kernel::g_current_process,
-                                              Kernel::g_handle_table);
+    Kernel::KernelSystem& kernel = Core::System::GetInstance().Kernel();
+    auto current_process = kernel.GetCurrentProcess();
+    context.PopulateFromIncomingCommandBuffer(cmd_buf, *current_process, kernel.GetHandleTable());
 
     LOG_TRACE(Service, "{}", MakeFunctionString(info->name, GetServiceName().c_str(), cmd_buf));
-    handler_invoker(this, info->handler_callback, context);
 
-    auto thread = Kernel::GetCurrentThread();
+    auto& call_profiler = Core::System::GetInstance().call_profiler;
+    if (call_profiler.IsEnabled()) {
+        const auto start = HLE::CallProfiler::Clock::now();
+        handler_invoker(this, info->handler_callback, context);
+        call_profiler.RecordServiceCall(service_name, header_code >> 16, info->name,
+                                        HLE::CallProfiler::Clock::now() - start);
+    } else {
+        handler_invoker(this, info->handler_callback, context);
+    }
+
+    auto thread = kernel.GetThreadManager().GetCurrentThread();
     ASSERT(thread->status == Kernel::ThreadStatus::Running ||
            thread->status == Kernel::ThreadStatus::WaitHleEvent);
     // Only write the response immediately if the thread is still running. If the HLE handler put
     // the thread to sleep then the writing of the command buffer will be deferred to the wakeup
     // callback.
     if (thread->status == Kernel::ThreadStatus::Running) {
-        context.WriteToOutgoingCommandBuffer(cmd_buf, *Kernel::g_current_process,
-                                             Kernel::g_handle_table);
+        context.WriteToOutgoingCommandBuffer(cmd_buf, *current_process, kernel.GetHandleTable());
     }
 }
 
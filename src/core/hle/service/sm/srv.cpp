@@ -128,8 +128,9 @@ void SRV::GetServiceHandle(Kernel::HLERequestContext& ctx) {
         if (wait_until_available && client_port.Code() == ERR_SERVICE_NOT_REGISTERED) {
             LOG_INFO(Service_SRV, "called service={} delayed", name);
             Kernel::SharedPtr<Kernel::Event> get_service_handle_event =
-                ctx.SleepClientThread(Kernel::GetCurrentThread(), "GetServiceHandle",
-                                      std::chrono::nanoseconds(-1), get_handle);
+                ctx.SleepClientThread(system.Kernel().GetThreadManager().GetCurrentThread(),
+                                      "GetServiceHandle", std::chrono::nanoseconds(-1),
+                                      get_handle);
             get_service_handle_delayed_map[name] = std::move(get_service_handle_event);
             return;
         } else {
@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <mutex>
 #include <optional>
 #include <sstream>
 #include <fmt/format.h>
@@ -228,12 +229,12 @@ void LoadPresetKeys() {
 } // namespace
 
 void InitKeys() {
-    static bool initialized = false;
-    if (initialized)
-        return;
-    LoadBootromKeys();
-    LoadPresetKeys();
-    initialized = true;
+    // The keys may be needed by several threads at once, such as the ones of the game list
+    static std::once_flag initialized;
+    std::call_once(initialized, [] {
+        LoadBootromKeys();
+        LoadPresetKeys();
+    });
 }
 
 void SetGeneratorConstant(const AESKey& key) {
@@ -16,16 +16,16 @@ namespace Loader {
 /// Loads an 3DSX file
 class AppLoader_THREEDSX final : public AppLoader {
 public:
-    AppLoader_THREEDSX(FileUtil::IOFile&& file, const std::string& filename,
+    AppLoader_THREEDSX(FileUtil::ROMFile&& file, const std::string& filename,
                        const std::string& filepath)
         : AppLoader(std::move(file)), filename(std::move(filename)), filepath(filepath) {}
 
     /**
      * Returns the type of the file
-     * @param file FileUtil::IOFile open file
+     * @param file FileUtil::ROMFile open file
      * @return FileType found, or FileType::Error if this loader doesn't know it
      */
-    static FileType IdentifyType(FileUtil::IOFile& file);
+    static FileType IdentifyType(FileUtil::ROMFile& file);
 
     FileType GetFileType() override {
         return IdentifyType(file);
@@ -12,6 +12,7 @@
 #include <utility>
 #include <vector>
 #include "common/common_types.h"
+#include "common/compressed_file.h"
 #include "common/file_util.h"
 #include "core/file_sys/romfs_reader.h"
 #include "core/hle/kernel/object.h"
@@ -42,7 +43,7 @@ enum class FileType {
  * @param file open file
  * @return FileType of file
  */
-FileType IdentifyFile(FileUtil::IOFile& file);
+FileType IdentifyFile(FileUtil::ROMFile& file);
 
 /**
  * Identifies the type of a bootable file based on the magic value in its header.
@@ -85,7 +86,7 @@ constexpr u32 MakeMagic(char a, char b, char c, char d) {
 /// Interface for loading an application
 class AppLoader : NonCopyable {
 public:
-    explicit AppLoader(FileUtil::IOFile&& file) : file(std::move(file)) {}
+    explicit AppLoader(FileUtil::ROMFile&& file) : file(std::move(file)) {}
     virtual ~AppLoader() {}
 
     /**
@@ -196,7 +197,7 @@ public:
     }
 
 protected:
-    FileUtil::IOFile file;
+    FileUtil::ROMFile file;
     bool is_loaded = false;
 };
 
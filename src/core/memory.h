@@ -208,6 +208,14 @@ void CopyBlock(VAddr dest_addr, VAddr src_addr, std::size_t size);
 
 u8* GetPointer(VAddr vaddr);
 
+/**
+ * Gets a pointer to the host memory backing a virtual address range of the given process, if the
+ * whole range is regular memory that is contiguous in the host address space.
+ * @returns The host pointer, or nullptr if any part of the range is unmapped, MMIO,
+ * rasterizer-cached, or backed by a separate host allocation.
+ */
+u8* GetContiguousPointer(const Kernel::Process& process, VAddr vaddr, std::size_t size);
+
 std::string ReadCString(VAddr vaddr, std::size_t max_length);
 
 /**
@@ -6,6 +6,7 @@
 #include <chrono>
 #include <mutex>
 #include <thread>
+#include "core/core_timing.h"
 #include "core/hw/gpu.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
@@ -40,6 +41,13 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::AddIdleLoopSkip(u64 skipped_cycles) {
+    std::lock_guard<std::mutex> lock(object_mutex);
+
+    idle_loop_skips += 1;
+    idle_skipped_cycles += skipped_cycles;
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::lock_guard<std::mutex> lock(object_mutex);
 
@@ -55,6 +63,13 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     results.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    results.idle_loop_skips = idle_loop_skips;
+
+    const auto system_us_elapsed = (current_system_time_us - reset_point_system_us).count();
+    if (system_us_elapsed > 0) {
+        results.idle_skip_ratio = static_cast<double>(cyclesToUs(idle_skipped_cycles)) /
+                                  static_cast<double>(system_us_elapsed);
+    }
 
     // Reset counters
     reset_point = now;
@@ -62,6 +77,8 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    idle_loop_skips = 0;
+    idle_skipped_cycles = 0;
 
     return results;
 }
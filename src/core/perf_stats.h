@@ -29,12 +29,30 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Number of guest idle loops fast-forwarded to the next scheduled event
+        u32 idle_loop_skips;
+        /// Ratio of emulated time skipped by idle loop fast-forwarding / emulated time elapsed
+        double idle_skip_ratio;
+        /// Duration of the audio buffered for the audio output, in seconds
+        double audio_latency;
+        /// Audio latency targeted by the audio output, in seconds
+        double audio_target_latency;
+        /// Number of times the audio output ran out of samples
+        u32 audio_underruns;
+        /// Tempo of the audio time stretcher, 1.0 when it is disabled
+        double audio_stretch_ratio;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /**
+     * Records that a guest idle loop was detected and the remainder of the timing slice skipped.
+     * @param skipped_cycles Number of emulated CPU cycles that were skipped
+     */
+    void AddIdleLoopSkip(u64 skipped_cycles);
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     /**
@@ -57,6 +75,10 @@ private:
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative number of idle loop skips since last reset
+    u32 idle_loop_skips = 0;
+    /// Cumulative number of emulated CPU cycles skipped by idle loop skips since last reset
+    u64 idle_skipped_cycles = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
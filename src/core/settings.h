@@ -107,9 +107,12 @@ struct Values {
 
     // Core
     bool use_cpu_jit;
+    bool skip_idle_loops;
 
     // Data Storage
     bool use_virtual_sd;
+    u16 romfs_cache_size;
+    bool cache_decrypted_content;
 
     // System
     int region_value;
@@ -149,8 +152,13 @@ struct Values {
     // Audio
     std::string sink_id;
     bool enable_audio_stretching;
+    bool enable_dsp_thread;
+    u16 audio_latency;
+    bool enable_low_latency_audio;
+    bool enable_polyphase_interpolation;
     std::string audio_device_id;
     float volume;
+    std::string dsp_trace_path;
 
     // Camera
     std::array<std::string, Service::CAM::NumCameras> camera_name;
@@ -160,6 +168,7 @@ struct Values {
     // Debugging
     bool use_gdbstub;
     u16 gdbstub_port;
+    bool record_hle_call_stats;
     std::string log_filter;
     std::unordered_map<std::string, bool> lle_modules;
 
@@ -0,0 +1,196 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+#include "common/common_types.h"
+#include "common/compressed_file.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/scm_rev.h"
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <input> <output>\n"
+                 "Compresses a 3DS ROM into a compressed ROM container (.zcci/.zcxi)\n"
+                 "-b, --block-size    Size of the compressed blocks in KiB (default: 64)\n"
+                 "-j, --threads       Number of compression threads (default: all cores)\n"
+                 "-B, --benchmark     Compare random read latency of the output and the input\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra ROM compressor " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+/// Returns the average and 99th percentile latency of reads, in microseconds.
+template <typename ReadFunction>
+static std::pair<double, double> MeasureReads(const std::vector<std::pair<u64, std::size_t>>& reads,
+                                              ReadFunction&& read) {
+    std::vector<double> latencies;
+    latencies.reserve(reads.size());
+    std::vector<u8> buffer;
+    for (const auto& [offset, length] : reads) {
+        buffer.resize(length);
+        const auto start = std::chrono::steady_clock::now();
+        read(buffer.data(), length, offset);
+        latencies.push_back(std::chrono::duration<double, std::micro>(
+                                std::chrono::steady_clock::now() - start)
+                                .count());
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double total = 0;
+    for (double latency : latencies) {
+        total += latency;
+    }
+    return {total / latencies.size(), latencies[latencies.size() * 99 / 100]};
+}
+
+/// Reads random ranges from both files, checking that they match and measuring the latency.
+static bool Benchmark(const std::string& raw_path, const std::string& compressed_path) {
+    FileUtil::IOFile raw_file(raw_path, "rb");
+    FileUtil::CompressedFile compressed_file(FileUtil::IOFile(compressed_path, "rb"));
+    if (!raw_file.IsOpen() || !compressed_file.IsOpen() || raw_file.GetSize() == 0)
+        return false;
+
+    // Mostly small reads, like games do in their RomFS, with some larger ones
+    constexpr std::size_t NUM_READS = 10000;
+    const u64 size = raw_file.GetSize();
+    std::mt19937_64 rng(0);
+    std::vector<std::pair<u64, std::size_t>> reads(NUM_READS);
+    for (auto& [offset, length] : reads) {
+        offset = rng() % size;
+        length = static_cast<std::size_t>(
+            std::min<u64>(rng() % 8 == 0 ? 0x40000 : 0x1000, size - offset));
+    }
+
+    std::vector<u8> raw_data;
+    std::vector<u8> compressed_data;
+    for (const auto& [offset, length] : reads) {
+        raw_data.resize(length);
+        compressed_data.resize(length);
+        raw_file.ReadBytesAt(raw_data.data(), length, offset);
+        compressed_file.ReadBytesAt(compressed_data.data(), length, offset);
+        if (raw_data != compressed_data) {
+            std::cout << "Data mismatch at offset " << offset << std::endl;
+            return false;
+        }
+    }
+
+    const auto [raw_average, raw_p99] =
+        MeasureReads(reads, [&](u8* data, std::size_t length, u64 offset) {
+            raw_file.ReadBytesAt(data, length, offset);
+        });
+    const auto [compressed_average, compressed_p99] =
+        MeasureReads(reads, [&](u8* data, std::size_t length, u64 offset) {
+            compressed_file.ReadBytesAt(data, length, offset);
+        });
+    const auto stats = compressed_file.GetCacheStats();
+
+    std::cout << "Random read latency over " << NUM_READS << " reads:\n"
+              << "  raw:        " << raw_average << " us average, " << raw_p99 << " us p99\n"
+              << "  compressed: " << compressed_average << " us average, " << compressed_p99
+              << " us p99 (block cache: " << stats.hits << " hits, " << stats.misses
+              << " misses)" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Log::Filter log_filter(Log::Level::Info);
+    Log::SetGlobalFilter(log_filter);
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+    int option_index = 0;
+    char* endarg;
+    std::size_t block_size = FileUtil::CompressedROM::DEFAULT_BLOCK_SIZE;
+    unsigned num_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    bool benchmark = false;
+
+    static struct option long_options[] = {
+        {"block-size", required_argument, 0, 'b'},
+        {"threads", required_argument, 0, 'j'},
+        {"benchmark", no_argument, 0, 'B'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    int arg;
+    while ((arg = getopt_long(argc, argv, "b:j:Bhv", long_options, &option_index)) != -1) {
+        switch (arg) {
+        case 'b':
+            block_size = std::strtoul(optarg, &endarg, 0) * 1024;
+            break;
+        case 'j':
+            num_threads = std::strtoul(optarg, &endarg, 0);
+            break;
+        case 'B':
+            benchmark = true;
+            break;
+        case 'h':
+            PrintHelp(argv[0]);
+            return 0;
+        case 'v':
+            PrintVersion();
+            return 0;
+        default:
+            PrintHelp(argv[0]);
+            return -1;
+        }
+    }
+
+    const std::vector<std::string> paths(argv + optind, argv + argc);
+
+    if (paths.size() != 2) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (block_size == 0 || block_size > 0x1000000) {
+        std::cout << "block-size needs to be in the range 1 - 16384!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    int last_percent = -1;
+    const bool success = FileUtil::CompressROM(
+        paths[0], paths[1], block_size, num_threads, [&](u64 processed, u64 total) {
+            const int percent = static_cast<int>(processed * 100 / std::max<u64>(total, 1));
+            if (percent != last_percent) {
+                last_percent = percent;
+                std::cout << "\r" << percent << "%" << std::flush;
+            }
+        });
+    std::cout << std::endl;
+    if (!success) {
+        std::cout << "Failed to compress " << paths[0] << std::endl;
+        return -1;
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const u64 input_size = FileUtil::GetSize(paths[0]);
+    const u64 output_size = FileUtil::GetSize(paths[1]);
+    std::cout << "Compressed " << input_size << " bytes to " << output_size << " bytes ("
+              << output_size * 100.0 / std::max<u64>(input_size, 1) << "%) in " << seconds
+              << " s" << std::endl;
+
+    if (benchmark && !Benchmark(paths[0], paths[1])) {
+        std::cout << "Benchmark failed" << std::endl;
+        return -1;
+    }
+    return 0;
+}
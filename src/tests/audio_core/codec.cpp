@@ -0,0 +1,178 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/codec.h"
+
+namespace AudioCore {
+
+using Sample = StereoBuffer16::Sample;
+
+/// Straightforward sample by sample decoders, which the optimized decoders must match exactly
+namespace Reference {
+
+static void DecodeADPCM(const u8* data, std::size_t first_sample, std::size_t sample_count,
+                        const std::array<s16, 16>& coeffs, Codec::ADPCMState& state,
+                        Sample* output) {
+    int yn1 = state.yn1, yn2 = state.yn2;
+    for (std::size_t i = 0; i < sample_count; i++) {
+        const std::size_t samplei = first_sample + i;
+        const u8* frame = data + samplei / 14 * 8;
+        const std::size_t nibblei = samplei % 14;
+        const u8 byte = frame[1 + nibblei / 2];
+        const int nibble = static_cast<s8>((nibblei % 2 == 0 ? byte >> 4 : byte & 0xF) << 4) >> 4;
+        const int coef1 = coeffs[((frame[0] >> 4) & 0x7) * 2 + 0];
+        const int coef2 = coeffs[((frame[0] >> 4) & 0x7) * 2 + 1];
+        const int xn = nibble * (1 << (frame[0] & 0xF));
+        const int val =
+            std::clamp(((xn << 11) + 0x400 + coef1 * yn1 + coef2 * yn2) >> 11, -32768, 32767);
+        yn2 = yn1;
+        yn1 = val;
+        output[i] = {static_cast<s16>(val), static_cast<s16>(val)};
+    }
+    state.yn1 = yn1;
+    state.yn2 = yn2;
+}
+
+static void DecodePCM8(unsigned num_channels, const u8* data, std::size_t first_sample,
+                       std::size_t sample_count, Sample* output) {
+    for (std::size_t i = 0; i < sample_count; i++) {
+        const u8* sample = data + (first_sample + i) * num_channels;
+        output[i][0] = static_cast<s16>(sample[0] << 8);
+        output[i][1] = static_cast<s16>(sample[num_channels - 1] << 8);
+    }
+}
+
+static void DecodePCM16(unsigned num_channels, const u8* data, std::size_t first_sample,
+                        std::size_t sample_count, Sample* output) {
+    for (std::size_t i = 0; i < sample_count; i++) {
+        const u8* sample = data + (first_sample + i) * num_channels * 2;
+        output[i][0] = static_cast<s16>(sample[0] | sample[1] << 8);
+        const u8* last_channel = sample + (num_channels - 1) * 2;
+        output[i][1] = static_cast<s16>(last_channel[0] | last_channel[1] << 8);
+    }
+}
+
+} // namespace Reference
+
+template <typename T>
+static T Random(std::mt19937& rng, T min, T max) {
+    return std::uniform_int_distribution<T>(min, max)(rng);
+}
+
+TEST_CASE("Codec matches the reference decoders", "[audio_core]") {
+    std::mt19937 rng(1234);
+    std::vector<u8> data(0x1000);
+    std::vector<Sample> expected(data.size() * 2);
+    std::vector<Sample> output(data.size() * 2);
+    for (int iteration = 0; iteration < 2000; iteration++) {
+        std::generate(data.begin(), data.end(), [&rng] { return static_cast<u8>(rng()); });
+
+        // Random misalignment of the input and output, and random range of samples
+        const u8* const input = data.data() + Random<std::size_t>(rng, 0, 15);
+        const std::size_t input_size = data.size() - 15;
+        const std::size_t output_offset = Random<std::size_t>(rng, 0, 3);
+        Sample* const expected_out = expected.data() + output_offset;
+        Sample* const out = output.data() + output_offset;
+        const unsigned num_channels = Random(rng, 1u, 2u);
+        const auto pick_range = [&](std::size_t total_samples) {
+            const std::size_t first_sample = Random<std::size_t>(rng, 0, total_samples);
+            return std::make_pair(first_sample,
+                                  Random<std::size_t>(rng, 0, total_samples - first_sample));
+        };
+
+        std::size_t sample_count;
+        switch (Random(rng, 0, 2)) {
+        case 0: {
+            std::array<s16, 16> coeffs;
+            for (s16& coeff : coeffs) {
+                coeff = Random<s16>(rng, -0x8000, 0x7FFF);
+            }
+            Codec::ADPCMState state;
+            state.yn1 = Random<s16>(rng, -0x8000, 0x7FFF);
+            state.yn2 = Random<s16>(rng, -0x8000, 0x7FFF);
+            Codec::ADPCMState expected_state = state;
+            const auto [first_sample, count] = pick_range(input_size / 8 * 14);
+            Reference::DecodeADPCM(input, first_sample, count, coeffs, expected_state,
+                                   expected_out);
+            Codec::DecodeADPCM(input, first_sample, count, coeffs, state, out);
+            REQUIRE(state.yn1 == expected_state.yn1);
+            REQUIRE(state.yn2 == expected_state.yn2);
+            sample_count = count;
+            break;
+        }
+        case 1: {
+            const auto [first_sample, count] = pick_range(input_size / num_channels);
+            Reference::DecodePCM8(num_channels, input, first_sample, count, expected_out);
+            Codec::DecodePCM8(num_channels, input, first_sample, count, out);
+            sample_count = count;
+            break;
+        }
+        default: {
+            const auto [first_sample, count] = pick_range(input_size / 2 / num_channels);
+            Reference::DecodePCM16(num_channels, input, first_sample, count, expected_out);
+            Codec::DecodePCM16(num_channels, input, first_sample, count, out);
+            sample_count = count;
+            break;
+        }
+        }
+        REQUIRE(std::equal(out, out + sample_count, expected_out));
+    }
+}
+
+TEST_CASE("Codec decodes from any sample offset", "[audio_core]") {
+    std::mt19937 rng(7);
+    std::vector<u8> data(0x800);
+    std::generate(data.begin(), data.end(), [&rng] { return static_cast<u8>(rng()); });
+
+    // Decodes the data in one go, then in random amounts, as done for buffers longer than the
+    // ring of their source
+    const auto check = [&rng](std::size_t sample_count, const auto& decode) {
+        std::vector<Sample> expected(sample_count);
+        decode(0, sample_count, expected.data());
+
+        std::uniform_int_distribution<std::size_t> count_dist(1, 100);
+        std::vector<Sample> output(sample_count);
+        for (std::size_t position = 0; position < sample_count;) {
+            const std::size_t count = std::min(count_dist(rng), sample_count - position);
+            decode(position, count, output.data() + position);
+            position += count;
+        }
+        REQUIRE(output == expected);
+    };
+
+    SECTION("ADPCM") {
+        const std::array<s16, 16> coeffs{0x400, -0x100, 0x300, -0x80, 0x200, 0x100, 0x380, -0x200,
+                                         0x100, 0x50,   0x200, -0x60, 0x40,  0x30,  0x20,  0x10};
+        Codec::ADPCMState state{};
+        check(data.size() / 8 * 14, [&](std::size_t first, std::size_t count, Sample* output) {
+            if (first == 0)
+                state = {};
+            Codec::DecodeADPCM(data.data(), first, count, coeffs, state, output);
+        });
+    }
+
+    SECTION("PCM8") {
+        for (const unsigned channels : {1u, 2u}) {
+            check(data.size() / channels, [&](std::size_t first, std::size_t count, Sample* out) {
+                Codec::DecodePCM8(channels, data.data(), first, count, out);
+            });
+        }
+    }
+
+    SECTION("PCM16") {
+        for (const unsigned channels : {1u, 2u}) {
+            check(data.size() / 2 / channels,
+                  [&](std::size_t first, std::size_t count, Sample* out) {
+                      Codec::DecodePCM16(channels, data.data(), first, count, out);
+                  });
+        }
+    }
+}
+
+} // namespace AudioCore
@@ -0,0 +1,82 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/scope_exit.h"
+#include "core/settings.h"
+#include "tests/audio_core/dsp_test_common.h"
+
+namespace AudioCore {
+
+TEST_CASE("DspInterface::OutputCallback", "[audio_core]") {
+    auto dsp = std::make_unique<TestDsp>();
+    auto sink = std::make_unique<FakeSink>();
+    FakeSink& fake_sink = *sink;
+    dsp->SetSink(std::move(sink));
+
+    const float old_volume = Settings::values.volume;
+    SCOPE_EXIT({ Settings::values.volume = old_volume; });
+    Settings::values.volume = 0.5f;
+
+    std::size_t frames_queued = 0;
+    std::vector<s16> output(CALLBACK_FRAMES * 2);
+    QueueCallbackFrames(*dsp, frames_queued);
+    fake_sink.callback(output.data(), CALLBACK_FRAMES);
+
+    // The volume is applied as a 1.15 fixed point gain
+    const s16 gain = static_cast<s16>(std::exp(6.90775f * 0.5f) * 0.001f * 0x8000);
+    std::vector<s16> expected;
+    for (std::size_t i = 0; i < CALLBACK_FRAMES; ++i) {
+        const s16 sample = TestSample(i % samples_per_frame);
+        expected.push_back(static_cast<s16>((sample * gain) >> 15));
+        expected.push_back(static_cast<s16>((-sample * gain) >> 15));
+    }
+    REQUIRE(output == expected);
+}
+
+// Reports the worst time taken by the callback, which must stay well below the duration of the
+// audio it produces for the sink not to underrun
+TEST_CASE("DspInterface::OutputCallback benchmark", "[.][benchmark][audio_core]") {
+    constexpr std::chrono::microseconds callback_period{CALLBACK_FRAMES * 1000000 /
+                                                       native_sample_rate};
+
+    for (const bool stretching : {false, true}) {
+        auto dsp = std::make_unique<TestDsp>();
+        auto sink = std::make_unique<FakeSink>();
+        FakeSink& fake_sink = *sink;
+        dsp->SetSink(std::move(sink));
+        dsp->EnableStretching(stretching);
+
+        std::size_t frames_queued = 0;
+        std::vector<s16> buffer(CALLBACK_FRAMES * 2);
+        std::chrono::nanoseconds worst_time{0};
+        std::chrono::nanoseconds total_time{0};
+        for (int i = 0; i < 700; ++i) {
+            QueueCallbackFrames(*dsp, frames_queued);
+            const auto start = std::chrono::steady_clock::now();
+            fake_sink.callback(buffer.data(), CALLBACK_FRAMES);
+            const auto time = std::chrono::steady_clock::now() - start;
+
+            // Lets the time stretcher reach its steady state
+            if (i < 200)
+                continue;
+            worst_time = std::max<std::chrono::nanoseconds>(worst_time, time);
+            total_time += time;
+        }
+
+        const auto to_us = [](std::chrono::nanoseconds time) {
+            return std::chrono::duration<double, std::micro>(time).count();
+        };
+        WARN((stretching ? "With" : "Without")
+             << " time stretching: worst " << to_us(worst_time) << " us, average "
+             << to_us(total_time) / 500 << " us, for a period of " << callback_period.count()
+             << " us");
+    }
+}
+
+} // namespace AudioCore
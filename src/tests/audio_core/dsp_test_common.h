@@ -0,0 +1,78 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include "audio_core/dsp_interface.h"
+#include "audio_core/sink.h"
+
+namespace AudioCore {
+
+/// Sink running the output callback on demand, in place of the audio thread of a real sink
+class FakeSink final : public Sink {
+public:
+    unsigned int GetNativeSampleRate() const override {
+        return native_sample_rate;
+    }
+
+    void SetCallback(std::function<void(s16*, std::size_t)> cb) override {
+        callback = std::move(cb);
+    }
+
+    std::function<void(s16*, std::size_t)> callback;
+};
+
+class TestDsp final : public DspInterface {
+public:
+    DspState GetDspState() const override {
+        return DspState::On;
+    }
+    std::size_t PipeRead(DspPipe pipe_number, u8* buffer, std::size_t length) override {
+        return 0;
+    }
+    std::size_t GetPipeReadableSize(DspPipe pipe_number) const override {
+        return 0;
+    }
+    void PipeWrite(DspPipe pipe_number, const u8* buffer, std::size_t length) override {}
+    std::array<u8, Memory::DSP_RAM_SIZE>& GetDspMemory() override {
+        return dsp_memory;
+    }
+    void SetServiceToInterrupt(std::weak_ptr<Service::DSP::DSP_DSP> dsp) override {}
+
+    using DspInterface::OutputFrame;
+
+private:
+    std::array<u8, Memory::DSP_RAM_SIZE> dsp_memory{};
+};
+
+/// Number of frames requested by the sink on each callback
+constexpr std::size_t CALLBACK_FRAMES = 512;
+
+/// Left sample of the test frames at an index, the right sample is its opposite
+inline s16 TestSample(std::size_t index) {
+    return static_cast<s16>(std::sin(index * 0.1) * 20000);
+}
+
+/**
+ * Outputs test frames until the samples of the next callback are queued, producing frames at the
+ * same rate as the sink consumes them.
+ * @param frames_queued Number of frames queued and not consumed yet, updated for the callback
+ */
+inline void QueueCallbackFrames(TestDsp& dsp, std::size_t& frames_queued) {
+    StereoFrame16 frame;
+    for (std::size_t i = 0; i < frame.size(); ++i) {
+        frame[i] = {TestSample(i), static_cast<s16>(-TestSample(i))};
+    }
+
+    for (; frames_queued < CALLBACK_FRAMES; frames_queued += frame.size()) {
+        dsp.OutputFrame(frame);
+    }
+    frames_queued -= CALLBACK_FRAMES;
+}
+
+} // namespace AudioCore
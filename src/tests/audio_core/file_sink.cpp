@@ -0,0 +1,96 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/file_sink.h"
+#include "common/file_util.h"
+
+namespace AudioCore {
+
+/// Three seconds of a ramp, enough to span several blocks of the file sink
+static std::vector<s16> MakeSamples() {
+    std::vector<s16> samples(native_sample_rate * 3 * 2);
+    for (std::size_t i = 0; i < samples.size(); i++) {
+        samples[i] = static_cast<s16>(i * 7);
+    }
+    return samples;
+}
+
+/// Pushes the samples in frames, like the DSP does
+static void PushFrames(Sink& sink, const std::vector<s16>& samples) {
+    REQUIRE(!sink.IsRealTime());
+    for (std::size_t i = 0; i < samples.size(); i += samples_per_frame * 2) {
+        const std::size_t count =
+            std::min<std::size_t>(samples.size() - i, samples_per_frame * 2) / 2;
+        sink.PushSamples(samples.data() + i, count);
+    }
+}
+
+static std::vector<u8> ReadHostFile(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    std::vector<u8> data(file.GetSize());
+    REQUIRE(file.ReadBytes(data.data(), data.size()) == data.size());
+    return data;
+}
+
+TEST_CASE("FileSink", "[audio_core]") {
+    const std::vector<s16> samples = MakeSamples();
+    const std::size_t data_size = samples.size() * sizeof(s16);
+
+    SECTION("raw capture") {
+        const std::string path = FileUtil::GetCurrentDir() + "/file_sink_test.raw";
+        {
+            FileSink sink(path);
+            PushFrames(sink, samples);
+        }
+
+        const std::vector<u8> data = ReadHostFile(path);
+        REQUIRE(data.size() == data_size);
+        REQUIRE(std::memcmp(data.data(), samples.data(), data_size) == 0);
+        FileUtil::Delete(path);
+    }
+
+    SECTION("WAV capture") {
+        const std::string path = FileUtil::GetCurrentDir() + "/file_sink_test.wav";
+        {
+            FileSink sink(path);
+            PushFrames(sink, samples);
+        }
+
+        const std::vector<u8> data = ReadHostFile(path);
+        REQUIRE(data.size() == 44 + data_size);
+        REQUIRE(std::memcmp(data.data(), "RIFF", 4) == 0);
+        u32 riff_size, data_chunk_size;
+        std::memcpy(&riff_size, data.data() + 4, sizeof(u32));
+        std::memcpy(&data_chunk_size, data.data() + 40, sizeof(u32));
+        REQUIRE(riff_size == 36 + data_size);
+        REQUIRE(data_chunk_size == data_size);
+        REQUIRE(std::memcmp(data.data() + 44, samples.data(), data_size) == 0);
+        FileUtil::Delete(path);
+    }
+}
+
+TEST_CASE("ChecksumSink", "[audio_core]") {
+    const std::vector<s16> samples = MakeSamples();
+
+    ChecksumSink sink("");
+    PushFrames(sink, samples);
+    REQUIRE(sink.GetSampleCount() == samples.size() / 2);
+
+    // The checksum does not depend on how the samples are split
+    ChecksumSink single_push("");
+    single_push.PushSamples(samples.data(), samples.size() / 2);
+    REQUIRE(single_push.GetChecksum() == sink.GetChecksum());
+
+    std::vector<s16> modified = samples;
+    modified[1234] ^= 1;
+    ChecksumSink other("");
+    PushFrames(other, modified);
+    REQUIRE(other.GetChecksum() != sink.GetChecksum());
+}
+
+} // namespace AudioCore
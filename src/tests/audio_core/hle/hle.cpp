@@ -0,0 +1,112 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/hle.h"
+#include "audio_core/hle/shared_memory.h"
+#include "audio_core/sink.h"
+#include "common/scope_exit.h"
+#include "core/core_timing.h"
+
+namespace AudioCore {
+namespace HLE {
+
+namespace {
+
+constexpr u64 audio_frame_ticks = 1310252; ///< Same as the DSP, units: ARM11 cycles
+
+/// Sink keeping all the samples it is given
+class FrameSink final : public Sink {
+public:
+    unsigned int GetNativeSampleRate() const override {
+        return native_sample_rate;
+    }
+
+    void SetCallback(std::function<void(s16*, std::size_t)>) override {}
+
+    bool IsRealTime() const override {
+        return false;
+    }
+
+    void PushSamples(const s16* data, std::size_t num_frames) override {
+        samples.insert(samples.end(), data, data + num_frames * 2);
+    }
+
+    std::vector<s16> samples;
+};
+
+/**
+ * Runs a DSP for some frames with an application using both aux effects. The effects return
+ * constant samples, different for each of them.
+ */
+std::vector<s16> RunWithAuxEffects(bool use_worker_thread, std::size_t num_frames) {
+    CoreTiming::Init();
+    SCOPE_EXIT({ CoreTiming::Shutdown(); });
+
+    DspHle dsp(use_worker_thread);
+    auto sink = std::make_unique<FrameSink>();
+    FrameSink& frames = *sink;
+    dsp.SetSink(std::move(sink));
+
+    u8* const memory = dsp.GetDspMemory().data();
+    std::array<SharedMemory*, 2> regions{
+        reinterpret_cast<SharedMemory*>(memory + region0_offset),
+        reinterpret_cast<SharedMemory*>(memory + region1_offset),
+    };
+
+    CoreTiming::Advance();
+    for (std::size_t frame = 0; frame < num_frames; frame++) {
+        // The application fills the region the DSP did not read last, then makes it current
+        const std::size_t current = regions[0]->frame_counter > regions[1]->frame_counter ? 0 : 1;
+        SharedMemory& region = *regions[current ^ 1];
+
+        if (frame == 0) {
+            DspConfiguration& config = region.dsp_configuration;
+            config.mixer1_enabled = 1;
+            config.mixer1_enabled_dirty.Assign(1);
+            config.mixer2_enabled = 1;
+            config.mixer2_enabled_dirty.Assign(1);
+            config.volume[1] = 1.0f;
+            config.volume_1_dirty.Assign(1);
+            config.volume[2] = 0.5f;
+            config.volume_2_dirty.Assign(1);
+        }
+        for (std::size_t channel = 0; channel < 4; channel++) {
+            std::fill_n(region.intermediate_mix_samples.mix1.pcm32[channel], samples_per_frame,
+                        1000);
+            std::fill_n(region.intermediate_mix_samples.mix2.pcm32[channel], samples_per_frame,
+                        -3000);
+        }
+        region.frame_counter = regions[current]->frame_counter + 1;
+
+        // Run the emulated time up to the next audio frame
+        while (CoreTiming::GetTicks() < (frame + 1) * audio_frame_ticks) {
+            CoreTiming::AddTicks(CoreTiming::GetDowncount());
+            CoreTiming::Advance();
+        }
+    }
+    return frames.samples;
+}
+
+} // namespace
+
+TEST_CASE("DspHle worker thread", "[audio_core]") {
+    constexpr std::size_t NUM_FRAMES = 20;
+    const std::vector<s16> synchronous = RunWithAuxEffects(false, NUM_FRAMES);
+    const std::vector<s16> threaded = RunWithAuxEffects(true, NUM_FRAMES);
+
+    // The frames of the worker thread are output one frame later
+    REQUIRE(synchronous.size() == NUM_FRAMES * samples_per_frame * 2);
+    REQUIRE(threaded.size() == (NUM_FRAMES - 1) * samples_per_frame * 2);
+    REQUIRE(std::equal(threaded.begin(), threaded.end(), synchronous.begin()));
+
+    // The samples returned by the aux effects are mixed
+    REQUIRE(synchronous[0] == 2 * 1000 - 2 * 3000 / 2);
+}
+
+} // namespace HLE
+} // namespace AudioCore
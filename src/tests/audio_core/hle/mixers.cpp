@@ -0,0 +1,80 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/mixers.h"
+
+namespace AudioCore {
+namespace HLE {
+
+/// Final mix of a sample, as specified by the straightforward scalar implementation
+static std::array<s16, 2> ReferenceMix(DspConfiguration::OutputFormat format,
+                                       const std::array<float, 3>& volumes,
+                                       const std::array<QuadFrame32, 3>& mixes, std::size_t i) {
+    const auto clamp = [](s32 value) { return static_cast<s16>(std::clamp(value, -32768, 32767)); };
+    std::array<s16, 2> output{};
+    for (std::size_t mix = 0; mix < 3; mix++) {
+        const float gain = volumes[mix];
+        const QuadFrame32& samples = mixes[mix];
+        s16 left, right;
+        if (format == DspConfiguration::OutputFormat::Mono) {
+            left = right = clamp(static_cast<s32>((gain * samples[0][i] + gain * samples[1][i] +
+                                                   gain * samples[2][i] + gain * samples[3][i]) /
+                                                  2));
+        } else {
+            left = clamp(static_cast<s32>(gain * samples[0][i] + gain * samples[2][i]));
+            right = clamp(static_cast<s32>(gain * samples[1][i] + gain * samples[3][i]));
+        }
+        output[0] = clamp(output[0] + left);
+        output[1] = clamp(output[1] + right);
+    }
+    return output;
+}
+
+TEST_CASE("Mixers::Tick final mix", "[audio_core][hle]") {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<s32> sample_dist(-100000, 100000);
+    std::uniform_real_distribution<float> volume_dist(0.0f, 1.5f);
+
+    auto config = std::make_unique<DspConfiguration>();
+    auto read_samples = std::make_unique<IntermediateMixSamples>();
+    auto write_samples = std::make_unique<IntermediateMixSamples>();
+    auto mixes = std::make_unique<std::array<QuadFrame32, 3>>();
+    Mixers mixers;
+
+    for (const auto format :
+         {DspConfiguration::OutputFormat::Mono, DspConfiguration::OutputFormat::Stereo}) {
+        for (int iteration = 0; iteration < 50; iteration++) {
+            std::array<float, 3> volumes;
+            for (float& volume : volumes) {
+                volume = iteration % 5 == 0 ? 0.0f : volume_dist(rng);
+            }
+            for (QuadFrame32& mix : *mixes) {
+                for (auto& channel : mix) {
+                    std::generate(channel.begin(), channel.end(), [&] { return sample_dist(rng); });
+                }
+            }
+
+            config->dirty_raw = 0;
+            config->volume_0_dirty.Assign(1);
+            config->volume_1_dirty.Assign(1);
+            config->volume_2_dirty.Assign(1);
+            config->output_format_dirty.Assign(1);
+            std::copy(volumes.begin(), volumes.end(), config->volume);
+            config->output_format = format;
+            mixers.Tick(*config, *read_samples, *write_samples, *mixes);
+
+            const StereoFrame16 output = mixers.GetOutput();
+            for (std::size_t i = 0; i < output.size(); i++) {
+                REQUIRE(output[i] == ReferenceMix(format, volumes, *mixes, i));
+            }
+        }
+    }
+}
+
+} // namespace HLE
+} // namespace AudioCore
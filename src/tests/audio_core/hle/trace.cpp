@@ -0,0 +1,251 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/hle.h"
+#include "audio_core/hle/trace.h"
+#include "audio_core/sink.h"
+#include "common/file_util.h"
+#include "common/scope_exit.h"
+#include "core/core_timing.h"
+#include "core/settings.h"
+
+namespace AudioCore {
+namespace HLE {
+
+/// Sink keeping all the samples it is given
+class CaptureSink final : public Sink {
+public:
+    unsigned int GetNativeSampleRate() const override {
+        return native_sample_rate;
+    }
+
+    void SetCallback(std::function<void(s16*, std::size_t)>) override {}
+
+    bool IsRealTime() const override {
+        return false;
+    }
+
+    void PushSamples(const s16* data, std::size_t num_frames) override {
+        samples.insert(samples.end(), data, data + num_frames * 2);
+    }
+
+    std::vector<s16> samples;
+};
+
+/**
+ * Builds a trace of sources looping over buffers of random samples. Even sources play PCM16
+ * buffers with polyphase interpolation, odd sources ADPCM buffers with linear interpolation.
+ */
+static std::vector<TraceFrame> MakeTrace(std::size_t num_sources, std::size_t num_frames) {
+    using Configuration = SourceConfiguration::Configuration;
+    constexpr u32 buffer_length = 1400; // In samples, a multiple of the 14 samples of ADPCM frames
+
+    std::mt19937 rng(1);
+    TraceFrame first{};
+    for (std::size_t i = 0; i < num_sources; i++) {
+        const bool adpcm = i % 2 != 0;
+        Configuration& config = first.source_configurations.config[i];
+        config.enable = 1;
+        config.enable_dirty.Assign(1);
+        config.rate_multiplier = 0.8f + 0.05f * i;
+        config.rate_multiplier_dirty.Assign(1);
+        config.interpolation_mode = adpcm ? Configuration::InterpolationMode::Linear
+                                          : Configuration::InterpolationMode::Polyphase;
+        config.interpolation_dirty.Assign(1);
+        config.gain[0][0] = config.gain[0][1] = 1.0f / num_sources;
+        config.gain_0_dirty.Assign(1);
+
+        config.format.Assign(adpcm ? Configuration::Format::ADPCM : Configuration::Format::PCM16);
+        config.mono_or_stereo.Assign(Configuration::MonoOrStereo::Mono);
+        config.physical_address = static_cast<u32>(0x20000000 + i * 0x10000);
+        config.length = buffer_length;
+        config.is_looping.Assign(1);
+        config.buffer_id = 1;
+        config.embedded_buffer_dirty.Assign(1);
+
+        if (adpcm) {
+            const s16 coeffs[16] = {0x400, -0x100, 0x300, -0x80, 0x200, 0x100, 0x380, -0x200};
+            std::copy(std::begin(coeffs), std::end(coeffs), first.adpcm_coefficients.coeff[i]);
+            config.adpcm_coefficients_dirty.Assign(1);
+        }
+
+        TraceFrame::Buffer buffer{config.physical_address};
+        buffer.data.resize(adpcm ? buffer_length / 14 * 8 : buffer_length * sizeof(s16));
+        std::generate(buffer.data.begin(), buffer.data.end(),
+                      [&rng] { return static_cast<u8>(rng()); });
+        first.buffers.push_back(std::move(buffer));
+    }
+    first.dsp_configuration.volume[0] = 1.0f;
+    first.dsp_configuration.volume_0_dirty.Assign(1);
+
+    // The application only sets the dirty flags once
+    TraceFrame next = first;
+    next.buffers.clear();
+    for (Configuration& config : next.source_configurations.config) {
+        config.dirty_raw = 0;
+    }
+    next.dsp_configuration.dirty_raw = 0;
+
+    std::vector<TraceFrame> frames(num_frames, next);
+    frames[0] = first;
+    return frames;
+}
+
+/// Replays a trace with a new DSP, and returns its output
+static std::vector<s16> Replay(const std::vector<TraceFrame>& frames,
+                               const std::string& capture_path = "") {
+    // Each DSP registers its tick event, which can only be registered once per session
+    CoreTiming::Init();
+    SCOPE_EXIT({ CoreTiming::Shutdown(); });
+
+    DspHle dsp(false);
+    auto sink = std::make_unique<CaptureSink>();
+    CaptureSink& capture = *sink;
+    dsp.SetSink(std::move(sink));
+    if (!capture_path.empty()) {
+        dsp.StartTraceCapture(capture_path);
+    }
+
+    for (const TraceFrame& frame : frames) {
+        dsp.ReplayTraceFrame(frame);
+    }
+    return capture.samples;
+}
+
+TEST_CASE("DspHle trace capture and replay", "[audio_core]") {
+    const std::string path = FileUtil::GetCurrentDir() + "/dsp_trace_test.bin";
+    const std::vector<TraceFrame> frames = MakeTrace(4, 50);
+    const std::vector<s16> output = Replay(frames, path);
+    REQUIRE(output.size() == frames.size() * samples_per_frame * 2);
+    REQUIRE(std::any_of(output.begin(), output.end(), [](s16 sample) { return sample != 0; }));
+
+    // The looping buffers are only recorded the first time they are played
+    const std::vector<TraceFrame> loaded = LoadTrace(path);
+    REQUIRE(loaded.size() == frames.size());
+    REQUIRE(loaded[0].buffers.size() == 4);
+    for (std::size_t i = 1; i < loaded.size(); i++) {
+        REQUIRE(loaded[i].buffers.empty());
+    }
+
+    REQUIRE(Replay(loaded) == output);
+
+    // The frames of an interrupted recording are loaded up to the last complete one
+    REQUIRE(FileUtil::IOFile(path, "r+b").Resize(FileUtil::GetSize(path) - 1));
+    REQUIRE(LoadTrace(path).size() == frames.size() - 1);
+
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("DspHle trace records buffers written while they are played", "[audio_core]") {
+    const std::string path = FileUtil::GetCurrentDir() + "/dsp_trace_test.bin";
+    // The trace ends before the buffer loops, so it is dequeued only once
+    const std::vector<TraceFrame> frames = MakeTrace(1, 10);
+
+    // The application writes new samples to the buffer before the DSP decodes its end, which only
+    // fits partially in the decoded samples of a source
+    std::vector<TraceFrame> modified_frames = frames;
+    TraceFrame::Buffer new_buffer = frames[0].buffers[0];
+    std::reverse(new_buffer.data.begin(), new_buffer.data.end());
+    modified_frames[2].buffers.push_back(new_buffer);
+
+    const std::vector<s16> output = Replay(modified_frames, path);
+    REQUIRE(output != Replay(frames));
+
+    // The new contents are recorded when they are read, and replay the same
+    const std::vector<TraceFrame> loaded = LoadTrace(path);
+    REQUIRE(loaded.size() == frames.size());
+    REQUIRE(std::count_if(loaded.begin(), loaded.end(), [](const TraceFrame& frame) {
+                return !frame.buffers.empty();
+            }) == 2);
+    REQUIRE(Replay(loaded) == output);
+
+    FileUtil::Delete(path);
+}
+
+TEST_CASE("TraceWriter identifies buffers by address, length and id", "[audio_core]") {
+    const std::string path = FileUtil::GetCurrentDir() + "/dsp_trace_test.bin";
+    std::vector<u8> data(64, 1);
+    {
+        TraceWriter writer(path);
+        BufferRead read{0x20000000, 32, 1, data.size(), 0, 16};
+        REQUIRE(writer.IsNewBuffer(read, data.data()));
+        REQUIRE(!writer.IsNewBuffer(read, data.data()));
+
+        // Only the part of a known buffer being decoded is compared
+        data[40] = 2;
+        REQUIRE(!writer.IsNewBuffer(read, data.data()));
+        read.decode_offset = 32;
+        REQUIRE(writer.IsNewBuffer(read, data.data()));
+
+        // Another buffer at the same address is compared whole
+        read.buffer_id = 2;
+        read.decode_offset = 0;
+        REQUIRE(!writer.IsNewBuffer(read, data.data()));
+        data[63] = 3;
+        read.buffer_id = 3;
+        REQUIRE(writer.IsNewBuffer(read, data.data()));
+    }
+    FileUtil::Delete(path);
+}
+
+// Replays the trace named by the CITRA_DSP_TRACE environment variable, or a synthetic one
+TEST_CASE("DspHle only uses polyphase interpolation when enabled", "[audio_core]") {
+    using InterpolationMode = SourceConfiguration::Configuration::InterpolationMode;
+    const bool enable_polyphase = Settings::values.enable_polyphase_interpolation;
+    SCOPE_EXIT({ Settings::values.enable_polyphase_interpolation = enable_polyphase; });
+
+    // The first source is configured for polyphase interpolation
+    const std::vector<TraceFrame> polyphase = MakeTrace(2, 20);
+    std::vector<TraceFrame> linear = polyphase;
+    linear[0].source_configurations.config[0].interpolation_mode = InterpolationMode::Linear;
+
+    Settings::values.enable_polyphase_interpolation = false;
+    REQUIRE(Replay(polyphase) == Replay(linear));
+
+    Settings::values.enable_polyphase_interpolation = true;
+    REQUIRE(Replay(polyphase) != Replay(linear));
+}
+
+TEST_CASE("DspHle trace replay benchmark", "[.][benchmark][audio_core]") {
+    CoreTiming::Init();
+
+    const char* const trace_path = std::getenv("CITRA_DSP_TRACE");
+    const std::vector<TraceFrame> frames =
+        trace_path != nullptr ? LoadTrace(trace_path) : MakeTrace(num_sources, 2000);
+    REQUIRE(!frames.empty());
+
+    StageTimes times;
+    {
+        DspHle dsp(false);
+        dsp.SetSink(std::make_unique<CaptureSink>());
+        dsp.SetStageTimes(&times);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (const TraceFrame& frame : frames) {
+            dsp.ReplayTraceFrame(frame);
+        }
+        const std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+        WARN("Replayed " << frames.size() / time.count() << " frames per second");
+    }
+
+    const auto per_frame = [&frames](std::chrono::nanoseconds stage) {
+        return std::chrono::duration<double, std::micro>(stage).count() / frames.size();
+    };
+    WARN("Per frame: decode " << per_frame(times.decode) << " us, interpolate "
+                              << per_frame(times.interpolate) << " us, filter "
+                              << per_frame(times.filter) << " us, mix " << per_frame(times.mix)
+                              << " us");
+
+    CoreTiming::Shutdown();
+}
+
+} // namespace HLE
+} // namespace AudioCore
@@ -0,0 +1,234 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/codec.h"
+#include "audio_core/interpolate.h"
+
+namespace AudioCore {
+
+using Sample = StereoBuffer16::Sample;
+
+/// Linear interpolation of a whole signal at once, with the two-sample predelay
+static std::vector<Sample> ReferenceLinear(const std::vector<Sample>& input, float rate) {
+    std::vector<Sample> padded(2, Sample{});
+    padded.insert(padded.end(), input.begin(), input.end());
+
+    std::vector<Sample> output;
+    const u64 step_size = static_cast<u64>(rate * (1 << 24));
+    for (u64 fposition = 0; fposition / (1 << 24) + 2 < padded.size(); fposition += step_size) {
+        const std::size_t i = static_cast<std::size_t>(fposition >> 24);
+        const u64 fraction = fposition & 0xFFFFFF;
+        Sample sample;
+        for (std::size_t channel = 0; channel < 2; ++channel) {
+            const s64 delta =
+                std::clamp<s64>(padded[i + 1][channel] - padded[i][channel], -32768, 32767);
+            sample[channel] = static_cast<s16>(padded[i][channel] + fraction * delta / (1 << 24));
+        }
+        output.push_back(sample);
+    }
+    return output;
+}
+
+TEST_CASE("StereoBuffer16", "[audio_core]") {
+    StereoBuffer16 buffer;
+    REQUIRE(buffer.Empty());
+
+    // Fill the buffer across its end several times
+    s16 next_in = 0;
+    s16 next_out = 0;
+    for (int i = 0; i < 10; ++i) {
+        const std::size_t count = buffer.FreeSpace() - 7;
+        buffer.Append(count, [&](Sample* output, std::size_t offset, std::size_t length) {
+            REQUIRE(offset + length <= count);
+            for (std::size_t j = 0; j < length; ++j) {
+                output[j].fill(next_in++);
+            }
+        });
+        REQUIRE(buffer.Size() == StereoBuffer16::CAPACITY - 7);
+
+        for (std::size_t j = 0; j < buffer.Size(); ++j) {
+            REQUIRE(buffer[j][0] == static_cast<s16>(next_out + j));
+        }
+        buffer.Pop(300);
+        next_out += 300;
+    }
+}
+
+TEST_CASE("AudioInterp::Linear over a refilled buffer", "[audio_core]") {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> sample_dist(-32768, 32767);
+    std::vector<Sample> input(5000);
+    for (Sample& sample : input) {
+        sample = {static_cast<s16>(sample_dist(rng)), static_cast<s16>(sample_dist(rng))};
+    }
+
+    for (const float rate : {0.37f, 1.0f, 1.5f, 3.9f}) {
+        const std::vector<Sample> expected = ReferenceLinear(input, rate);
+
+        // Feed the input in random amounts, like buffers decoded progressively
+        std::uniform_int_distribution<std::size_t> chunk_dist(1, StereoBuffer16::CAPACITY);
+        AudioInterp::State state;
+        StereoBuffer16 buffer;
+        std::vector<Sample> output;
+        std::size_t inputi = 0;
+        while (inputi < input.size()) {
+            const std::size_t count =
+                std::min({chunk_dist(rng), buffer.FreeSpace(), input.size() - inputi});
+            buffer.Append(count, [&](Sample* out, std::size_t offset, std::size_t length) {
+                std::copy_n(input.begin() + inputi + offset, length, out);
+            });
+            inputi += count;
+
+            StereoFrame16 frame;
+            std::size_t frame_position = 0;
+            AudioInterp::Linear(state, buffer, rate, frame, frame_position);
+            output.insert(output.end(), frame.begin(), frame.begin() + frame_position);
+        }
+
+        // Drain what is left
+        while (!buffer.Empty()) {
+            StereoFrame16 frame;
+            std::size_t frame_position = 0;
+            AudioInterp::Linear(state, buffer, rate, frame, frame_position);
+            output.insert(output.end(), frame.begin(), frame.begin() + frame_position);
+        }
+
+        REQUIRE(output == expected);
+    }
+}
+
+/// Resamples the input with the polyphase filter, feeding it in chunks of random sizes
+static std::vector<Sample> ResamplePolyphase(const std::vector<Sample>& input, float rate,
+                                             unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<std::size_t> chunk_dist(1, StereoBuffer16::CAPACITY);
+    AudioInterp::State state;
+    StereoBuffer16 buffer;
+    std::vector<Sample> output;
+    std::size_t inputi = 0;
+    while (inputi < input.size() || !buffer.Empty()) {
+        const std::size_t count =
+            std::min({chunk_dist(rng), buffer.FreeSpace(), input.size() - inputi});
+        buffer.Append(count, [&](Sample* out, std::size_t offset, std::size_t length) {
+            std::copy_n(input.begin() + inputi + offset, length, out);
+        });
+        inputi += count;
+
+        StereoFrame16 frame;
+        std::size_t frame_position = 0;
+        AudioInterp::Polyphase(state, buffer, rate, frame, frame_position);
+        output.insert(output.end(), frame.begin(), frame.begin() + frame_position);
+    }
+    return output;
+}
+
+TEST_CASE("AudioInterp::Polyphase", "[audio_core]") {
+    SECTION("copies the input at a rate of 1.0") {
+        std::mt19937 rng(3);
+        std::vector<Sample> input(3000);
+        for (Sample& sample : input) {
+            sample = {static_cast<s16>(rng()), static_cast<s16>(rng())};
+        }
+
+        // Eight samples of predelay, the last eight samples are only used as lookahead
+        const std::vector<Sample> output = ResamplePolyphase(input, 1.0f, 1);
+        REQUIRE(output.size() == input.size());
+        REQUIRE(std::all_of(output.begin(), output.begin() + 8,
+                            [](const Sample& sample) { return sample == Sample{}; }));
+        REQUIRE(std::equal(output.begin() + 8, output.end(), input.begin()));
+    }
+
+    SECTION("does not depend on how the input is split") {
+        std::mt19937 rng(4);
+        std::vector<Sample> input(5000);
+        for (Sample& sample : input) {
+            sample = {static_cast<s16>(rng() % 20000), static_cast<s16>(rng() % 20000)};
+        }
+
+        for (const float rate : {0.3f, 0.9999f, 1.7f}) {
+            REQUIRE(ResamplePolyphase(input, rate, 1) == ResamplePolyphase(input, rate, 2));
+        }
+    }
+
+    SECTION("reconstructs a sine wave more accurately than linear interpolation") {
+        constexpr double amplitude = 20000.0;
+        constexpr double step = 2 * 3.14159265358979323846 * 1500.0 / native_sample_rate;
+        std::vector<Sample> input(4000);
+        for (std::size_t i = 0; i < input.size(); i++) {
+            const s16 sample = static_cast<s16>(std::lround(amplitude * std::sin(step * i)));
+            input[i] = {sample, static_cast<s16>(-sample)};
+        }
+
+        constexpr float rate = 0.73f;
+        const std::vector<Sample> polyphase = ResamplePolyphase(input, rate, 1);
+        const std::vector<Sample> linear = ReferenceLinear(input, rate);
+
+        // Largest error past the start of the signal, given the predelay of the interpolator
+        const auto max_error = [&](const std::vector<Sample>& output, double predelay) {
+            double error = 0.0;
+            for (std::size_t i = 32; i < output.size(); i++) {
+                const double expected = amplitude * std::sin(step * (i * rate - predelay));
+                error = std::max(error, std::abs(output[i][0] - expected));
+                error = std::max(error, std::abs(output[i][1] + expected));
+            }
+            return error;
+        };
+
+        const double polyphase_error = max_error(polyphase, 8.0);
+        REQUIRE(polyphase_error < 8.0);
+        REQUIRE(polyphase_error * 10 < max_error(linear, 2.0));
+    }
+}
+
+TEST_CASE("Audio source decoding benchmark", "[.][benchmark][audio_core]") {
+    constexpr std::size_t NUM_SOURCES = 24;
+    constexpr std::size_t NUM_FRAMES = 2000;
+
+    std::mt19937 rng(1);
+    std::vector<u8> adpcm(0x8000);
+    std::generate(adpcm.begin(), adpcm.end(), [&rng] { return static_cast<u8>(rng()); });
+    const std::array<s16, 16> coeffs{0x400, -0x100, 0x300, -0x80, 0x200, 0x100, 0x380, -0x200};
+    const std::size_t adpcm_samples = adpcm.size() / 8 * 14;
+
+    struct BenchSource {
+        StereoBuffer16 buffer;
+        AudioInterp::State interp_state;
+        Codec::ADPCMState adpcm_state{};
+        std::size_t position = 0;
+    };
+    std::vector<BenchSource> sources(NUM_SOURCES);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t frame_index = 0; frame_index < NUM_FRAMES; ++frame_index) {
+        for (BenchSource& source : sources) {
+            StereoFrame16 frame;
+            std::size_t frame_position = 0;
+            while (frame_position < frame.size()) {
+                if (source.buffer.Empty()) {
+                    const std::size_t count = std::min(source.buffer.FreeSpace(),
+                                                       adpcm_samples - source.position);
+                    source.buffer.Append(
+                        count, [&](Sample* output, std::size_t offset, std::size_t length) {
+                            Codec::DecodeADPCM(adpcm.data(), source.position + offset, length,
+                                               coeffs, source.adpcm_state, output);
+                        });
+                    source.position = (source.position + count) % adpcm_samples;
+                }
+                AudioInterp::Linear(source.interp_state, source.buffer, 1.1f, frame,
+                                    frame_position);
+            }
+        }
+    }
+    const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+
+    WARN("Generated " << NUM_SOURCES * NUM_FRAMES / time.count() << " source frames per ms");
+}
+
+} // namespace AudioCore
@@ -0,0 +1,73 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <catch2/catch.hpp>
+#include "audio_core/latency_controller.h"
+
+namespace AudioCore {
+
+using namespace std::chrono_literals;
+
+constexpr unsigned int sample_rate = 48000;
+constexpr std::size_t callback_frames = 480; // 10 ms
+
+/// Runs the given number of callbacks, each late by the given amount of time, then on time again
+static LatencyController::Clock::time_point RunCallbacks(LatencyController& controller,
+                                                         LatencyController::Clock::time_point now,
+                                                         int count,
+                                                         std::chrono::microseconds lateness) {
+    for (int i = 0; i < count; i++) {
+        now += 10ms + lateness;
+        controller.OnCallback(now, callback_frames);
+        now += 10ms - lateness;
+        controller.OnCallback(now, callback_frames);
+    }
+    return now;
+}
+
+TEST_CASE("LatencyController", "[audio_core]") {
+    LatencyController controller(sample_rate);
+    auto now = RunCallbacks(controller, {}, 100, 0us);
+    REQUIRE(controller.GetJitter() == Approx(0.0).margin(1e-9));
+
+    // Without jitter, the minimum latency only covers a callback and the bursts of the emulation
+    const double steady_latency = controller.GetMinimumLatency();
+    REQUIRE(steady_latency > 0.010);
+    REQUIRE(steady_latency < 0.040);
+
+    SECTION("targets the configured latency when it is enough") {
+        REQUIRE(controller.GetTargetLatency(0.1, false) == 0.1);
+        REQUIRE(controller.GetTargetLatency(0.001, false) == steady_latency);
+        REQUIRE(controller.GetTargetLatency(0.1, true) == steady_latency);
+    }
+
+    SECTION("raises the latency with the jitter, then lowers it back") {
+        now = RunCallbacks(controller, now, 10, 4ms);
+        REQUIRE(controller.GetJitter() == Approx(0.004));
+        REQUIRE(controller.GetMinimumLatency() == Approx(steady_latency + 0.008));
+
+        // Ten seconds without jitter
+        RunCallbacks(controller, now, 500, 0us);
+        REQUIRE(controller.GetJitter() < 0.001);
+    }
+
+    SECTION("raises the latency after underruns") {
+        for (int i = 0; i < 5; i++) {
+            controller.OnUnderrun();
+        }
+        REQUIRE(controller.GetMinimumLatency() > steady_latency + 0.020);
+        REQUIRE(controller.GetTargetLatency(0.1, true) > steady_latency + 0.020);
+
+        // The margin added by underruns is bounded, and decays
+        for (int i = 0; i < 1000; i++) {
+            controller.OnUnderrun();
+        }
+        REQUIRE(controller.GetMinimumLatency() <= steady_latency + 0.1);
+        RunCallbacks(controller, now, 2000, 0us);
+        REQUIRE(controller.GetMinimumLatency() < steady_latency + 0.001);
+    }
+}
+
+} // namespace AudioCore
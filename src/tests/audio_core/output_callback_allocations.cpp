@@ -0,0 +1,106 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// The allocations are counted by replacing the global operator new, which applies to the whole
+// executable. This test is thus built in an executable of its own.
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "tests/audio_core/dsp_test_common.h"
+
+namespace {
+/// Set on the thread running the audio callback while its allocations are counted
+thread_local bool counting_allocations = false;
+std::size_t allocation_count = 0;
+} // namespace
+
+void* operator new(std::size_t size) {
+    if (counting_allocations)
+        ++allocation_count;
+    if (void* ptr = std::malloc(size != 0 ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace AudioCore {
+
+/// Runs the output callback, and returns the number of allocations it made.
+static std::size_t RunCallbacks(TestDsp& dsp, FakeSink& sink, int count) {
+    std::size_t frames_queued = 0;
+    std::vector<s16> buffer(CALLBACK_FRAMES * 2);
+    allocation_count = 0;
+    for (int i = 0; i < count; ++i) {
+        QueueCallbackFrames(dsp, frames_queued);
+        counting_allocations = true;
+        sink.callback(buffer.data(), CALLBACK_FRAMES);
+        counting_allocations = false;
+    }
+    return allocation_count;
+}
+
+/**
+ * Runs the output callback, outputting a number of audio frames of the DSP before each callback
+ * instead of following the sink, and returns the number of allocations it made.
+ */
+static std::size_t RunCallbacksProducing(TestDsp& dsp, FakeSink& sink, int count,
+                                         int frames_per_callback) {
+    StereoFrame16 frame{};
+    std::vector<s16> buffer(CALLBACK_FRAMES * 2);
+    allocation_count = 0;
+    for (int i = 0; i < count; ++i) {
+        for (int j = 0; j < frames_per_callback; ++j) {
+            dsp.OutputFrame(frame);
+        }
+        counting_allocations = true;
+        sink.callback(buffer.data(), CALLBACK_FRAMES);
+        counting_allocations = false;
+    }
+    return allocation_count;
+}
+
+TEST_CASE("DspInterface::OutputCallback does not allocate", "[audio_core]") {
+    auto dsp = std::make_unique<TestDsp>();
+    auto sink = std::make_unique<FakeSink>();
+    FakeSink& fake_sink = *sink;
+    dsp->SetSink(std::move(sink));
+
+    SECTION("without time stretching") {
+        // The first callback prepares the output
+        RunCallbacks(*dsp, fake_sink, 1);
+        REQUIRE(RunCallbacks(*dsp, fake_sink, 500) == 0);
+    }
+
+    SECTION("with time stretching") {
+        dsp->EnableStretching(true);
+
+        // Lets the time stretcher reach its steady state
+        RunCallbacks(*dsp, fake_sink, 200);
+        REQUIRE(RunCallbacks(*dsp, fake_sink, 500) == 0);
+    }
+
+    SECTION("with time stretching while the ratio changes") {
+        dsp->EnableStretching(true);
+        RunCallbacks(*dsp, fake_sink, 200);
+
+        // The emulation runs much faster than the sink, which fills the fifo and raises the
+        // ratio, then stops and underruns the fifo, which drops it to its lowest
+        std::size_t allocations = RunCallbacksProducing(*dsp, fake_sink, 200, 12);
+        allocations += RunCallbacksProducing(*dsp, fake_sink, 200, 0);
+        allocations += RunCallbacksProducing(*dsp, fake_sink, 200, 1);
+        allocations += RunCallbacks(*dsp, fake_sink, 200);
+        REQUIRE(allocations == 0);
+    }
+}
+
+} // namespace AudioCore
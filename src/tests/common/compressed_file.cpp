@@ -0,0 +1,125 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/compressed_file.h"
+#include "common/compression.h"
+#include "common/file_util.h"
+
+namespace FileUtil {
+
+/// Returns data that mixes compressible runs and repeated patterns with random bytes.
+static std::vector<u8> MakeTestData(std::size_t size) {
+    std::mt19937 rng(1234);
+    std::vector<u8> data(size);
+    for (std::size_t i = 0; i < size;) {
+        const std::size_t run = std::min<std::size_t>(rng() % 600 + 1, size - i);
+        switch (rng() % 3) {
+        case 0:
+            std::fill_n(data.begin() + i, run, static_cast<u8>(rng()));
+            break;
+        case 1:
+            for (std::size_t j = 0; j < run; ++j)
+                data[i + j] = static_cast<u8>(j % 7);
+            break;
+        default:
+            for (std::size_t j = 0; j < run; ++j)
+                data[i + j] = static_cast<u8>(rng());
+            break;
+        }
+        i += run;
+    }
+    return data;
+}
+
+TEST_CASE("Compression::LZ round trip", "[common]") {
+    for (std::size_t size : {0, 1, 4, 15, 16, 300, 0x10000, 0x23456}) {
+        const std::vector<u8> data = MakeTestData(size);
+        const std::vector<u8> compressed = Common::Compression::CompressLZ(data.data(), size);
+
+        std::vector<u8> decompressed(size);
+        REQUIRE(Common::Compression::DecompressLZ(compressed.data(), compressed.size(),
+                                                  decompressed.data(), size));
+        REQUIRE(decompressed == data);
+    }
+
+    const std::vector<u8> zeros(0x10000, 0);
+    REQUIRE(Common::Compression::CompressLZ(zeros.data(), zeros.size()).size() < 0x200);
+}
+
+TEST_CASE("Compression::LZ rejects corrupted data", "[common]") {
+    const std::vector<u8> data = MakeTestData(0x4000);
+    const std::vector<u8> compressed = Common::Compression::CompressLZ(data.data(), data.size());
+    std::vector<u8> decompressed(data.size());
+
+    // Wrong decompressed size
+    REQUIRE(!Common::Compression::DecompressLZ(compressed.data(), compressed.size(),
+                                               decompressed.data(), data.size() - 1));
+    // Truncated data
+    REQUIRE(!Common::Compression::DecompressLZ(compressed.data(), compressed.size() / 2,
+                                               decompressed.data(), data.size()));
+    // Match pointing before the start of the data
+    const std::vector<u8> bad_offset{0x10, 'a', 0x05, 0x00};
+    REQUIRE(!Common::Compression::DecompressLZ(bad_offset.data(), bad_offset.size(),
+                                               decompressed.data(), 5));
+}
+
+TEST_CASE("CompressedFile random access", "[common]") {
+    const std::string raw_path = GetCurrentDir() + "/compressed_file_test.bin";
+    const std::string compressed_path = GetCurrentDir() + "/compressed_file_test.zcci";
+    const std::vector<u8> data = MakeTestData(0x31234);
+    IOFile(raw_path, "wb").WriteBytes(data.data(), data.size());
+
+    REQUIRE(CompressROM(raw_path, compressed_path, 0x1000, 4));
+    REQUIRE(GetSize(compressed_path) < data.size());
+
+    {
+        IOFile raw_file(raw_path, "rb");
+        REQUIRE(!CompressedFile::IsCompressedFile(raw_file));
+
+        CompressedFile compressed_file(IOFile(compressed_path, "rb"), 0x4000);
+        REQUIRE(compressed_file.IsOpen());
+        REQUIRE(compressed_file.GetSize() == data.size());
+
+        std::mt19937 rng(5678);
+        std::vector<u8> buffer;
+        for (int i = 0; i < 500; ++i) {
+            const std::size_t offset = rng() % data.size();
+            const std::size_t length = std::min<std::size_t>(rng() % 0x3000, data.size() - offset);
+            buffer.assign(length, 0);
+            REQUIRE(compressed_file.ReadBytesAt(buffer.data(), length, offset) == length);
+            REQUIRE(std::equal(buffer.begin(), buffer.end(), data.begin() + offset));
+        }
+
+        // Reads are clamped to the end of the data
+        buffer.assign(0x10, 0);
+        REQUIRE(compressed_file.ReadBytesAt(buffer.data(), 0x10, data.size() - 4) == 4);
+        REQUIRE(compressed_file.GetCacheStats().hits != 0);
+    }
+
+    {
+        ROMFile rom_file(compressed_path);
+        REQUIRE(rom_file.IsCompressed());
+        REQUIRE(rom_file.GetSize() == data.size());
+        REQUIRE(rom_file.Seek(0x2000, SEEK_SET));
+
+        std::vector<u8> buffer(0x100);
+        REQUIRE(rom_file.ReadBytes(buffer.data(), buffer.size()) == buffer.size());
+        REQUIRE(rom_file.Tell() == 0x2100);
+        REQUIRE(std::equal(buffer.begin(), buffer.end(), data.begin() + 0x2000));
+
+        ROMFile raw_rom_file(raw_path);
+        REQUIRE(!raw_rom_file.IsCompressed());
+        REQUIRE(raw_rom_file.GetRawFile() != nullptr);
+        REQUIRE(raw_rom_file.GetSize() == data.size());
+    }
+
+    Delete(raw_path);
+    Delete(compressed_path);
+}
+
+} // namespace FileUtil
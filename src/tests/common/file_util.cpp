@@ -0,0 +1,31 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+
+namespace FileUtil {
+
+TEST_CASE("FileUtil::MappedFile", "[common]") {
+    const std::string path = GetCurrentDir() + "/mapped_file_test.bin";
+    const std::vector<u8> data{1, 2, 3, 4, 5};
+    IOFile(path, "wb").WriteBytes(data.data(), data.size());
+
+    {
+        MappedFile mapped_file(IOFile(path, "rb"));
+        REQUIRE(mapped_file.IsOpen());
+        REQUIRE(mapped_file.GetSize() == data.size());
+        REQUIRE(std::equal(data.begin(), data.end(), mapped_file.GetData()));
+
+        MappedFile moved = std::move(mapped_file);
+        REQUIRE(!mapped_file.IsOpen());
+        REQUIRE(moved.GetData()[4] == 5);
+    }
+
+    Delete(path);
+}
+
+} // namespace FileUtil
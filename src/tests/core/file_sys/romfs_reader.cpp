@@ -0,0 +1,136 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/scope_exit.h"
+#include "core/file_sys/romfs_reader.h"
+#include "core/settings.h"
+
+namespace FileSys {
+
+constexpr std::size_t HEADER_SIZE = 0x123;
+constexpr std::size_t DATA_SIZE = 0x200456; ///< Larger than the smallest cache, of 1 MiB
+constexpr std::array<u8, 16> KEY{0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+constexpr std::array<u8, 16> CTR{0xFE, 0xDC, 0xBA, 0x98, 0x76, 0x54, 0x32, 0x10};
+constexpr std::size_t CRYPTO_OFFSET = 0x1000;
+
+static void WriteTestFile(const std::string& path, const std::vector<u8>& data) {
+    std::vector<u8> contents(HEADER_SIZE);
+    contents.insert(contents.end(), data.begin(), data.end());
+    REQUIRE(FileUtil::IOFile(path, "wb").WriteBytes(contents.data(), contents.size()) ==
+            contents.size());
+}
+
+static void CheckRandomReads(RomFSReader& reader, const std::vector<u8>& expected,
+                             std::mt19937& rng) {
+    REQUIRE(reader.GetSize() == expected.size());
+
+    std::uniform_int_distribution<std::size_t> offset_dist(0, expected.size() - 1);
+    std::uniform_int_distribution<std::size_t> length_dist(1, 0x5000);
+    std::vector<u8> buffer;
+    for (int i = 0; i < 500; ++i) {
+        const std::size_t offset = offset_dist(rng);
+        const std::size_t length = length_dist(rng);
+        const std::size_t expected_length = std::min(length, expected.size() - offset);
+        buffer.assign(length, 0);
+        REQUIRE(reader.ReadFile(offset, length, buffer.data()) == expected_length);
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + expected_length,
+                           expected.begin() + offset));
+    }
+
+    // Reads past the end return nothing
+    u8 byte;
+    REQUIRE(reader.ReadFile(expected.size(), 1, &byte) == 0);
+}
+
+TEST_CASE("RomFSReader", "[core][file_sys]") {
+    const std::string path = FileUtil::GetCurrentDir() + "/romfs_reader_test.bin";
+    const u16 romfs_cache_size = Settings::values.romfs_cache_size;
+    SCOPE_EXIT({
+        Settings::values.romfs_cache_size = romfs_cache_size;
+        FileUtil::Delete(path);
+    });
+
+    std::mt19937 rng(1234);
+    std::vector<u8> data(DATA_SIZE);
+    std::generate(data.begin(), data.end(), [&rng] { return static_cast<u8>(rng()); });
+
+    SECTION("unencrypted") {
+        WriteTestFile(path, data);
+        RomFSReader reader(FileUtil::IOFile(path, "rb"), HEADER_SIZE, DATA_SIZE);
+        CheckRandomReads(reader, data, rng);
+    }
+
+    SECTION("encrypted") {
+        // Decrypting zeroes yields the key stream, which is used to encrypt the test data
+        Settings::values.romfs_cache_size = 0;
+        WriteTestFile(path, std::vector<u8>(DATA_SIZE));
+        std::vector<u8> key_stream(DATA_SIZE);
+        RomFSReader(FileUtil::IOFile(path, "rb"), HEADER_SIZE, DATA_SIZE, KEY, CTR, CRYPTO_OFFSET)
+            .ReadFile(0, DATA_SIZE, key_stream.data());
+
+        std::vector<u8> encrypted(DATA_SIZE);
+        std::transform(data.begin(), data.end(), key_stream.begin(), encrypted.begin(),
+                       [](u8 a, u8 b) { return static_cast<u8>(a ^ b); });
+        WriteTestFile(path, encrypted);
+
+        // Use a cache too small to hold all the data
+        Settings::values.romfs_cache_size = 1;
+        RomFSReader reader(FileUtil::IOFile(path, "rb"), HEADER_SIZE, DATA_SIZE, KEY, CTR,
+                           CRYPTO_OFFSET);
+
+        // Reading all the data in order evicts every block before it is read again
+        constexpr std::size_t block_size = RomFSReader::CACHE_BLOCK_SIZE;
+        constexpr std::size_t num_blocks = (DATA_SIZE + block_size - 1) / block_size;
+        std::vector<u8> buffer(block_size);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (std::size_t offset = 0; offset < DATA_SIZE; offset += block_size) {
+                const std::size_t length = reader.ReadFile(offset, block_size, buffer.data());
+                REQUIRE(length == std::min(block_size, DATA_SIZE - offset));
+                REQUIRE(std::equal(buffer.begin(), buffer.begin() + length,
+                                   data.begin() + offset));
+            }
+        }
+        REQUIRE(reader.GetCacheStats().hits == 0);
+        REQUIRE(reader.GetCacheStats().misses == 2 * num_blocks);
+
+        // The blocks read last are still cached
+        REQUIRE(reader.ReadFile(DATA_SIZE - 0x10, 0x10, buffer.data()) == 0x10);
+        REQUIRE(reader.GetCacheStats().hits == 1);
+
+        CheckRandomReads(reader, data, rng);
+
+        // Blocks are read and decrypted outside of the cache lock, concurrent reads of the same
+        // blocks must still return the right data
+        std::atomic<bool> mismatch{false};
+        std::vector<std::thread> threads;
+        for (u32 seed = 0; seed < 4; ++seed) {
+            threads.emplace_back([&reader, &data, &mismatch, seed] {
+                std::mt19937 thread_rng(seed);
+                std::uniform_int_distribution<std::size_t> offset_dist(0, DATA_SIZE - 0x400);
+                std::vector<u8> thread_buffer(0x400);
+                for (int i = 0; i < 2000; ++i) {
+                    const std::size_t offset = offset_dist(thread_rng);
+                    if (reader.ReadFile(offset, thread_buffer.size(), thread_buffer.data()) !=
+                            thread_buffer.size() ||
+                        !std::equal(thread_buffer.begin(), thread_buffer.end(),
+                                    data.begin() + offset)) {
+                        mismatch = true;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+        REQUIRE(!mismatch);
+    }
+}
+
+} // namespace FileSys
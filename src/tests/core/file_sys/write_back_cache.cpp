@@ -0,0 +1,206 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <functional>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/write_back_cache.h"
+
+namespace FileSys {
+
+static std::vector<u8> ReadHostFile(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    std::vector<u8> data(file.GetSize());
+    REQUIRE(file.ReadBytes(data.data(), data.size()) == data.size());
+    return data;
+}
+
+TEST_CASE("WriteBackCache", "[core][file_sys]") {
+    const std::string path = FileUtil::GetCurrentDir() + "/write_back_cache_test.bin";
+    const std::vector<u8> original(0x100, 0xAA);
+    REQUIRE(FileUtil::IOFile(path, "wb").WriteBytes(original.data(), original.size()) ==
+            original.size());
+
+    SECTION("small writes are coalesced into a single commit") {
+        FileUtil::IOFile file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, file);
+        REQUIRE(cache != nullptr);
+        file.Close();
+
+        // Typical save pattern: the whole file is rewritten in small chunks, then flushed
+        std::vector<u8> expected(0x1000);
+        for (std::size_t offset = 0; offset < expected.size(); offset += 0x10) {
+            std::vector<u8> chunk(0x10, static_cast<u8>(offset / 0x10));
+            std::copy(chunk.begin(), chunk.end(), expected.begin() + offset);
+            REQUIRE(cache->Write(offset, chunk.size(), false, chunk.data()) == chunk.size());
+        }
+
+        REQUIRE(cache->GetSize() == expected.size());
+        REQUIRE(ReadHostFile(path) == original);
+
+        std::vector<u8> buffer(expected.size());
+        REQUIRE(cache->Read(0, buffer.size(), buffer.data()) == buffer.size());
+        REQUIRE(buffer == expected);
+
+        REQUIRE(cache->Commit());
+        REQUIRE(ReadHostFile(path) == expected);
+        REQUIRE(!FileUtil::Exists(path + ".tmp"));
+
+        const auto stats = cache->GetStats();
+        REQUIRE(stats.guest_writes == expected.size() / 0x10);
+        REQUIRE(stats.commits == 1);
+    }
+
+    SECTION("files opened on the same path share the cache") {
+        FileUtil::IOFile file(path, "r+b");
+        auto first = WriteBackCache::Open(path, file);
+        auto second = WriteBackCache::Open(path, file);
+        REQUIRE(first == second);
+
+        const u8 value = 0x55;
+        REQUIRE(first->Write(0x10, 1, false, &value) == 1);
+        first.reset();
+
+        u8 read_value = 0;
+        REQUIRE(second->Read(0x10, 1, &read_value) == 1);
+        REQUIRE(read_value == value);
+        REQUIRE(ReadHostFile(path) == original);
+
+        // Releasing the last user commits the contents
+        second.reset();
+        std::vector<u8> expected = original;
+        expected[0x10] = value;
+        REQUIRE(ReadHostFile(path) == expected);
+    }
+
+    SECTION("guest flushes are coalesced into the next periodic commit") {
+        FileUtil::IOFile file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, file);
+        file.Close();
+
+        cache->SetSize(0x80);
+        const u8 value = 0x11;
+        REQUIRE(cache->Write(0, 1, true, &value) == 1);
+        REQUIRE(cache->Write(1, 1, true, &value) == 1);
+        REQUIRE(ReadHostFile(path) == original);
+
+        WriteBackCache::CommitExpired();
+        std::vector<u8> expected(original.begin(), original.begin() + 0x80);
+        expected[0] = expected[1] = value;
+        REQUIRE(ReadHostFile(path) == expected);
+        REQUIRE(cache->GetStats().commits == 1);
+
+        WriteBackCache::CommitExpired();
+        REQUIRE(cache->GetStats().commits == 1);
+    }
+
+    SECTION("released caches are committed on the commit runner") {
+        std::vector<std::function<void()>> commits;
+        WriteBackCache::SetCommitRunner(
+            [&commits](std::function<void()> commit) { commits.push_back(std::move(commit)); });
+
+        FileUtil::IOFile file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, file);
+        const u8 value = 0x66;
+        REQUIRE(cache->Write(0, 1, false, &value) == 1);
+        cache.reset();
+        REQUIRE(commits.size() == 1);
+        REQUIRE(ReadHostFile(path) == original);
+
+        // The cache is still used by the files opened before the commit
+        auto reopened = WriteBackCache::Open(path, file);
+        u8 read_value = 0;
+        REQUIRE(reopened->Read(0, 1, &read_value) == 1);
+        REQUIRE(read_value == value);
+
+        WriteBackCache::SetCommitRunner(nullptr);
+        commits[0]();
+        std::vector<u8> expected = original;
+        expected[0] = value;
+        REQUIRE(ReadHostFile(path) == expected);
+        REQUIRE(WriteBackCache::Open(path, file) == reopened);
+    }
+
+    SECTION("pending writes follow a renamed file") {
+        const std::string renamed_path = path + ".renamed";
+        FileUtil::IOFile file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, file);
+        file.Close();
+
+        const u8 value = 0x22;
+        REQUIRE(cache->Write(0, 1, false, &value) == 1);
+        REQUIRE(WriteBackCache::Rename(path, renamed_path));
+
+        std::vector<u8> expected = original;
+        expected[0] = value;
+        REQUIRE(ReadHostFile(renamed_path) == expected);
+
+        // Later writes are committed to the new path
+        REQUIRE(cache->Write(1, 1, false, &value) == 1);
+        cache.reset();
+        expected[1] = value;
+        REQUIRE(ReadHostFile(renamed_path) == expected);
+        REQUIRE(!FileUtil::Exists(path));
+
+        FileUtil::Delete(renamed_path);
+    }
+
+    SECTION("a file created again after a deletion does not see the old contents") {
+        FileUtil::IOFile file(path, "r+b");
+        auto stale = WriteBackCache::Open(path, file);
+        file.Close();
+
+        const u8 value = 0x33;
+        REQUIRE(stale->Write(0, 1, false, &value) == 1);
+        REQUIRE(FileUtil::Delete(path));
+        WriteBackCache::Invalidate(path);
+
+        REQUIRE(FileUtil::CreateEmptyFile(path));
+        FileUtil::IOFile new_file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, new_file);
+        REQUIRE(cache != stale);
+        REQUIRE(cache->GetSize() == 0);
+
+        // Releasing the stale cache does not write its contents over the new file
+        stale.reset();
+        REQUIRE(ReadHostFile(path).empty());
+    }
+
+    SECTION("files growing too large are accessed directly") {
+        FileUtil::IOFile file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, file);
+        file.Close();
+
+        const u8 value = 0x44;
+        REQUIRE(cache->Write(0, 1, false, &value) == 1);
+        REQUIRE(cache->Write(WriteBackCache::MAX_FILE_SIZE, 1, false, &value) == 1);
+        REQUIRE(cache->GetSize() == WriteBackCache::MAX_FILE_SIZE + 1);
+        cache.reset();
+
+        FileUtil::IOFile host_file(path, "rb");
+        REQUIRE(host_file.GetSize() == WriteBackCache::MAX_FILE_SIZE + 1);
+        u8 read_value = 0;
+        REQUIRE(host_file.ReadBytesAt(&read_value, 1, 0) == 1);
+        REQUIRE(read_value == value);
+        REQUIRE(host_file.ReadBytesAt(&read_value, 1, WriteBackCache::MAX_FILE_SIZE) == 1);
+        REQUIRE(read_value == value);
+    }
+
+    SECTION("only the contents dirty for long enough are committed periodically") {
+        FileUtil::IOFile file(path, "r+b");
+        auto cache = WriteBackCache::Open(path, file);
+        file.Close();
+
+        const u8 value = 0x55;
+        REQUIRE(cache->Write(0, 1, false, &value) == 1);
+        WriteBackCache::CommitExpired();
+        REQUIRE(cache->GetStats().commits == 0);
+        REQUIRE(ReadHostFile(path) == original);
+    }
+
+    FileUtil::Delete(path);
+}
+
+} // namespace FileSys
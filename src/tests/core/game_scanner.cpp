@@ -0,0 +1,110 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include <fmt/format.h>
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "core/file_sys/ncch_container.h"
+#include "core/game_scanner.h"
+#include "core/hw/aes/key.h"
+#include "core/loader/loader.h"
+#include "core/loader/smdh.h"
+
+namespace Core {
+
+/**
+ * Writes an NCCH with only an ExeFS holding an icon, encrypted with the key of the Secure1 slot
+ * for the given KeyY, like the ones of retail games.
+ */
+static void WriteEncryptedNCCH(const std::string& path, u64 program_id,
+                               const HW::AES::AESKey& key_y, const std::vector<u8>& smdh) {
+    constexpr std::size_t block_size = 0x200;
+    const std::size_t icon_size = (smdh.size() + block_size - 1) / block_size * block_size;
+
+    NCCH_Header header{};
+    std::copy(key_y.begin(), key_y.end(), header.signature);
+    header.magic = Loader::MakeMagic('N', 'C', 'C', 'H');
+    std::memcpy(header.partition_id, &program_id, sizeof(program_id));
+    header.program_id = program_id;
+    header.version = 2;
+    header.exefs_offset = 1;
+    header.exefs_size = static_cast<u32>((sizeof(ExeFs_Header) + icon_size) / block_size);
+
+    std::vector<u8> exefs(sizeof(ExeFs_Header) + icon_size);
+    ExeFs_Header exefs_header{};
+    std::strcpy(exefs_header.section[0].name, "icon");
+    exefs_header.section[0].offset = 0;
+    exefs_header.section[0].size = static_cast<u32>(smdh.size());
+    std::memcpy(exefs.data(), &exefs_header, sizeof(exefs_header));
+    std::copy(smdh.begin(), smdh.end(), exefs.begin() + sizeof(ExeFs_Header));
+
+    // The ExeFS is encrypted as a single CTR stream, starting with its header
+    HW::AES::SetKeyY(HW::AES::KeySlotID::NCCHSecure1, key_y);
+    const HW::AES::AESKey key = HW::AES::GetNormalKey(HW::AES::KeySlotID::NCCHSecure1);
+    std::array<u8, 16> ctr{};
+    std::reverse_copy(header.partition_id, header.partition_id + 8, ctr.begin());
+    ctr[8] = 2;
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Encryption(key.data(), key.size(), ctr.data())
+        .ProcessData(exefs.data(), exefs.data(), exefs.size());
+
+    FileUtil::IOFile file(path, "wb");
+    REQUIRE(file.WriteObject(header) == 1);
+    REQUIRE(file.WriteBytes(exefs.data(), exefs.size()) == exefs.size());
+}
+
+TEST_CASE("GameScanner decrypts encrypted NCCHs scanned concurrently", "[core]") {
+    constexpr std::size_t NUM_GAMES = 32;
+
+    // Any keys will do, as long as the NCCHs are encrypted with them
+    HW::AES::InitKeys();
+    HW::AES::SetGeneratorConstant({0x1F, 0xF9, 0xE9, 0xAA, 0xC5, 0xFE, 0x04, 0x08, 0x02, 0x45,
+                                   0x91, 0xDC, 0x5D, 0x52, 0x76, 0x8A});
+    HW::AES::SetKeyX(HW::AES::KeySlotID::NCCHSecure1,
+                     {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xFE, 0xDC, 0xBA, 0x98,
+                      0x76, 0x54, 0x32, 0x10});
+
+    const std::string directory = FileUtil::GetCurrentDir() + "/game_scanner_test";
+    REQUIRE(FileUtil::CreateFullPath(directory + DIR_SEP));
+
+    // Each game has its own KeyY, so the games decrypt correctly only with their own key
+    std::mt19937 rng(7);
+    std::vector<std::vector<u8>> smdhs(NUM_GAMES);
+    for (std::size_t i = 0; i < NUM_GAMES; ++i) {
+        HW::AES::AESKey key_y;
+        std::generate(key_y.begin(), key_y.end(), [&rng] { return static_cast<u8>(rng()); });
+        smdhs[i].resize(sizeof(Loader::SMDH));
+        std::generate(smdhs[i].begin(), smdhs[i].end(), [&rng] { return static_cast<u8>(rng()); });
+        std::memcpy(smdhs[i].data(), "SMDH", 4);
+
+        const std::string path = fmt::format("{}/game_{:02}.cxi", directory, i);
+        WriteEncryptedNCCH(path, 0x0004000400000000 + i, key_y, smdhs[i]);
+    }
+
+    std::vector<GameEntry> entries;
+    GameScanner scanner({"cxi"}, "");
+    scanner.ScanDirectory(directory, 0, [](const std::string&) {},
+                          [&entries](const GameEntry& entry) { entries.push_back(entry); });
+
+    // The games are reported in the order of the directory, which is not sorted
+    REQUIRE(entries.size() == NUM_GAMES);
+    std::sort(entries.begin(), entries.end(), [](const GameEntry& a, const GameEntry& b) {
+        return a.program_id < b.program_id;
+    });
+    for (std::size_t i = 0; i < NUM_GAMES; ++i) {
+        REQUIRE(entries[i].program_id == 0x0004000400000000 + i);
+        REQUIRE(entries[i].smdh == smdhs[i]);
+    }
+
+    FileUtil::DeleteDirRecursively(directory);
+}
+
+} // namespace Core
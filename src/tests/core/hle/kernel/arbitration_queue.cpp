@@ -0,0 +1,117 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/hle/kernel/arbitration_queue.h"
+
+namespace Kernel {
+
+namespace {
+struct FakeThread {
+    u32 id;
+    u32 priority;
+    VAddr address;
+};
+} // Anonymous namespace
+
+TEST_CASE("ArbitrationQueue::PopHighestPriority", "[core][kernel]") {
+    ArbitrationQueue<std::shared_ptr<FakeThread>> queue;
+    auto low = std::make_shared<FakeThread>(FakeThread{0, 0x30, 0x1000});
+    auto high_first = std::make_shared<FakeThread>(FakeThread{1, 0x18, 0x1000});
+    auto high_second = std::make_shared<FakeThread>(FakeThread{2, 0x18, 0x1000});
+    auto other_address = std::make_shared<FakeThread>(FakeThread{3, 0x00, 0x2000});
+
+    queue.Push(0x1000, low->priority, low);
+    queue.Push(0x1000, high_first->priority, high_first);
+    queue.Push(0x1000, high_second->priority, high_second);
+    queue.Push(0x2000, other_address->priority, other_address);
+    REQUIRE(queue.Size() == 4);
+    REQUIRE(queue.Count(0x1000) == 3);
+
+    SECTION("wakes up by priority, then in waiting order") {
+        REQUIRE(queue.PopHighestPriority(0x1000) == high_first);
+        REQUIRE(queue.PopHighestPriority(0x1000) == high_second);
+        REQUIRE(queue.PopHighestPriority(0x1000) == low);
+        REQUIRE(queue.PopHighestPriority(0x1000) == nullptr);
+        REQUIRE(queue.Size() == 1);
+        REQUIRE(queue.Contains(other_address.get()));
+    }
+
+    SECTION("removed waiters are not woken up") {
+        REQUIRE(queue.Remove(high_first.get()));
+        REQUIRE_FALSE(queue.Remove(high_first.get()));
+        REQUIRE(queue.PopHighestPriority(0x1000) == high_second);
+    }
+
+    SECTION("priority changes reorder the waiters") {
+        queue.ChangePriority(low.get(), 0x10);
+        REQUIRE(queue.PopHighestPriority(0x1000) == low);
+
+        // A waiter whose priority changes keeps its place among the waiters of that priority
+        queue.ChangePriority(high_first.get(), 0x20);
+        queue.ChangePriority(high_first.get(), 0x18);
+        REQUIRE(queue.PopHighestPriority(0x1000) == high_first);
+        REQUIRE(queue.PopHighestPriority(0x1000) == high_second);
+    }
+
+    SECTION("PopAll only returns the waiters of the address, in waiting order") {
+        queue.ChangePriority(high_second.get(), 0x08);
+        const auto waiters = queue.PopAll(0x1000);
+        REQUIRE(waiters == std::vector<std::shared_ptr<FakeThread>>{low, high_first, high_second});
+        REQUIRE(queue.Count(0x1000) == 0);
+        REQUIRE(queue.Size() == 1);
+    }
+}
+
+TEST_CASE("ArbitrationQueue stress test", "[core][kernel]") {
+    constexpr std::size_t NUM_THREADS = 4096;
+    constexpr VAddr NUM_ADDRESSES = 64;
+
+    std::mt19937 rng(0x3D5);
+    std::uniform_int_distribution<u32> priority_dist(0x18, 0x3F);
+    std::uniform_int_distribution<VAddr> address_dist(0, NUM_ADDRESSES - 1);
+
+    std::vector<FakeThread> threads(NUM_THREADS);
+    ArbitrationQueue<FakeThread*> queue;
+    for (u32 i = 0; i < NUM_THREADS; ++i) {
+        threads[i] = {i, priority_dist(rng), 0x10000000 + address_dist(rng) * 4};
+        queue.Push(threads[i].address, threads[i].priority, &threads[i]);
+    }
+    REQUIRE(queue.Size() == NUM_THREADS);
+
+    // Time out every third waiter and shuffle the priority of every fifth one
+    for (auto& thread : threads) {
+        if (thread.id % 3 == 0) {
+            REQUIRE(queue.Remove(&thread));
+        } else if (thread.id % 5 == 0) {
+            thread.priority = priority_dist(rng);
+            queue.ChangePriority(&thread, thread.priority);
+        }
+    }
+
+    // Signal the addresses one waiter at a time, waiters must come out in priority order, then in
+    // waiting order, and nothing that timed out may be woken up
+    std::size_t woken = 0;
+    for (VAddr i = 0; i < NUM_ADDRESSES; ++i) {
+        const VAddr address = 0x10000000 + i * 4;
+        const FakeThread* last = nullptr;
+        while (FakeThread* thread = queue.PopHighestPriority(address)) {
+            REQUIRE(thread->address == address);
+            REQUIRE(thread->id % 3 != 0);
+            if (last != nullptr) {
+                REQUIRE(thread->priority >= last->priority);
+                REQUIRE((thread->priority != last->priority || thread->id > last->id));
+            }
+            last = thread;
+            ++woken;
+        }
+    }
+    REQUIRE(woken == NUM_THREADS - (NUM_THREADS + 2) / 3);
+    REQUIRE(queue.Size() == 0);
+}
+
+} // namespace Kernel
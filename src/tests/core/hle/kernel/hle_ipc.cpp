@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <catch2/catch.hpp>
 #include "core/core_timing.h"
 #include "core/hle/ipc.h"
@@ -26,7 +27,7 @@ TEST_CASE("HLERequestContext::PopulateFromIncomingCommandBuffer", "[core][kernel
     HLERequestContext context(std::move(session));
 
     auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
-    HandleTable handle_table;
+    HandleTable handle_table(kernel);
 
     SECTION("works with empty cmdbuf") {
         const u32_le input[]{
@@ -236,7 +237,7 @@ TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
     HLERequestContext context(std::move(session));
 
     auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
-    HandleTable handle_table;
+    HandleTable handle_table(kernel);
     auto* input = context.CommandBuffer();
     u32_le output[IPC::COMMAND_BUFFER_LENGTH];
 
@@ -372,4 +373,134 @@ TEST_CASE("HLERequestContext::WriteToOutgoingCommandBuffer", "[core][kernel]") {
     CoreTiming::Shutdown();
 }
 
+TEST_CASE("HLERequestContext::Reset", "[core][kernel]") {
+    CoreTiming::Init();
+    Kernel::KernelSystem kernel(0);
+    auto session = std::get<SharedPtr<ServerSession>>(kernel.CreateSessionPair());
+    HLERequestContext context(session);
+
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    HandleTable handle_table(kernel);
+
+    auto buffer = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+    std::fill(buffer->begin(), buffer->end(), 0xAB);
+
+    VAddr target_address = 0x10000000;
+    auto result = process->vm_manager.MapMemoryBlock(target_address, buffer, 0, buffer->size(),
+                                                     MemoryState::Private);
+    REQUIRE(result.Code() == RESULT_SUCCESS);
+
+    const u32_le first_input[]{
+        IPC::MakeHeader(0x1234, 0, 4),
+        IPC::MoveHandleDesc(1),
+        handle_table.Create(MakeObject(kernel)).Unwrap(),
+        IPC::StaticBufferDesc(buffer->size(), 0),
+        target_address,
+    };
+    context.PopulateFromIncomingCommandBuffer(first_input, *process, handle_table);
+    REQUIRE(context.GetStaticBuffer(0).size() == buffer->size());
+
+    SECTION("binds the new session and clears the command buffer") {
+        auto other_session = std::get<SharedPtr<ServerSession>>(kernel.CreateSessionPair());
+        context.Reset(other_session);
+
+        CHECK(context.Session() == other_session);
+        CHECK(context.CommandBuffer()[0] == 0);
+        CHECK(context.GetStaticBuffer(0).empty());
+    }
+
+    SECTION("translates a smaller request after reuse") {
+        context.Reset(session);
+
+        std::fill(buffer->begin(), buffer->end(), 0xCD);
+        const u32_le second_input[]{
+            IPC::MakeHeader(0x5678, 0, 4),
+            IPC::MoveHandleDesc(1),
+            handle_table.Create(MakeObject(kernel)).Unwrap(),
+            IPC::StaticBufferDesc(0x10, 0),
+            target_address,
+        };
+        context.PopulateFromIncomingCommandBuffer(second_input, *process, handle_table);
+
+        // Handle ids start from zero again since the previous handles were discarded.
+        CHECK(context.CommandBuffer()[2] == 0);
+        CHECK(context.GetStaticBuffer(0) == std::vector<u8>(0x10, 0xCD));
+    }
+
+    SECTION("writes a reply static buffer into the storage of a previous request") {
+        const u8* const storage = context.GetStaticBuffer(0).data();
+        context.Reset(session);
+
+        CHECK(context.AddStaticBuffer(0, 0x10) == storage);
+        CHECK(context.GetStaticBuffer(0) == std::vector<u8>(0x10, 0));
+    }
+
+    REQUIRE(process->vm_manager.UnmapRange(target_address, buffer->size()) == RESULT_SUCCESS);
+
+    CoreTiming::Shutdown();
+}
+
+TEST_CASE("HLERequestContext dispatch benchmark", "[.][benchmark][core][kernel]") {
+    constexpr int NUM_REQUESTS = 200000;
+
+    CoreTiming::Init();
+    Kernel::KernelSystem kernel(0);
+    auto session = std::get<SharedPtr<ServerSession>>(kernel.CreateSessionPair());
+
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    HandleTable handle_table(kernel);
+
+    auto buffer = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+    VAddr target_address = 0x10000000;
+    auto result = process->vm_manager.MapMemoryBlock(target_address, buffer, 0, buffer->size(),
+                                                     MemoryState::Private);
+    REQUIRE(result.Code() == RESULT_SUCCESS);
+
+    // A typical request: one parameter, a copied handle and a small static buffer
+    const u32_le input[]{
+        IPC::MakeHeader(0x1234, 1, 4),
+        0x12345678,
+        IPC::CopyHandleDesc(1),
+        handle_table.Create(MakeObject(kernel)).Unwrap(),
+        IPC::StaticBufferDesc(0x100, 0),
+        target_address,
+    };
+    u32_le output[IPC::COMMAND_BUFFER_LENGTH];
+
+    const auto handle_request = [&](HLERequestContext& context) {
+        context.PopulateFromIncomingCommandBuffer(input, *process, handle_table);
+        u32_le* cmd_buf = context.CommandBuffer();
+        cmd_buf[0] = IPC::MakeHeader(0x1234, 2, 0);
+        cmd_buf[1] = RESULT_SUCCESS.raw;
+        cmd_buf[2] = 0x87654321;
+        context.WriteToOutgoingCommandBuffer(output, *process, handle_table);
+    };
+
+    const auto measure = [](const char* name, auto&& dispatch) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_REQUESTS; ++i) {
+            dispatch();
+        }
+        const std::chrono::duration<double, std::nano> time =
+            std::chrono::steady_clock::now() - start;
+        WARN(name << ": " << time.count() / NUM_REQUESTS << " ns per request");
+    };
+
+    measure("New context per request", [&] {
+        HLERequestContext context(session);
+        handle_request(context);
+    });
+
+    HLERequestContext context(nullptr);
+    measure("Reused context", [&] {
+        context.Reset(session);
+        handle_request(context);
+        context.Reset(nullptr);
+    });
+
+    REQUIRE(process->vm_manager.UnmapRange(target_address, buffer->size()) == RESULT_SUCCESS);
+
+    CoreTiming::Shutdown();
+}
+
 } // namespace Kernel
@@ -0,0 +1,61 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/hle/kernel/idle_loop_detector.h"
+
+namespace Kernel {
+
+namespace {
+constexpr u32 WaitSynchronization1 = 0x24;
+constexpr u32 GetSystemTick = 0x28;
+constexpr VAddr POLL_PC = 0x00100020;
+} // Anonymous namespace
+
+TEST_CASE("IdleLoopDetector", "[core][kernel]") {
+    IdleLoopDetector detector;
+    // Any non-null thread will do, the detector only compares them
+    const Thread* const thread = reinterpret_cast<const Thread*>(0x1000);
+    const Thread* const other_thread = reinterpret_cast<const Thread*>(0x2000);
+    u64 ticks = 0;
+
+    // Issues a zero-timeout wait that times out, a few ticks after the previous one
+    const auto poll = [&](const Thread* polling_thread, VAddr pc, u64 elapsed_ticks) {
+        ticks += elapsed_ticks;
+        detector.OnSVC(WaitSynchronization1);
+        return detector.OnFruitlessPoll(polling_thread, pc, ticks);
+    };
+
+    SECTION("a thread polling in a tight loop is idle") {
+        for (u32 i = 1; i < IdleLoopDetector::POLL_THRESHOLD; ++i) {
+            REQUIRE_FALSE(poll(thread, POLL_PC, 20));
+        }
+        REQUIRE(poll(thread, POLL_PC, 20));
+    }
+
+    SECTION("a busy thread calling GetSystemTick is not fast-forwarded") {
+        // A timing loop polling an object and reading the tick counter while it works
+        for (u32 i = 0; i < 4 * IdleLoopDetector::POLL_THRESHOLD; ++i) {
+            REQUIRE_FALSE(poll(thread, POLL_PC, 20));
+            detector.OnSVC(GetSystemTick);
+        }
+    }
+
+    SECTION("polls with work in between are not an idle loop") {
+        for (u32 i = 0; i < 4 * IdleLoopDetector::POLL_THRESHOLD; ++i) {
+            REQUIRE_FALSE(poll(thread, POLL_PC, IdleLoopDetector::MAX_POLL_INTERVAL + 1));
+        }
+    }
+
+    SECTION("polls from different places or threads are not an idle loop") {
+        for (u32 i = 0; i < 4 * IdleLoopDetector::POLL_THRESHOLD; ++i) {
+            REQUIRE_FALSE(poll(thread, POLL_PC + (i % 2) * 4, 20));
+        }
+        for (u32 i = 0; i < 4 * IdleLoopDetector::POLL_THRESHOLD; ++i) {
+            REQUIRE_FALSE(poll(i % 2 ? thread : other_thread, POLL_PC, 20));
+        }
+    }
+}
+
+} // namespace Kernel
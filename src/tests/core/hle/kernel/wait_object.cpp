@@ -0,0 +1,134 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/arm/dyncom/arm_dyncom.h"
+#include "core/core_timing.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/semaphore.h"
+#include "core/hle/kernel/thread.h"
+#include "core/memory.h"
+
+namespace Kernel {
+
+namespace {
+
+constexpr VAddr CODE_ADDRESS = 0x00100000;
+
+/// A kernel with a process to create threads in, running on an interpreter core
+struct TestKernel {
+    TestKernel() : cpu(USER32MODE), old_page_table(Memory::GetCurrentPageTable()) {
+        CoreTiming::Init();
+        kernel = std::make_unique<KernelSystem>(0);
+        kernel->GetThreadManager().SetCPU(cpu);
+
+        process = kernel->CreateProcess(kernel->CreateCodeSet("", 0));
+        auto code = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+        REQUIRE(process->vm_manager
+                    .MapMemoryBlock(CODE_ADDRESS, code, 0, code->size(), MemoryState::Code)
+                    .Succeeded());
+    }
+
+    ~TestKernel() {
+        process = nullptr;
+        kernel.reset();
+        CoreTiming::Shutdown();
+        // Switching to the threads installed the page table of the process
+        Memory::SetCurrentPageTable(old_page_table);
+    }
+
+    SharedPtr<Thread> CreateThread(u32 priority) {
+        return kernel->CreateThread("", CODE_ADDRESS, priority, 0, ThreadProcessorId0, 0, process)
+            .Unwrap();
+    }
+
+    /**
+     * Schedules the given number of ready threads in turn, and makes each of them wait on the
+     * object, as WaitSynchronization1 does.
+     */
+    void WaitReadyThreads(std::size_t count, const SharedPtr<WaitObject>& object) {
+        ThreadManager& thread_manager = kernel->GetThreadManager();
+        for (std::size_t i = 0; i < count; ++i) {
+            thread_manager.Reschedule();
+            Thread* thread = thread_manager.GetCurrentThread();
+            thread->status = ThreadStatus::WaitSynchAny;
+            thread->wait_objects = {object};
+            object->AddWaitingThread(thread);
+        }
+    }
+
+    ARM_DynCom cpu;
+    Memory::PageTable* old_page_table;
+    std::unique_ptr<KernelSystem> kernel;
+    SharedPtr<Process> process;
+};
+
+} // Anonymous namespace
+
+TEST_CASE("WaitObject::WakeupAllWaitingThreads", "[core][kernel]") {
+    TestKernel test;
+    auto semaphore = test.kernel->CreateSemaphore(0, 4).Unwrap();
+
+    // The threads start waiting in priority order: highest, first_mid, second_mid, lowest
+    auto lowest = test.CreateThread(0x28);
+    auto first_mid = test.CreateThread(0x1E);
+    auto second_mid = test.CreateThread(0x1E);
+    auto highest = test.CreateThread(0x14);
+    test.WaitReadyThreads(4, semaphore);
+    REQUIRE(semaphore->GetWaitingThreads().size() == 4);
+
+    // Only the slots that are released are handed out, to the best waiters, first come first
+    // served among the ones of the same priority
+    semaphore->Release(2);
+    CHECK(highest->status == ThreadStatus::Ready);
+    CHECK(first_mid->status == ThreadStatus::Ready);
+    CHECK(second_mid->status == ThreadStatus::WaitSynchAny);
+    CHECK(lowest->status == ThreadStatus::WaitSynchAny);
+    CHECK(semaphore->available_count == 0);
+
+    semaphore->Release(1);
+    CHECK(second_mid->status == ThreadStatus::Ready);
+    CHECK(lowest->status == ThreadStatus::WaitSynchAny);
+    CHECK(semaphore->GetWaitingThreads().size() == 1);
+
+    // The last waiter is woken up on its own
+    semaphore->Release(1);
+    CHECK(lowest->status == ThreadStatus::Ready);
+    CHECK(semaphore->GetWaitingThreads().empty());
+    CHECK(semaphore->available_count == 0);
+}
+
+TEST_CASE("WaitObject::WakeupAllWaitingThreads benchmark", "[.][benchmark][core][kernel]") {
+    constexpr int NUM_ROUNDS = 1000;
+
+    for (const std::size_t num_waiters : {1, 16, 256}) {
+        TestKernel test;
+        auto event = test.kernel->CreateEvent(ResetType::Sticky);
+        std::vector<SharedPtr<Thread>> threads;
+        for (std::size_t i = 0; i < num_waiters; ++i) {
+            threads.push_back(test.CreateThread(ThreadPrioUserlandMax + i % 8));
+        }
+
+        std::chrono::nanoseconds time{};
+        for (int round = 0; round < NUM_ROUNDS; ++round) {
+            event->Clear();
+            test.WaitReadyThreads(num_waiters, event);
+
+            const auto start = std::chrono::steady_clock::now();
+            event->Signal();
+            time += std::chrono::steady_clock::now() - start;
+        }
+        REQUIRE(event->GetWaitingThreads().empty());
+
+        const std::chrono::duration<double, std::micro> per_signal = time / NUM_ROUNDS;
+        WARN(num_waiters << " waiters: " << per_signal.count() << " us per signal");
+    }
+}
+
+} // namespace Kernel
@@ -0,0 +1,82 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "core/hle/service/am/content_decryptor.h"
+
+namespace Service::AM {
+
+constexpr std::size_t BLOCK_SIZE = CryptoPP::AES::BLOCKSIZE;
+
+TEST_CASE("ContentDecryptor matches serial CBC decryption", "[core][service][am]") {
+    std::mt19937 rng(42);
+    const auto random_block = [&rng] {
+        std::array<u8, 16> block;
+        std::generate(block.begin(), block.end(), [&rng] { return static_cast<u8>(rng()); });
+        return block;
+    };
+    const std::array<u8, 16> key = random_block();
+    const std::vector<std::array<u8, 16>> ivs{random_block(), random_block()};
+
+    // The contents are written in chunks of these sizes, alternating between the two contents.
+    // Most are split into parts whose number does not divide their block count.
+    constexpr std::size_t MIN_PART_SIZE = ContentDecryptor::MIN_PART_SIZE;
+    const std::vector<std::size_t> chunk_sizes{
+        4 * MIN_PART_SIZE + 7 * BLOCK_SIZE, 3 * MIN_PART_SIZE - 5 * BLOCK_SIZE,
+        MIN_PART_SIZE / 2 + BLOCK_SIZE,     4 * MIN_PART_SIZE,
+        2 * MIN_PART_SIZE + 3 * BLOCK_SIZE, 5 * MIN_PART_SIZE + 11 * BLOCK_SIZE,
+    };
+
+    std::array<std::vector<u8>, 2> plaintexts;
+    std::array<std::vector<u8>, 2> ciphertexts;
+    for (std::size_t i = 0; i < chunk_sizes.size(); ++i) {
+        std::vector<u8>& plaintext = plaintexts[i % 2];
+        plaintext.resize(plaintext.size() + chunk_sizes[i]);
+    }
+    for (std::size_t content = 0; content < 2; ++content) {
+        std::vector<u8>& plaintext = plaintexts[content];
+        std::generate(plaintext.begin(), plaintext.end(),
+                      [&rng] { return static_cast<u8>(rng()); });
+        ciphertexts[content].resize(plaintext.size());
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption(key.data(), key.size(), ivs[content].data())
+            .ProcessData(ciphertexts[content].data(), plaintext.data(), plaintext.size());
+    }
+
+    // Serial decryption of each content in one go, as a reference
+    std::array<std::vector<u8>, 2> expected;
+    for (std::size_t content = 0; content < 2; ++content) {
+        expected[content].resize(ciphertexts[content].size());
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption(key.data(), key.size(), ivs[content].data())
+            .ProcessData(expected[content].data(), ciphertexts[content].data(),
+                         ciphertexts[content].size());
+        REQUIRE(std::equal(expected[content].begin(), expected[content].end(),
+                           plaintexts[content].begin(), plaintexts[content].end()));
+    }
+
+    // Several threads regardless of the host, so that the chunks are split
+    ContentDecryptor decryptor(4);
+    decryptor.SetKeys(key, ivs);
+    std::array<std::vector<u8>, 2> decrypted;
+    for (std::size_t i = 0; i < chunk_sizes.size(); ++i) {
+        const std::size_t content = i % 2;
+        const std::size_t offset = decrypted[content].size();
+        std::vector<u8> chunk(ciphertexts[content].begin() + offset,
+                              ciphertexts[content].begin() + offset + chunk_sizes[i]);
+        decryptor.Decrypt(content, chunk.data(), chunk.size());
+        decrypted[content].insert(decrypted[content].end(), chunk.begin(), chunk.end());
+    }
+
+    for (std::size_t content = 0; content < 2; ++content) {
+        REQUIRE(std::equal(decrypted[content].begin(), decrypted[content].end(),
+                           expected[content].begin(), expected[content].end()));
+    }
+}
+
+} // namespace Service::AM
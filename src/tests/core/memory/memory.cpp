@@ -54,3 +54,36 @@ TEST_CASE("Memory::IsValidVirtualAddress", "[core][memory]") {
 
     CoreTiming::Shutdown();
 }
+
+TEST_CASE("Memory::GetContiguousPointer", "[core][memory]") {
+    CoreTiming::Init();
+    Kernel::KernelSystem kernel(0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+
+    auto block = std::make_shared<std::vector<u8>>(2 * Memory::PAGE_SIZE);
+    const VAddr address = 0x10000000;
+    REQUIRE(process->vm_manager
+                .MapMemoryBlock(address, block, 0, block->size(), Kernel::MemoryState::Private)
+                .Code() == RESULT_SUCCESS);
+
+    SECTION("a range inside a single block resolves to the block") {
+        CHECK(Memory::GetContiguousPointer(*process, address, block->size()) == block->data());
+        CHECK(Memory::GetContiguousPointer(*process, address + 0x10, Memory::PAGE_SIZE) ==
+              block->data() + 0x10);
+    }
+
+    SECTION("a range reaching unmapped memory is not contiguous") {
+        CHECK(Memory::GetContiguousPointer(*process, address, block->size() + 1) == nullptr);
+    }
+
+    SECTION("a range spanning two separate blocks is not contiguous") {
+        auto other_block = std::make_shared<std::vector<u8>>(Memory::PAGE_SIZE);
+        REQUIRE(process->vm_manager
+                    .MapMemoryBlock(address + static_cast<VAddr>(block->size()), other_block, 0,
+                                    other_block->size(), Kernel::MemoryState::Private)
+                    .Code() == RESULT_SUCCESS);
+        CHECK(Memory::GetContiguousPointer(*process, address, block->size() + 1) == nullptr);
+    }
+
+    CoreTiming::Shutdown();
+}